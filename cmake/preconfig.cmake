@@ -5,4 +5,8 @@ endif()
 
 if(NOT TARGET ez::math)
 	find_dependency(ez-math CONFIG)
+endif()
+
+if(NOT TARGET Threads::Threads)
+	find_dependency(Threads)
 endif()
\ No newline at end of file
@@ -0,0 +1,623 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "SoA.hpp"
+#include "Intersect.hpp"
+
+// Batch overlap tests over structure of arrays sets.
+// The kernels evaluate a block of elements into a mask without branching, then compact the passing indices into the output.
+// This keeps the hot loops free of data dependent branches so they vectorize, no intrinsics are required.
+// Results match the scalar intersect overloads in Intersect.hpp.
+
+namespace ez {
+	struct IndexPair {
+		std::uint32_t first, second;
+	};
+
+	namespace intern {
+		// Number of elements evaluated into a mask before compaction.
+		static constexpr std::size_t BatchBlock = 64;
+		// Number of elements of the second set kept hot in cache by the tiled many vs many tests.
+		static constexpr std::size_t BatchTile = 512;
+
+		template<typename T, int N>
+		struct RectKernel {
+			bool operator()(std::size_t j) const noexcept {
+				bool hit = true;
+				for (int k = 0; k < N; ++k) {
+					hit &= (qmin[k] < max[k][j]) & (min[k][j] < qmax[k]);
+				}
+				return hit;
+			}
+
+			glm::vec<N, T> qmin, qmax;
+			const T* min[N];
+			const T* max[N];
+		};
+
+		template<typename T, int N>
+		struct BallKernel {
+			bool operator()(std::size_t j) const noexcept {
+				T d2 = T(0);
+				for (int k = 0; k < N; ++k) {
+					T d = origin[k][j] - qorigin[k];
+					d2 += d * d;
+				}
+				T r = qradius + radius[j];
+				return d2 <= r * r;
+			}
+
+			glm::vec<N, T> qorigin;
+			T qradius;
+			const T* origin[N];
+			const T* radius;
+		};
+
+		// Query ball against a set of rects.
+		template<typename T, int N>
+		struct BallRectKernel {
+			bool operator()(std::size_t j) const noexcept {
+				T d2 = T(0);
+				for (int k = 0; k < N; ++k) {
+					T d = qorigin[k] - std::min(std::max(qorigin[k], min[k][j]), max[k][j]);
+					d2 += d * d;
+				}
+				return d2 <= qradius * qradius;
+			}
+
+			glm::vec<N, T> qorigin;
+			T qradius;
+			const T* min[N];
+			const T* max[N];
+		};
+
+		// Query rect against a set of balls.
+		template<typename T, int N>
+		struct RectBallKernel {
+			bool operator()(std::size_t j) const noexcept {
+				T d2 = T(0);
+				for (int k = 0; k < N; ++k) {
+					T o = origin[k][j];
+					T d = o - std::min(std::max(o, qmin[k]), qmax[k]);
+					d2 += d * d;
+				}
+				return d2 <= radius[j] * radius[j];
+			}
+
+			glm::vec<N, T> qmin, qmax;
+			const T* origin[N];
+			const T* radius;
+		};
+
+		template<typename T, int N>
+		struct OBBKernel {
+			bool operator()(std::size_t j) const noexcept {
+				T d[N], R[N][N], t[N], eb[N];
+				for (int k = 0; k < N; ++k) {
+					d[k] = origin[k][j] - qorigin[k];
+					eb[k] = half[k][j];
+				}
+				for (int a = 0; a < N; ++a) {
+					t[a] = T(0);
+					for (int k = 0; k < N; ++k) {
+						t[a] += d[k] * qaxes[a][k];
+					}
+					for (int b = 0; b < N; ++b) {
+						R[a][b] = T(0);
+						for (int k = 0; k < N; ++k) {
+							R[a][b] += qaxes[a][k] * axes[b][k][j];
+						}
+					}
+				}
+				return sat_overlap<T, N>(R, t, qhalf, eb);
+			}
+
+			T qorigin[N], qhalf[N], qaxes[N][N];
+			const T* origin[N];
+			const T* half[N];
+			// Component k of local axis a
+			const T* axes[N][N];
+		};
+
+		// Ray moved into the frame of each box, then slab tested against the half extents.
+		template<typename T, int N>
+		struct RayOBBKernel {
+			bool operator()(std::size_t j) const noexcept {
+				T tmin = -std::numeric_limits<T>::max(), tmax = std::numeric_limits<T>::max();
+				for (int a = 0; a < N; ++a) {
+					T o = T(0), dir = T(0);
+					for (int k = 0; k < N; ++k) {
+						T axis = axes[a][k][j];
+						o += (rorigin[k] - origin[k][j]) * axis;
+						dir += raxis[k] * axis;
+					}
+					T inverseAxis = T(1) / dir;
+					T h = half[a][j];
+					T t1 = (-h - o) * inverseAxis;
+					T t2 = (h - o) * inverseAxis;
+					tmin = std::max(tmin, std::min(t1, t2));
+					tmax = std::min(tmax, std::max(t1, t2));
+				}
+				return tmax > std::max(tmin, T(0));
+			}
+
+			T rorigin[N], raxis[N];
+			const T* origin[N];
+			const T* half[N];
+			const T* axes[N][N];
+		};
+
+		// Query capsule against a set of capsules.
+		template<typename T>
+		struct CapsuleKernel {
+			bool operator()(std::size_t j) const noexcept {
+				glm::tvec3<T> a{ start[0][j], start[1][j], start[2][j] };
+				glm::tvec3<T> b{ end[0][j], end[1][j], end[2][j] };
+				T s, t;
+				T r = qradius + radius[j];
+				return closest_segments(qstart, qend, a, b, s, t) <= r * r;
+			}
+
+			glm::tvec3<T> qstart, qend;
+			T qradius;
+			const T* start[3];
+			const T* end[3];
+			const T* radius;
+		};
+
+		// Query capsule against a set of spheres.
+		template<typename T>
+		struct CapsuleBallKernel {
+			bool operator()(std::size_t j) const noexcept {
+				glm::tvec3<T> p{ origin[0][j], origin[1][j], origin[2][j] };
+				T s;
+				T r = qradius + radius[j];
+				return closest_segment_point(qstart, qend, p, s) <= r * r;
+			}
+
+			glm::tvec3<T> qstart, qend;
+			T qradius;
+			const T* origin[3];
+			const T* radius;
+		};
+
+		// Query sphere against a set of capsules.
+		template<typename T>
+		struct BallCapsuleKernel {
+			bool operator()(std::size_t j) const noexcept {
+				glm::tvec3<T> a{ start[0][j], start[1][j], start[2][j] };
+				glm::tvec3<T> b{ end[0][j], end[1][j], end[2][j] };
+				T s;
+				T r = qradius + radius[j];
+				return closest_segment_point(a, b, qorigin, s) <= r * r;
+			}
+
+			glm::tvec3<T> qorigin;
+			T qradius;
+			const T* start[3];
+			const T* end[3];
+			const T* radius;
+		};
+
+		// Query capsule against a set of rects.
+		template<typename T>
+		struct CapsuleRectKernel {
+			bool operator()(std::size_t j) const noexcept {
+				glm::tvec3<T> lo{ min[0][j], min[1][j], min[2][j] };
+				glm::tvec3<T> hi{ max[0][j], max[1][j], max[2][j] };
+				return segment_box_distance2(qstart, qend, lo, hi) <= qradius * qradius;
+			}
+
+			glm::tvec3<T> qstart, qend;
+			T qradius;
+			const T* min[3];
+			const T* max[3];
+		};
+
+		template<typename T>
+		struct RayCapsuleKernel {
+			bool operator()(std::size_t j) const noexcept {
+				glm::tvec3<T> a{ start[0][j], start[1][j], start[2][j] };
+				glm::tvec3<T> b{ end[0][j], end[1][j], end[2][j] };
+				T t;
+				return ray_capsule(rorigin, raxis, a, b, radius[j], t);
+			}
+
+			glm::tvec3<T> rorigin, raxis;
+			const T* start[3];
+			const T* end[3];
+			const T* radius;
+		};
+
+		template<typename T, int N>
+		RectKernel<T, N> kernel(const MMRect<T, N>& query, const MMRectSoA<T, N>& set) noexcept {
+			RectKernel<T, N> k;
+			k.qmin = query.min;
+			k.qmax = query.max;
+			for (int i = 0; i < N; ++i) {
+				k.min[i] = set.min.data(i);
+				k.max[i] = set.max.data(i);
+			}
+			return k;
+		}
+
+		template<typename T, int N>
+		BallKernel<T, N> kernel(const glm::vec<N, T>& origin, T radius, const BallSoA<T, N>& set) noexcept {
+			BallKernel<T, N> k;
+			k.qorigin = origin;
+			k.qradius = radius;
+			for (int i = 0; i < N; ++i) {
+				k.origin[i] = set.origin.data(i);
+			}
+			k.radius = set.radius.data();
+			return k;
+		}
+		template<typename T>
+		BallKernel<T, 2> kernel(const Circle<T>& query, const BallSoA<T, 2>& set) noexcept {
+			return kernel(query.origin, query.radius, set);
+		}
+		template<typename T>
+		BallKernel<T, 3> kernel(const Sphere<T>& query, const BallSoA<T, 3>& set) noexcept {
+			return kernel(query.origin, query.radius, set);
+		}
+
+		template<typename T, int N>
+		BallRectKernel<T, N> kernel(const glm::vec<N, T>& origin, T radius, const MMRectSoA<T, N>& set) noexcept {
+			BallRectKernel<T, N> k;
+			k.qorigin = origin;
+			k.qradius = radius;
+			for (int i = 0; i < N; ++i) {
+				k.min[i] = set.min.data(i);
+				k.max[i] = set.max.data(i);
+			}
+			return k;
+		}
+		template<typename T>
+		BallRectKernel<T, 2> kernel(const Circle<T>& query, const MMRectSoA<T, 2>& set) noexcept {
+			return kernel(query.origin, query.radius, set);
+		}
+		template<typename T>
+		BallRectKernel<T, 3> kernel(const Sphere<T>& query, const MMRectSoA<T, 3>& set) noexcept {
+			return kernel(query.origin, query.radius, set);
+		}
+
+		template<typename T, int N>
+		RectBallKernel<T, N> kernel(const MMRect<T, N>& query, const BallSoA<T, N>& set) noexcept {
+			RectBallKernel<T, N> k;
+			k.qmin = query.min;
+			k.qmax = query.max;
+			for (int i = 0; i < N; ++i) {
+				k.origin[i] = set.origin.data(i);
+			}
+			k.radius = set.radius.data();
+			return k;
+		}
+
+		template<typename T, int N>
+		void bind(const OBBSoA<T, N>& set, const T* (&origin)[N], const T* (&half)[N], const T* (&axes)[N][N]) noexcept {
+			for (int a = 0; a < N; ++a) {
+				origin[a] = set.origin.data(a);
+				half[a] = set.half.data(a);
+				for (int k = 0; k < N; ++k) {
+					axes[a][k] = set.axes[a].data(k);
+				}
+			}
+		}
+
+		template<typename T, int N>
+		OBBKernel<T, N> kernel(const OBB<T, N>& query, const OBBSoA<T, N>& set) noexcept {
+			OBBKernel<T, N> k;
+			for (int a = 0; a < N; ++a) {
+				k.qorigin[a] = query.origin[a];
+				k.qhalf[a] = query.half[a];
+				for (int c = 0; c < N; ++c) {
+					k.qaxes[a][c] = query.axes[a][c];
+				}
+			}
+			bind(set, k.origin, k.half, k.axes);
+			return k;
+		}
+
+		template<typename T, int N>
+		RayOBBKernel<T, N> kernel(const Ray<T, N>& query, const OBBSoA<T, N>& set) noexcept {
+			RayOBBKernel<T, N> k;
+			for (int a = 0; a < N; ++a) {
+				k.rorigin[a] = query.origin[a];
+				k.raxis[a] = query.axis[a];
+			}
+			bind(set, k.origin, k.half, k.axes);
+			return k;
+		}
+
+		template<typename T>
+		void bind(const CapsuleSoA<T>& set, const T* (&start)[3], const T* (&end)[3], const T*& radius) noexcept {
+			for (int k = 0; k < 3; ++k) {
+				start[k] = set.start.data(k);
+				end[k] = set.end.data(k);
+			}
+			radius = set.radius.data();
+		}
+
+		template<typename T>
+		CapsuleKernel<T> kernel(const Capsule<T>& query, const CapsuleSoA<T>& set) noexcept {
+			CapsuleKernel<T> k;
+			k.qstart = query.segment.start;
+			k.qend = query.segment.end;
+			k.qradius = query.radius;
+			bind(set, k.start, k.end, k.radius);
+			return k;
+		}
+
+		template<typename T>
+		CapsuleBallKernel<T> kernel(const Capsule<T>& query, const BallSoA<T, 3>& set) noexcept {
+			CapsuleBallKernel<T> k;
+			k.qstart = query.segment.start;
+			k.qend = query.segment.end;
+			k.qradius = query.radius;
+			for (int i = 0; i < 3; ++i) {
+				k.origin[i] = set.origin.data(i);
+			}
+			k.radius = set.radius.data();
+			return k;
+		}
+
+		template<typename T>
+		BallCapsuleKernel<T> kernel(const Sphere<T>& query, const CapsuleSoA<T>& set) noexcept {
+			BallCapsuleKernel<T> k;
+			k.qorigin = query.origin;
+			k.qradius = query.radius;
+			bind(set, k.start, k.end, k.radius);
+			return k;
+		}
+
+		template<typename T>
+		CapsuleRectKernel<T> kernel(const Capsule<T>& query, const MMRectSoA<T, 3>& set) noexcept {
+			CapsuleRectKernel<T> k;
+			k.qstart = query.segment.start;
+			k.qend = query.segment.end;
+			k.qradius = query.radius;
+			for (int i = 0; i < 3; ++i) {
+				k.min[i] = set.min.data(i);
+				k.max[i] = set.max.data(i);
+			}
+			return k;
+		}
+
+		template<typename T>
+		RayCapsuleKernel<T> kernel(const Ray3<T>& query, const CapsuleSoA<T>& set) noexcept {
+			RayCapsuleKernel<T> k;
+			k.rorigin = query.origin;
+			k.raxis = query.axis;
+			bind(set, k.start, k.end, k.radius);
+			return k;
+		}
+
+		// Append the indices in [begin, end) that pass the kernel, returns the number appended.
+		template<typename K>
+		std::size_t compact_indices(const K& kern, std::size_t begin, std::size_t end, std::vector<std::uint32_t>& out) {
+			std::size_t start = out.size();
+			out.resize(start + (end - begin));
+			std::uint32_t* dst = out.data() + start;
+			std::size_t count = 0;
+
+			std::uint8_t mask[BatchBlock];
+			for (std::size_t i = begin; i < end; i += BatchBlock) {
+				std::size_t n = std::min(BatchBlock, end - i);
+				for (std::size_t j = 0; j < n; ++j) {
+					mask[j] = kern(i + j);
+				}
+				for (std::size_t j = 0; j < n; ++j) {
+					dst[count] = static_cast<std::uint32_t>(i + j);
+					count += mask[j];
+				}
+			}
+
+			out.resize(start + count);
+			return count;
+		}
+
+		// Write the pairs (first, j) for j in [begin, end) that pass the kernel to dst, which must hold end - begin pairs.
+		// Returns the number written.
+		template<typename K>
+		std::size_t compact_pairs(const K& kern, std::uint32_t first, std::size_t begin, std::size_t end, IndexPair* dst) {
+			std::size_t count = 0;
+
+			std::uint8_t mask[BatchBlock];
+			for (std::size_t i = begin; i < end; i += BatchBlock) {
+				std::size_t n = std::min(BatchBlock, end - i);
+				for (std::size_t j = 0; j < n; ++j) {
+					mask[j] = kern(i + j);
+				}
+				for (std::size_t j = 0; j < n; ++j) {
+					dst[count] = IndexPair{ first, static_cast<std::uint32_t>(i + j) };
+					count += mask[j];
+				}
+			}
+			return count;
+		}
+
+		// Make room in out for count more pairs after the first written, growing geometrically so a tile rarely resizes.
+		inline IndexPair* reserve_pairs(std::vector<IndexPair>& out, std::size_t written, std::size_t count) {
+			if (out.size() < written + count) {
+				out.resize(std::max(written + count, out.size() * 2));
+			}
+			return out.data() + written;
+		}
+
+		template<typename A, typename B>
+		std::size_t tiled(const A& a, const B& b, std::vector<IndexPair>& out) {
+			std::size_t start = out.size(), written = start;
+			for (std::size_t ia = 0; ia < a.size(); ia += BatchBlock) {
+				std::size_t ea = std::min(a.size(), ia + BatchBlock);
+				for (std::size_t ib = 0; ib < b.size(); ib += BatchTile) {
+					std::size_t eb = std::min(b.size(), ib + BatchTile);
+					IndexPair* dst = reserve_pairs(out, written, (ea - ia) * (eb - ib));
+					for (std::size_t i = ia; i < ea; ++i) {
+						std::size_t count = compact_pairs(kernel(a.get(i), b), static_cast<std::uint32_t>(i), ib, eb, dst);
+						dst += count;
+						written += count;
+					}
+				}
+			}
+			out.resize(written);
+			return written - start;
+		}
+
+		// Same as tiled, but only emits pairs with first < second.
+		template<typename A>
+		std::size_t tiled_self(const A& a, std::vector<IndexPair>& out) {
+			std::size_t start = out.size(), written = start;
+			for (std::size_t ia = 0; ia < a.size(); ia += BatchBlock) {
+				std::size_t ea = std::min(a.size(), ia + BatchBlock);
+				for (std::size_t ib = ia; ib < a.size(); ib += BatchTile) {
+					std::size_t eb = std::min(a.size(), ib + BatchTile);
+					IndexPair* dst = reserve_pairs(out, written, (ea - ia) * (eb - ib));
+					for (std::size_t i = ia; i < ea; ++i) {
+						std::size_t first = std::max(ib, i + 1);
+						if (first < eb) {
+							std::size_t count = compact_pairs(kernel(a.get(i), a), static_cast<std::uint32_t>(i), first, eb, dst);
+							dst += count;
+							written += count;
+						}
+					}
+				}
+			}
+			out.resize(written);
+			return written - start;
+		}
+
+		template<typename A, typename B>
+		std::size_t filter(const A& a, const B& b, const IndexPair* candidates, std::size_t count, std::vector<IndexPair>& out) {
+			std::size_t start = out.size();
+			out.resize(start + count);
+			IndexPair* dst = out.data() + start;
+			std::size_t passed = 0;
+
+			for (std::size_t i = 0; i < count; ++i) {
+				const IndexPair& pair = candidates[i];
+				dst[passed] = pair;
+				passed += kernel(a.get(pair.first), b)(pair.second);
+			}
+
+			out.resize(start + passed);
+			return passed;
+		}
+	}
+
+	// One vs many, appends the indices of the elements of the set that overlap the query. Returns the number of indices appended.
+	template<typename T, int N>
+	std::size_t intersect_batch(const MMRect<T, N>& query, const MMRectSoA<T, N>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Circle<T>& query, const CircleSoA<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Sphere<T>& query, const SphereSoA<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Circle<T>& query, const MMRectSoA2<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Sphere<T>& query, const MMRectSoA3<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T, int N>
+	std::size_t intersect_batch(const MMRect<T, N>& query, const BallSoA<T, N>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T, int N>
+	std::size_t intersect_batch(const OBB<T, N>& query, const OBBSoA<T, N>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T, int N>
+	std::size_t intersect_batch(const Ray<T, N>& query, const OBBSoA<T, N>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Capsule<T>& query, const CapsuleSoA<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Capsule<T>& query, const SphereSoA<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Sphere<T>& query, const CapsuleSoA<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Capsule<T>& query, const MMRectSoA3<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+	template<typename T>
+	std::size_t intersect_batch(const Ray3<T>& query, const CapsuleSoA<T>& set, std::vector<std::uint32_t>& hits) {
+		return intern::compact_indices(intern::kernel(query, set), 0, set.size(), hits);
+	}
+
+	// Many vs many, appends every overlapping pair (index into a, index into b). Returns the number of pairs appended.
+	// The second set is processed in tiles that stay resident in cache while the first set streams past them.
+	template<typename T, int N>
+	std::size_t intersect_tiled(const MMRectSoA<T, N>& a, const MMRectSoA<T, N>& b, std::vector<IndexPair>& pairs) {
+		return intern::tiled(a, b, pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_tiled(const BallSoA<T, N>& a, const BallSoA<T, N>& b, std::vector<IndexPair>& pairs) {
+		return intern::tiled(a, b, pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_tiled(const BallSoA<T, N>& a, const MMRectSoA<T, N>& b, std::vector<IndexPair>& pairs) {
+		return intern::tiled(a, b, pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_tiled(const MMRectSoA<T, N>& a, const BallSoA<T, N>& b, std::vector<IndexPair>& pairs) {
+		return intern::tiled(a, b, pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_tiled(const OBBSoA<T, N>& a, const OBBSoA<T, N>& b, std::vector<IndexPair>& pairs) {
+		return intern::tiled(a, b, pairs);
+	}
+
+	// All overlapping pairs within a single set, each pair is reported once with first < second.
+	template<typename T, int N>
+	std::size_t intersect_tiled(const MMRectSoA<T, N>& set, std::vector<IndexPair>& pairs) {
+		return intern::tiled_self(set, pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_tiled(const BallSoA<T, N>& set, std::vector<IndexPair>& pairs) {
+		return intern::tiled_self(set, pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_tiled(const OBBSoA<T, N>& set, std::vector<IndexPair>& pairs) {
+		return intern::tiled_self(set, pairs);
+	}
+
+	// Narrowphase filter for a broadphase candidate list, appends the candidates that actually overlap.
+	template<typename T, int N>
+	std::size_t intersect_pairs(const MMRectSoA<T, N>& a, const MMRectSoA<T, N>& b, const std::vector<IndexPair>& candidates, std::vector<IndexPair>& pairs) {
+		return intern::filter(a, b, candidates.data(), candidates.size(), pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_pairs(const BallSoA<T, N>& a, const BallSoA<T, N>& b, const std::vector<IndexPair>& candidates, std::vector<IndexPair>& pairs) {
+		return intern::filter(a, b, candidates.data(), candidates.size(), pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_pairs(const BallSoA<T, N>& a, const MMRectSoA<T, N>& b, const std::vector<IndexPair>& candidates, std::vector<IndexPair>& pairs) {
+		return intern::filter(a, b, candidates.data(), candidates.size(), pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_pairs(const MMRectSoA<T, N>& a, const BallSoA<T, N>& b, const std::vector<IndexPair>& candidates, std::vector<IndexPair>& pairs) {
+		return intern::filter(a, b, candidates.data(), candidates.size(), pairs);
+	}
+	template<typename T, int N>
+	std::size_t intersect_pairs(const OBBSoA<T, N>& a, const OBBSoA<T, N>& b, const std::vector<IndexPair>& candidates, std::vector<IndexPair>& pairs) {
+		return intern::filter(a, b, candidates.data(), candidates.size(), pairs);
+	}
+};
\ No newline at end of file
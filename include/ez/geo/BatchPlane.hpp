@@ -0,0 +1,238 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+
+#include "Plane.hpp"
+#include "SoA.hpp"
+#include "ThreadPool.hpp"
+
+/*
+Classification of large point sets against small sets of planes.
+
+A PlaneSet keeps up to 32 planes as the implicit form dot(normal, p) - d, with d = dot(normal, origin) computed once,
+so the signed distances match Plane::distanceFrom. A point is on the front of a plane when its distance is above the epsilon
+of the set, on the back when it is below minus the epsilon, and on the plane otherwise. The classification of a point against
+the whole set is a bitmask, bit i for plane i.
+
+The points are processed in blocks that stay in cache while every plane is tested against them, with one flat loop over the
+block per plane, so the points are read from memory once whatever the number of planes and the loops vectorize.
+Blocks are grouped in chunks run on an executor, see ThreadPool.hpp.
+*/
+
+namespace ez {
+	template<typename T, int N>
+	class PlaneSet {
+	public:
+		using plane_t = Plane<T, N>;
+		using vec_t = glm::vec<N, T>;
+		static constexpr std::size_t MaxPlanes = 32;
+
+		explicit PlaneSet(T _epsilon = T(0)) noexcept
+			: count(0)
+			, epsilon(_epsilon)
+		{}
+		// Only the first MaxPlanes planes are kept.
+		PlaneSet(const plane_t* planes, std::size_t _count, T _epsilon = T(0)) noexcept
+			: PlaneSet(_epsilon)
+		{
+			for (std::size_t i = 0; i < _count && push_back(planes[i]); ++i) {}
+		}
+
+		// Returns false when the set is full.
+		bool push_back(const plane_t& plane) noexcept {
+			if (count == MaxPlanes) {
+				return false;
+			}
+			for (int k = 0; k < N; ++k) {
+				normal[k][count] = plane.normal[k];
+			}
+			offset[count] = glm::dot(plane.normal, plane.origin);
+			++count;
+			return true;
+		}
+		void clear() noexcept {
+			count = 0;
+		}
+
+		std::size_t size() const noexcept {
+			return count;
+		}
+		bool empty() const noexcept {
+			return count == 0;
+		}
+		// The mask with a bit for every plane of the set.
+		std::uint32_t all() const noexcept {
+			return count == MaxPlanes ? ~std::uint32_t(0) : (std::uint32_t(1) << count) - 1;
+		}
+
+		T distanceFrom(std::size_t plane, const vec_t& p) const noexcept {
+			T dist = -offset[plane];
+			for (int k = 0; k < N; ++k) {
+				dist += normal[k][plane] * p[k];
+			}
+			return dist;
+		}
+
+		// Normals by axis, and the precomputed dot(normal, origin) of each plane.
+		T normal[N][MaxPlanes];
+		T offset[MaxPlanes];
+		std::size_t count;
+		T epsilon;
+	};
+
+	template<typename T>
+	using PlaneSet2 = PlaneSet<T, 2>;
+
+	template<typename T>
+	using PlaneSet3 = PlaneSet<T, 3>;
+
+	namespace intern {
+		// Points kept in cache while they are tested against every plane.
+		static constexpr std::size_t PlaneBlock = 256;
+		// Points per task.
+		static constexpr std::size_t PlaneChunk = std::size_t(1) << 16;
+
+		// Signed distances of the points begin to end from one plane of the set.
+		template<typename T, int N>
+		void plane_distances(const PlaneSet<T, N>& planes, std::size_t plane, const T* const axes[N], std::size_t begin, std::size_t end, T* out) noexcept {
+			T n[N];
+			for (int k = 0; k < N; ++k) {
+				n[k] = planes.normal[k][plane];
+			}
+			T d = planes.offset[plane];
+			for (std::size_t j = begin; j < end; ++j) {
+				T dist = -d;
+				for (int k = 0; k < N; ++k) {
+					dist += n[k] * axes[k][j];
+				}
+				out[j - begin] = dist;
+			}
+		}
+
+		template<typename T, int N>
+		void point_axes(const PointSoA<T, N>& points, const T* axes[N]) noexcept {
+			for (int k = 0; k < N; ++k) {
+				axes[k] = points.data(k);
+			}
+		}
+	}
+
+	// Classify every point against every plane of the set. The masks that are not null must hold one element per point.
+	template<typename T, int N, typename Exec>
+	void classify_batch(const PointSoA<T, N>& points, const PlaneSet<T, N>& planes, std::uint32_t* front, std::uint32_t* back, std::uint32_t* on, Exec&& exec) {
+		const T* axes[N];
+		intern::point_axes(points, axes);
+		std::uint32_t all = planes.all();
+		T eps = planes.epsilon;
+
+		parallel_for(exec, points.size(), intern::PlaneChunk, [&](std::size_t begin, std::size_t end) {
+			T dist[intern::PlaneBlock];
+			std::uint32_t f[intern::PlaneBlock], b[intern::PlaneBlock];
+			for (std::size_t i = begin; i < end; i += intern::PlaneBlock) {
+				std::size_t n = std::min(intern::PlaneBlock, end - i);
+				std::fill(f, f + n, std::uint32_t(0));
+				std::fill(b, b + n, std::uint32_t(0));
+				for (std::size_t p = 0; p < planes.size(); ++p) {
+					intern::plane_distances(planes, p, axes, i, i + n, dist);
+					std::uint32_t bit = std::uint32_t(1) << p;
+					for (std::size_t j = 0; j < n; ++j) {
+						f[j] |= (dist[j] > eps) ? bit : 0u;
+						b[j] |= (dist[j] < -eps) ? bit : 0u;
+					}
+				}
+				if (front) {
+					std::copy(f, f + n, front + i);
+				}
+				if (back) {
+					std::copy(b, b + n, back + i);
+				}
+				if (on) {
+					for (std::size_t j = 0; j < n; ++j) {
+						on[i + j] = all & ~(f[j] | b[j]);
+					}
+				}
+			}
+		});
+	}
+	template<typename T, int N>
+	void classify_batch(const PointSoA<T, N>& points, const PlaneSet<T, N>& planes, std::uint32_t* front, std::uint32_t* back, std::uint32_t* on) {
+		classify_batch(points, planes, front, back, on, default_pool());
+	}
+
+	// Signed distance of every point from every plane, plane major: the distance of point j from plane i is out[i * points.size() + j].
+	// Out must hold planes.size() * points.size() elements.
+	template<typename T, int N, typename Exec>
+	void distances_batch(const PointSoA<T, N>& points, const PlaneSet<T, N>& planes, T* out, Exec&& exec) {
+		const T* axes[N];
+		intern::point_axes(points, axes);
+		std::size_t count = points.size();
+
+		parallel_for(exec, count, intern::PlaneChunk, [&](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; i += intern::PlaneBlock) {
+				std::size_t n = std::min(intern::PlaneBlock, end - i);
+				for (std::size_t p = 0; p < planes.size(); ++p) {
+					intern::plane_distances(planes, p, axes, i, i + n, out + p * count + i);
+				}
+			}
+		});
+	}
+	template<typename T, int N>
+	void distances_batch(const PointSoA<T, N>& points, const PlaneSet<T, N>& planes, T* out) {
+		distances_batch(points, planes, out, default_pool());
+	}
+
+	// Fill indices with the points inside the convex region bounded by the planes, in increasing order. Returns their number.
+	// The normals point out of the region, a point is inside when it is behind or on every plane.
+	template<typename T, int N, typename Exec>
+	std::size_t inside_batch(const PointSoA<T, N>& points, const PlaneSet<T, N>& planes, std::vector<std::uint32_t>& indices, Exec&& exec) {
+		const T* axes[N];
+		intern::point_axes(points, axes);
+		std::size_t count = points.size();
+		T eps = planes.epsilon;
+
+		// Every chunk compacts its points in place at its own offset, then the chunks are packed together.
+		indices.resize(count);
+		std::size_t chunks = (count + intern::PlaneChunk - 1) / intern::PlaneChunk;
+		std::vector<std::size_t> kept(chunks);
+
+		parallel_for(exec, count, intern::PlaneChunk, [&](std::size_t begin, std::size_t end) {
+			T dist[intern::PlaneBlock];
+			std::uint8_t inside[intern::PlaneBlock];
+			std::uint32_t* dst = indices.data() + begin;
+			std::size_t passed = 0;
+			for (std::size_t i = begin; i < end; i += intern::PlaneBlock) {
+				std::size_t n = std::min(intern::PlaneBlock, end - i);
+				std::fill(inside, inside + n, std::uint8_t(1));
+				for (std::size_t p = 0; p < planes.size(); ++p) {
+					intern::plane_distances(planes, p, axes, i, i + n, dist);
+					for (std::size_t j = 0; j < n; ++j) {
+						inside[j] &= dist[j] <= eps;
+					}
+				}
+				for (std::size_t j = 0; j < n; ++j) {
+					dst[passed] = static_cast<std::uint32_t>(i + j);
+					passed += inside[j];
+				}
+			}
+			kept[begin / intern::PlaneChunk] = passed;
+		});
+
+		std::size_t total = 0;
+		for (std::size_t c = 0; c < chunks; ++c) {
+			std::uint32_t* src = indices.data() + c * intern::PlaneChunk;
+			std::copy(src, src + kept[c], indices.data() + total);
+			total += kept[c];
+		}
+		indices.resize(total);
+		return total;
+	}
+	template<typename T, int N>
+	std::size_t inside_batch(const PointSoA<T, N>& points, const PlaneSet<T, N>& planes, std::vector<std::uint32_t>& indices) {
+		return inside_batch(points, planes, indices, default_pool());
+	}
+};
@@ -0,0 +1,279 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+
+#include "Ray.hpp"
+#include "SoA.hpp"
+#include "BatchIntersect.hpp"
+#include "ThreadPool.hpp"
+
+/*
+Parallel front end for large batches of queries against a structure of arrays set.
+The queries are split into chunks of QueryChunk, and the chunks are run on an executor, see ThreadPool.hpp.
+Every query writes only its own output slot, so the results are identical whatever the executor or the number of threads.
+
+Ray casts report the closest hit per ray into a caller allocated array.
+Overlap queries fill a QueryResults, every query gets the range of set indices it overlaps, in increasing order.
+The containers of a QueryResults keep their capacity between calls, so reusing one avoids reallocating every frame.
+*/
+
+namespace ez {
+	template<typename T>
+	struct RayHit {
+		static constexpr std::uint32_t None = std::numeric_limits<std::uint32_t>::max();
+
+		explicit operator bool() const noexcept {
+			return index != None;
+		}
+
+		// Index into the set of the closest element hit, None when the ray misses everything.
+		std::uint32_t index;
+		// Distance along the ray in multiples of its axis, or the largest value of T on a miss.
+		T t;
+	};
+
+	// The set indices overlapped by each query, stored contiguously.
+	struct QueryResults {
+		// The number of queries.
+		std::size_t size() const noexcept {
+			return offsets.empty() ? 0 : offsets.size() - 1;
+		}
+		std::size_t count(std::size_t query) const noexcept {
+			return offsets[query + 1] - offsets[query];
+		}
+		const std::uint32_t* begin(std::size_t query) const noexcept {
+			return indices.data() + offsets[query];
+		}
+		const std::uint32_t* end(std::size_t query) const noexcept {
+			return indices.data() + offsets[query + 1];
+		}
+
+		// The results of query i are indices[offsets[i]] up to indices[offsets[i + 1]].
+		std::vector<std::size_t> offsets;
+		std::vector<std::uint32_t> indices;
+		// Per chunk results before they are gathered.
+		std::vector<std::vector<std::uint32_t>> scratch;
+	};
+
+	namespace intern {
+		// Queries per task, large enough to amortize the scheduling and small enough to balance the load.
+		static constexpr std::size_t QueryChunk = 256;
+
+		// Spread the low 21 bits of v so there are two zero bits between each.
+		inline std::uint64_t spread3(std::uint64_t v) noexcept {
+			v &= 0x1FFFFF;
+			v = (v | (v << 32)) & 0x1F00000000FFFFull;
+			v = (v | (v << 16)) & 0x1F0000FF0000FFull;
+			v = (v | (v << 8)) & 0x100F00F00F00F00Full;
+			v = (v | (v << 4)) & 0x10C30C30C30C30C3ull;
+			v = (v | (v << 2)) & 0x1249249249249249ull;
+			return v;
+		}
+		// Interleave the low 21 bits of each coordinate into a 63 bit Morton code.
+		inline std::uint64_t morton3(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept {
+			return spread3(x) | (spread3(y) << 1) | (spread3(z) << 2);
+		}
+
+		template<typename T>
+		std::uint32_t quantize(T value, T offset, T scale, std::uint32_t max) noexcept {
+			T q = std::min(std::max((value - offset) * scale, T(0)), T(max));
+			return static_cast<std::uint32_t>(q);
+		}
+
+		// Closest ray hit over a set of boxes, the slab test of intersect(Ray3, AABB3, T&) without branches.
+		template<typename T>
+		RayHit<T> closest_hit(const Ray3<T>& ray, const MMRectSoA3<T>& set) noexcept {
+			const glm::tvec3<T> inv = T(1) / ray.axis;
+			const T* min[3] = { set.min.data(0), set.min.data(1), set.min.data(2) };
+			const T* max[3] = { set.max.data(0), set.max.data(1), set.max.data(2) };
+
+			RayHit<T> ret{ RayHit<T>::None, std::numeric_limits<T>::max() };
+			std::size_t count = set.size();
+			for (std::size_t j = 0; j < count; ++j) {
+				T tmin = -std::numeric_limits<T>::max(), tmax = std::numeric_limits<T>::max();
+				for (int k = 0; k < 3; ++k) {
+					T t1 = (min[k][j] - ray.origin[k]) * inv[k];
+					T t2 = (max[k][j] - ray.origin[k]) * inv[k];
+					tmin = std::max(tmin, std::min(t1, t2));
+					tmax = std::min(tmax, std::max(t1, t2));
+				}
+				T t = tmin < T(0) ? tmax : tmin;
+				bool hit = (tmax > std::max(tmin, T(0))) & (t < ret.t);
+				ret.t = hit ? t : ret.t;
+				ret.index = hit ? static_cast<std::uint32_t>(j) : ret.index;
+			}
+			return ret;
+		}
+
+		// Closest ray hit over a set of spheres, the nearest non negative root of the quadratic.
+		template<typename T>
+		RayHit<T> closest_hit(const Ray3<T>& ray, const SphereSoA<T>& set) noexcept {
+			const T* origin[3] = { set.origin.data(0), set.origin.data(1), set.origin.data(2) };
+			const T* radius = set.radius.data();
+			const T a = glm::dot(ray.axis, ray.axis);
+			const T inva = T(1) / a;
+
+			RayHit<T> ret{ RayHit<T>::None, std::numeric_limits<T>::max() };
+			std::size_t count = set.size();
+			for (std::size_t j = 0; j < count; ++j) {
+				T b = T(0), c = T(0);
+				for (int k = 0; k < 3; ++k) {
+					T l = ray.origin[k] - origin[k][j];
+					b += ray.axis[k] * l;
+					c += l * l;
+				}
+				c -= radius[j] * radius[j];
+
+				T disc = b * b - a * c;
+				T root = std::sqrt(std::max(disc, T(0)));
+				T t0 = (-b - root) * inva, t1 = (-b + root) * inva;
+				T t = t0 < T(0) ? t1 : t0;
+				bool hit = (disc >= T(0)) & (t >= T(0)) & (t < ret.t);
+				ret.t = hit ? t : ret.t;
+				ret.index = hit ? static_cast<std::uint32_t>(j) : ret.index;
+			}
+			return ret;
+		}
+
+		template<typename T, typename S, typename Exec>
+		void raycast(const Ray3<T>* rays, std::size_t count, const S& set, RayHit<T>* hits, Exec&& exec, const std::uint32_t* order) {
+			parallel_for(exec, count, QueryChunk, [&](std::size_t begin, std::size_t end) {
+				for (std::size_t i = begin; i < end; ++i) {
+					std::size_t r = order ? order[i] : i;
+					hits[r] = closest_hit(rays[r], set);
+				}
+			});
+		}
+
+		template<typename Q, typename S, typename Exec>
+		void overlap(const Q* queries, std::size_t count, const S& set, QueryResults& out, Exec&& exec) {
+			std::size_t chunks = (count + QueryChunk - 1) / QueryChunk;
+			out.offsets.resize(count + 1);
+			out.offsets[0] = 0;
+			if (out.scratch.size() < chunks) {
+				out.scratch.resize(chunks);
+			}
+
+			// Each chunk gathers its own results and records the count of every query.
+			exec(chunks, [&](std::size_t c) {
+				std::vector<std::uint32_t>& local = out.scratch[c];
+				local.clear();
+				std::size_t begin = c * QueryChunk, end = std::min(count, begin + QueryChunk);
+				for (std::size_t i = begin; i < end; ++i) {
+					out.offsets[i + 1] = compact_indices(kernel(queries[i], set), 0, set.size(), local);
+				}
+			});
+
+			for (std::size_t i = 0; i < count; ++i) {
+				out.offsets[i + 1] += out.offsets[i];
+			}
+			out.indices.resize(out.offsets[count]);
+
+			exec(chunks, [&](std::size_t c) {
+				const std::vector<std::uint32_t>& local = out.scratch[c];
+				std::copy(local.begin(), local.end(), out.indices.begin() + out.offsets[c * QueryChunk]);
+			});
+		}
+	}
+
+	// Fill order with a permutation of the rays that groups rays with nearby origins and similar directions.
+	// The key is a Morton code of the origin relative to the bounds of all origins, followed by a Morton code of the direction.
+	template<typename T>
+	void sort_rays(const Ray3<T>* rays, std::size_t count, std::vector<std::uint32_t>& order) {
+		using vec3_t = glm::tvec3<T>;
+		vec3_t lo{ std::numeric_limits<T>::max() }, hi{ std::numeric_limits<T>::lowest() };
+		for (std::size_t i = 0; i < count; ++i) {
+			lo = glm::min(lo, rays[i].origin);
+			hi = glm::max(hi, rays[i].origin);
+		}
+
+		vec3_t scale;
+		for (int k = 0; k < 3; ++k) {
+			scale[k] = hi[k] > lo[k] ? T(65535) / (hi[k] - lo[k]) : T(0);
+		}
+
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> keys(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			const Ray3<T>& ray = rays[i];
+			std::uint32_t o[3], d[3];
+			T length = std::sqrt(glm::dot(ray.axis, ray.axis));
+			T dscale = length > T(0) ? T(15.5) / length : T(0);
+			for (int k = 0; k < 3; ++k) {
+				o[k] = intern::quantize(ray.origin[k], lo[k], scale[k], 65535u);
+				d[k] = intern::quantize(ray.axis[k] * dscale, T(-16), T(1), 31u);
+			}
+			std::uint64_t key = (intern::morton3(o[0], o[1], o[2]) << 15) | intern::morton3(d[0], d[1], d[2]);
+			keys[i] = { key, static_cast<std::uint32_t>(i) };
+		}
+		std::sort(keys.begin(), keys.end());
+
+		order.resize(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			order[i] = keys[i].second;
+		}
+	}
+
+	// Closest hit of every ray against a set of boxes, hits must hold count elements.
+	// When order is given, the rays are processed in that order, see sort_rays. The results are written by ray index either way.
+	template<typename T, typename Exec>
+	void raycast_batch(const Ray3<T>* rays, std::size_t count, const MMRectSoA3<T>& set, RayHit<T>* hits, Exec&& exec, const std::uint32_t* order = nullptr) {
+		intern::raycast(rays, count, set, hits, exec, order);
+	}
+	template<typename T>
+	void raycast_batch(const Ray3<T>* rays, std::size_t count, const MMRectSoA3<T>& set, RayHit<T>* hits) {
+		intern::raycast(rays, count, set, hits, default_pool(), nullptr);
+	}
+
+	// Closest hit of every ray against a set of spheres, hits must hold count elements.
+	template<typename T, typename Exec>
+	void raycast_batch(const Ray3<T>* rays, std::size_t count, const SphereSoA<T>& set, RayHit<T>* hits, Exec&& exec, const std::uint32_t* order = nullptr) {
+		intern::raycast(rays, count, set, hits, exec, order);
+	}
+	template<typename T>
+	void raycast_batch(const Ray3<T>* rays, std::size_t count, const SphereSoA<T>& set, RayHit<T>* hits) {
+		intern::raycast(rays, count, set, hits, default_pool(), nullptr);
+	}
+
+	// The elements of the set overlapped by every query, same results as intersect_batch called once per query.
+	template<typename T, typename Exec>
+	void query_batch(const MMRect<T, 3>* queries, std::size_t count, const MMRectSoA3<T>& set, QueryResults& out, Exec&& exec) {
+		intern::overlap(queries, count, set, out, exec);
+	}
+	template<typename T>
+	void query_batch(const MMRect<T, 3>* queries, std::size_t count, const MMRectSoA3<T>& set, QueryResults& out) {
+		intern::overlap(queries, count, set, out, default_pool());
+	}
+
+	template<typename T, typename Exec>
+	void query_batch(const MMRect<T, 3>* queries, std::size_t count, const SphereSoA<T>& set, QueryResults& out, Exec&& exec) {
+		intern::overlap(queries, count, set, out, exec);
+	}
+	template<typename T>
+	void query_batch(const MMRect<T, 3>* queries, std::size_t count, const SphereSoA<T>& set, QueryResults& out) {
+		intern::overlap(queries, count, set, out, default_pool());
+	}
+
+	template<typename T, typename Exec>
+	void query_batch(const Sphere<T>* queries, std::size_t count, const SphereSoA<T>& set, QueryResults& out, Exec&& exec) {
+		intern::overlap(queries, count, set, out, exec);
+	}
+	template<typename T>
+	void query_batch(const Sphere<T>* queries, std::size_t count, const SphereSoA<T>& set, QueryResults& out) {
+		intern::overlap(queries, count, set, out, default_pool());
+	}
+
+	template<typename T, typename Exec>
+	void query_batch(const Sphere<T>* queries, std::size_t count, const MMRectSoA3<T>& set, QueryResults& out, Exec&& exec) {
+		intern::overlap(queries, count, set, out, exec);
+	}
+	template<typename T>
+	void query_batch(const Sphere<T>* queries, std::size_t count, const MMRectSoA3<T>& set, QueryResults& out) {
+		intern::overlap(queries, count, set, out, default_pool());
+	}
+};
@@ -0,0 +1,238 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+#include "SoA.hpp"
+#include "Transform.hpp"
+
+/*
+Batch interpolation and composition of 3d transforms stored in a TransformSoA.
+The kernels are written as flat loops over the component arrays with no branches in the loop body, so the compiler can vectorize them.
+Interpolated rotations take the shortest path, the second quaternion is negated when the two lie in opposite hemispheres.
+The output may alias either input.
+*/
+
+namespace ez {
+	namespace intern {
+		// Interpolation weight shared by every element.
+		template<typename T>
+		struct UniformWeight {
+			T operator[](std::size_t) const noexcept {
+				return value;
+			}
+			T value;
+		};
+
+		// One interpolation weight per element.
+		template<typename T>
+		struct ArrayWeight {
+			T operator[](std::size_t index) const noexcept {
+				return values[index];
+			}
+			const T* values;
+		};
+
+		template<typename T, int N, typename W>
+		void lerp_points(const PointSoA<T, N>& a, const PointSoA<T, N>& b, W weight, PointSoA<T, N>& out) {
+			std::size_t count = std::min(a.size(), b.size());
+			out.resize(count);
+			for (int k = 0; k < N; ++k) {
+				const T* pa = a.data(k);
+				const T* pb = b.data(k);
+				T* po = out.data(k);
+				for (std::size_t j = 0; j < count; ++j) {
+					po[j] = pa[j] + (pb[j] - pa[j]) * weight[j];
+				}
+			}
+		}
+
+		// Linear blend of the rotations followed by renormalization.
+		template<typename T, typename W>
+		void nlerp_rotations(const PointSoA<T, 4>& a, const PointSoA<T, 4>& b, W weight, PointSoA<T, 4>& out) {
+			std::size_t count = std::min(a.size(), b.size());
+			out.resize(count);
+			const T* ax = a.data(0), * ay = a.data(1), * az = a.data(2), * aw = a.data(3);
+			const T* bx = b.data(0), * by = b.data(1), * bz = b.data(2), * bw = b.data(3);
+			T* ox = out.data(0), * oy = out.data(1), * oz = out.data(2), * ow = out.data(3);
+
+			for (std::size_t j = 0; j < count; ++j) {
+				T t = weight[j];
+				T cosine = ax[j] * bx[j] + ay[j] * by[j] + az[j] * bz[j] + aw[j] * bw[j];
+				T wa = T(1) - t;
+				T wb = cosine < T(0) ? -t : t;
+
+				T x = ax[j] * wa + bx[j] * wb;
+				T y = ay[j] * wa + by[j] * wb;
+				T z = az[j] * wa + bz[j] * wb;
+				T w = aw[j] * wa + bw[j] * wb;
+				T inv = T(1) / std::sqrt(x * x + y * y + z * z + w * w);
+
+				ox[j] = x * inv;
+				oy[j] = y * inv;
+				oz[j] = z * inv;
+				ow[j] = w * inv;
+			}
+		}
+
+		// Constant angular velocity blend, nearly identical rotations fall back to a linear blend to avoid dividing by a vanishing sine.
+		template<typename T, typename W>
+		void slerp_rotations(const PointSoA<T, 4>& a, const PointSoA<T, 4>& b, W weight, PointSoA<T, 4>& out) {
+			std::size_t count = std::min(a.size(), b.size());
+			out.resize(count);
+			const T* ax = a.data(0), * ay = a.data(1), * az = a.data(2), * aw = a.data(3);
+			const T* bx = b.data(0), * by = b.data(1), * bz = b.data(2), * bw = b.data(3);
+			T* ox = out.data(0), * oy = out.data(1), * oz = out.data(2), * ow = out.data(3);
+
+			const T limit = T(1) - T(16) * std::numeric_limits<T>::epsilon();
+			for (std::size_t j = 0; j < count; ++j) {
+				T t = weight[j];
+				T cosine = ax[j] * bx[j] + ay[j] * by[j] + az[j] * bz[j] + aw[j] * bw[j];
+				T sign = cosine < T(0) ? T(-1) : T(1);
+				cosine = std::min(std::abs(cosine), T(1));
+
+				T angle = std::acos(cosine);
+				T sine = std::sin(angle);
+				bool linear = cosine > limit;
+				T inv = linear ? T(1) : T(1) / sine;
+				T wa = linear ? T(1) - t : std::sin((T(1) - t) * angle) * inv;
+				T wb = (linear ? t : std::sin(t * angle) * inv) * sign;
+
+				ox[j] = ax[j] * wa + bx[j] * wb;
+				oy[j] = ay[j] * wa + by[j] * wb;
+				oz[j] = az[j] * wa + bz[j] * wb;
+				ow[j] = aw[j] * wa + bw[j] * wb;
+			}
+		}
+	}
+
+	// Per element linear interpolation of two point arrays.
+	template<typename T, int N>
+	void lerp_batch(const PointSoA<T, N>& a, const PointSoA<T, N>& b, T t, PointSoA<T, N>& out) {
+		intern::lerp_points(a, b, intern::UniformWeight<T>{ t }, out);
+	}
+	template<typename T, int N>
+	void lerp_batch(const PointSoA<T, N>& a, const PointSoA<T, N>& b, const T* t, PointSoA<T, N>& out) {
+		intern::lerp_points(a, b, intern::ArrayWeight<T>{ t }, out);
+	}
+
+	// Interpolate origin and scale linearly, and the rotation with a normalized linear blend.
+	// Cheaper than slerp, the angular velocity is not constant but the path is the same.
+	template<typename T>
+	void nlerp_batch(const TransformSoA<T>& a, const TransformSoA<T>& b, T t, TransformSoA<T>& out) {
+		intern::UniformWeight<T> weight{ t };
+		intern::lerp_points(a.origin, b.origin, weight, out.origin);
+		intern::lerp_points(a.scale, b.scale, weight, out.scale);
+		intern::nlerp_rotations(a.rotation, b.rotation, weight, out.rotation);
+	}
+	// Same as above, with one weight per element.
+	template<typename T>
+	void nlerp_batch(const TransformSoA<T>& a, const TransformSoA<T>& b, const T* t, TransformSoA<T>& out) {
+		intern::ArrayWeight<T> weight{ t };
+		intern::lerp_points(a.origin, b.origin, weight, out.origin);
+		intern::lerp_points(a.scale, b.scale, weight, out.scale);
+		intern::nlerp_rotations(a.rotation, b.rotation, weight, out.rotation);
+	}
+
+	// Interpolate origin and scale linearly, and the rotation with spherical linear interpolation.
+	template<typename T>
+	void slerp_batch(const TransformSoA<T>& a, const TransformSoA<T>& b, T t, TransformSoA<T>& out) {
+		intern::UniformWeight<T> weight{ t };
+		intern::lerp_points(a.origin, b.origin, weight, out.origin);
+		intern::lerp_points(a.scale, b.scale, weight, out.scale);
+		intern::slerp_rotations(a.rotation, b.rotation, weight, out.rotation);
+	}
+	// Same as above, with one weight per element.
+	template<typename T>
+	void slerp_batch(const TransformSoA<T>& a, const TransformSoA<T>& b, const T* t, TransformSoA<T>& out) {
+		intern::ArrayWeight<T> weight{ t };
+		intern::lerp_points(a.origin, b.origin, weight, out.origin);
+		intern::lerp_points(a.scale, b.scale, weight, out.scale);
+		intern::slerp_rotations(a.rotation, b.rotation, weight, out.rotation);
+	}
+
+	// Batch form of parents[j].toWorld(locals[j]).
+	template<typename T>
+	void to_world_batch(const TransformSoA<T>& parents, const TransformSoA<T>& locals, TransformSoA<T>& out) {
+		std::size_t count = std::min(parents.size(), locals.size());
+		out.resize(count);
+
+		const T* pox = parents.origin.data(0), * poy = parents.origin.data(1), * poz = parents.origin.data(2);
+		const T* psx = parents.scale.data(0), * psy = parents.scale.data(1), * psz = parents.scale.data(2);
+		const T* pqx = parents.rotation.data(0), * pqy = parents.rotation.data(1), * pqz = parents.rotation.data(2), * pqw = parents.rotation.data(3);
+
+		const T* lox = locals.origin.data(0), * loy = locals.origin.data(1), * loz = locals.origin.data(2);
+		const T* lsx = locals.scale.data(0), * lsy = locals.scale.data(1), * lsz = locals.scale.data(2);
+		const T* lqx = locals.rotation.data(0), * lqy = locals.rotation.data(1), * lqz = locals.rotation.data(2), * lqw = locals.rotation.data(3);
+
+		T* oox = out.origin.data(0), * ooy = out.origin.data(1), * ooz = out.origin.data(2);
+		T* osx = out.scale.data(0), * osy = out.scale.data(1), * osz = out.scale.data(2);
+		T* oqx = out.rotation.data(0), * oqy = out.rotation.data(1), * oqz = out.rotation.data(2), * oqw = out.rotation.data(3);
+
+		for (std::size_t j = 0; j < count; ++j) {
+			T qx = pqx[j], qy = pqy[j], qz = pqz[j], qw = pqw[j];
+			T rx = lqx[j], ry = lqy[j], rz = lqz[j], rw = lqw[j];
+
+			// The local origin, scaled by the parent then rotated: v + 2w (q x v) + 2 q x (q x v).
+			T vx = lox[j] * psx[j], vy = loy[j] * psy[j], vz = loz[j] * psz[j];
+			T tx = T(2) * (qy * vz - qz * vy);
+			T ty = T(2) * (qz * vx - qx * vz);
+			T tz = T(2) * (qx * vy - qy * vx);
+
+			oox[j] = pox[j] + vx + qw * tx + (qy * tz - qz * ty);
+			ooy[j] = poy[j] + vy + qw * ty + (qz * tx - qx * tz);
+			ooz[j] = poz[j] + vz + qw * tz + (qx * ty - qy * tx);
+
+			osx[j] = lsx[j] * psx[j];
+			osy[j] = lsy[j] * psy[j];
+			osz[j] = lsz[j] * psz[j];
+
+			// Hamilton product, parent * local.
+			oqx[j] = qw * rx + qx * rw + qy * rz - qz * ry;
+			oqy[j] = qw * ry - qx * rz + qy * rw + qz * rx;
+			oqz[j] = qw * rz + qx * ry - qy * rx + qz * rw;
+			oqw[j] = qw * rw - qx * rx - qy * ry - qz * rz;
+		}
+	}
+
+	// Batch form of parent.toWorld(locals[j]), with a single parent for every element.
+	template<typename T>
+	void to_world_batch(const Transform<T, 3>& parent, const TransformSoA<T>& locals, TransformSoA<T>& out) {
+		std::size_t count = locals.size();
+		out.resize(count);
+
+		const glm::tvec3<T> po = parent.origin, ps = parent.size;
+		const T qx = parent.rotation.x, qy = parent.rotation.y, qz = parent.rotation.z, qw = parent.rotation.w;
+
+		for (int k = 0; k < 3; ++k) {
+			const T* ls = locals.scale.data(k);
+			T* os = out.scale.data(k);
+			for (std::size_t j = 0; j < count; ++j) {
+				os[j] = ls[j] * ps[k];
+			}
+		}
+
+		const T* lox = locals.origin.data(0), * loy = locals.origin.data(1), * loz = locals.origin.data(2);
+		const T* lqx = locals.rotation.data(0), * lqy = locals.rotation.data(1), * lqz = locals.rotation.data(2), * lqw = locals.rotation.data(3);
+		T* oox = out.origin.data(0), * ooy = out.origin.data(1), * ooz = out.origin.data(2);
+		T* oqx = out.rotation.data(0), * oqy = out.rotation.data(1), * oqz = out.rotation.data(2), * oqw = out.rotation.data(3);
+
+		for (std::size_t j = 0; j < count; ++j) {
+			T vx = lox[j] * ps.x, vy = loy[j] * ps.y, vz = loz[j] * ps.z;
+			T tx = T(2) * (qy * vz - qz * vy);
+			T ty = T(2) * (qz * vx - qx * vz);
+			T tz = T(2) * (qx * vy - qy * vx);
+
+			oox[j] = po.x + vx + qw * tx + (qy * tz - qz * ty);
+			ooy[j] = po.y + vy + qw * ty + (qz * tx - qx * tz);
+			ooz[j] = po.z + vz + qw * tz + (qx * ty - qy * tx);
+
+			T rx = lqx[j], ry = lqy[j], rz = lqz[j], rw = lqw[j];
+			oqx[j] = qw * rx + qx * rw + qy * rz - qz * ry;
+			oqy[j] = qw * ry - qx * rz + qy * rw + qz * rx;
+			oqz[j] = qw * rz + qx * ry - qy * rx + qz * rw;
+			oqw[j] = qw * rw - qx * rx - qy * ry - qz * rz;
+		}
+	}
+};
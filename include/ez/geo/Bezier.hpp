@@ -0,0 +1,375 @@
+#pragma once
+#include <cmath>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <ez/math/poly.hpp>
+
+#include "Line.hpp"
+#include "Ray.hpp"
+#include "MMRect.hpp"
+#include "SoA.hpp"
+
+/*
+Quadratic and cubic Bezier curves in any dimension.
+
+Evaluation uses the power basis form of the curve, c0 + c1 t + c2 t^2 + c3 t^3, with Horner's rule.
+The batch functions loop over one axis at a time so they vectorize.
+
+Flattening picks a uniform number of segments from Wang's formula, which bounds the distance between the curve and the
+polyline by the tolerance. It needs no recursion and the count is known up front, so the output can be sized in one step.
+*/
+
+namespace ez {
+	template<typename T, int N, int D>
+	struct Bezier {
+		static_assert(D == 2 || D == 3, "ez::Bezier is only defined for quadratic and cubic curves!");
+		static_assert(std::is_floating_point_v<T>, "ez::Bezier requires a floating point value type!");
+		using vec_t = glm::vec<N, T>;
+		using rect_t = MMRect<T, N>;
+		static constexpr int Degree = D;
+		static constexpr int Count = D + 1;
+
+		Bezier() noexcept
+		{
+			points.fill(vec_t{ T(0) });
+		}
+		template<int K = D, typename = std::enable_if_t<(K == 2)>>
+		Bezier(const vec_t& p0, const vec_t& p1, const vec_t& p2) noexcept
+			: points{ p0, p1, p2 }
+		{}
+		template<int K = D, typename = std::enable_if_t<(K == 3)>>
+		Bezier(const vec_t& p0, const vec_t& p1, const vec_t& p2, const vec_t& p3) noexcept
+			: points{ p0, p1, p2, p3 }
+		{}
+
+		vec_t& operator[](int index) noexcept {
+			return points[index];
+		}
+		const vec_t& operator[](int index) const noexcept {
+			return points[index];
+		}
+
+		// Power basis coefficients, the curve is the sum of c[k] * t^k.
+		std::array<vec_t, Count> coefficients() const noexcept {
+			std::array<vec_t, Count> c;
+			const vec_t& p0 = points[0], & p1 = points[1], & p2 = points[2];
+			c[0] = p0;
+			if constexpr (D == 2) {
+				c[1] = (p1 - p0) * T(2);
+				c[2] = p0 - p1 * T(2) + p2;
+			}
+			else {
+				const vec_t& p3 = points[3];
+				c[1] = (p1 - p0) * T(3);
+				c[2] = (p0 - p1 * T(2) + p2) * T(3);
+				c[3] = p3 - p0 + (p1 - p2) * T(3);
+			}
+			return c;
+		}
+
+		vec_t eval(T t) const noexcept {
+			std::array<vec_t, Count> c = coefficients();
+			vec_t ret = c[D];
+			for (int k = D - 1; k >= 0; --k) {
+				ret = ret * t + c[k];
+			}
+			return ret;
+		}
+		// The tangent, the derivative with respect to t.
+		vec_t derivative(T t) const noexcept {
+			std::array<vec_t, Count> c = coefficients();
+			vec_t ret = c[D] * T(D);
+			for (int k = D - 1; k >= 1; --k) {
+				ret = ret * t + c[k] * T(k);
+			}
+			return ret;
+		}
+
+		// Split at t with de Casteljau's construction, left covers [0, t] and right covers [t, 1].
+		void split(T t, Bezier& left, Bezier& right) const noexcept {
+			std::array<vec_t, Count> work = points;
+			left.points[0] = work[0];
+			right.points[D] = work[D];
+			for (int level = 1; level <= D; ++level) {
+				for (int i = 0; i <= D - level; ++i) {
+					work[i] = work[i] + (work[i + 1] - work[i]) * t;
+				}
+				left.points[level] = work[0];
+				right.points[D - level] = work[D - level];
+			}
+		}
+
+		// Bounds of the control points, they always enclose the curve.
+		rect_t hull() const noexcept {
+			rect_t ret{ points[0], points[0] };
+			for (int i = 1; i < Count; ++i) {
+				ret.min = glm::min(ret.min, points[i]);
+				ret.max = glm::max(ret.max, points[i]);
+			}
+			return ret;
+		}
+
+		// Tight bounds, the end points and the extrema of each axis, found at the roots of the derivative.
+		rect_t bounds() const noexcept {
+			rect_t ret{ glm::min(points[0], points[D]), glm::max(points[0], points[D]) };
+			std::array<vec_t, Count> c = coefficients();
+			for (int k = 0; k < N; ++k) {
+				T roots[2];
+				int count;
+				if constexpr (D == 2) {
+					T a = c[2][k] * T(2);
+					count = a != T(0) ? 1 : 0;
+					roots[0] = count ? -c[1][k] / a : T(0);
+				}
+				else {
+					count = ez::poly::solveQuadratic<T>(c[3][k] * T(3), c[2][k] * T(2), c[1][k], roots);
+				}
+				for (int r = 0; r < count; ++r) {
+					T t = roots[r];
+					if (t > T(0) && t < T(1)) {
+						T v = c[D][k];
+						for (int j = D - 1; j >= 0; --j) {
+							v = v * t + c[j][k];
+						}
+						ret.min[k] = std::min(ret.min[k], v);
+						ret.max[k] = std::max(ret.max[k], v);
+					}
+				}
+			}
+			return ret;
+		}
+
+		// Number of uniform segments needed to stay within tolerance of the curve, from Wang's formula.
+		std::size_t segments(T tolerance) const noexcept {
+			T m = T(0);
+			for (int i = 0; i + 2 < Count; ++i) {
+				vec_t d = points[i] - points[i + 1] * T(2) + points[i + 2];
+				m = std::max(m, glm::dot(d, d));
+			}
+			T n = std::sqrt(std::sqrt(m) * T(D * (D - 1)) / (T(8) * tolerance));
+			return std::max<std::size_t>(static_cast<std::size_t>(std::ceil(n)), 1);
+		}
+
+		std::array<vec_t, Count> points;
+	};
+
+	template<typename T, int N>
+	using QuadraticBezier = Bezier<T, N, 2>;
+
+	template<typename T, int N>
+	using CubicBezier = Bezier<T, N, 3>;
+
+	template<typename T>
+	using QuadraticBezier2 = Bezier<T, 2, 2>;
+
+	template<typename T>
+	using QuadraticBezier3 = Bezier<T, 3, 2>;
+
+	template<typename T>
+	using CubicBezier2 = Bezier<T, 2, 3>;
+
+	template<typename T>
+	using CubicBezier3 = Bezier<T, 3, 3>;
+
+	namespace intern {
+		// Real roots of a t^3 + b t^2 + c t + d, returns their count. Falls back to the quadratic when a vanishes.
+		template<typename T>
+		int solve_cubic(T a, T b, T c, T d, T* roots) noexcept {
+			T scale = std::max(std::max(std::abs(b), std::abs(c)), std::abs(d));
+			if (std::abs(a) <= scale * T(1e-9)) {
+				return ez::poly::solveQuadratic<T>(b, c, d, roots);
+			}
+
+			// Depressed cubic x^3 + p x + q with t = x - b / 3a.
+			T B = b / a, C = c / a, E = d / a;
+			T shift = -B / T(3);
+			T p = C - B * B / T(3);
+			T q = T(2) * B * B * B / T(27) - B * C / T(3) + E;
+			T disc = q * q / T(4) + p * p * p / T(27);
+
+			int count;
+			if (disc > T(0)) {
+				T s = std::sqrt(disc);
+				roots[0] = std::cbrt(-q / T(2) + s) + std::cbrt(-q / T(2) - s) + shift;
+				count = 1;
+			}
+			else if (p == T(0)) {
+				roots[0] = shift;
+				count = 1;
+			}
+			else {
+				T r = T(2) * std::sqrt(-p / T(3));
+				T cosine = std::min(std::max(T(3) * q / (T(2) * p) * std::sqrt(T(-3) / p), T(-1)), T(1));
+				T phi = std::acos(cosine) / T(3);
+				const T third = T(2.09439510239319549230842892218633526);
+				for (int k = 0; k < 3; ++k) {
+					roots[k] = r * std::cos(phi - third * T(k)) + shift;
+				}
+				count = 3;
+			}
+
+			// Polish with Newton's method, the closed forms lose precision near multiple roots.
+			for (int i = 0; i < count; ++i) {
+				for (int iter = 0; iter < 2; ++iter) {
+					T t = roots[i];
+					T f = ((a * t + b) * t + c) * t + d;
+					T df = (T(3) * a * t + T(2) * b) * t + c;
+					if (df != T(0)) {
+						roots[i] = t - f / df;
+					}
+				}
+			}
+			return count;
+		}
+
+		// Parameters along the curve and along the line origin + s * dir where the two meet, sorted by s.
+		// Only curve parameters in [0, 1] and line parameters in [smin, smax] are kept.
+		template<typename T, int D>
+		int line_curve(const glm::tvec2<T>& origin, const glm::tvec2<T>& dir, T smin, T smax, const Bezier<T, 2, D>& curve, T* curveT, T* lineT) noexcept {
+			using vec2_t = glm::tvec2<T>;
+			std::array<vec2_t, D + 1> c = curve.coefficients();
+			vec2_t n{ -dir.y, dir.x };
+
+			// The signed distance of the curve to the line is a polynomial in t.
+			T f[4] = { glm::dot(n, c[0] - origin), T(0), T(0), T(0) };
+			for (int k = 1; k <= D; ++k) {
+				f[k] = glm::dot(n, c[k]);
+			}
+
+			T roots[3];
+			int count;
+			if constexpr (D == 2) {
+				count = ez::poly::solveQuadratic<T>(f[2], f[1], f[0], roots);
+			}
+			else {
+				count = solve_cubic<T>(f[3], f[2], f[1], f[0], roots);
+			}
+
+			const T eps = T(64) * std::numeric_limits<T>::epsilon();
+			const T invLength = T(1) / glm::dot(dir, dir);
+			int ret = 0;
+			for (int i = 0; i < count; ++i) {
+				T t = roots[i];
+				if (t < -eps || t > T(1) + eps) {
+					continue;
+				}
+				t = std::min(std::max(t, T(0)), T(1));
+				T s = glm::dot(curve.eval(t) - origin, dir) * invLength;
+				if (s < smin || s > smax) {
+					continue;
+				}
+
+				// Insertion keeps the hits sorted along the line.
+				int j = ret++;
+				for (; j > 0 && lineT[j - 1] > s; --j) {
+					lineT[j] = lineT[j - 1];
+					curveT[j] = curveT[j - 1];
+				}
+				lineT[j] = s;
+				curveT[j] = t;
+			}
+			return ret;
+		}
+	}
+
+	// Evaluate the curve at every t, out is resized to count.
+	template<typename T, int N, int D>
+	void eval_batch(const Bezier<T, N, D>& curve, const T* t, std::size_t count, PointSoA<T, N>& out) {
+		out.resize(count);
+		std::array<glm::vec<N, T>, D + 1> c = curve.coefficients();
+		for (int k = 0; k < N; ++k) {
+			T* dst = out.data(k);
+			const T c0 = c[0][k], c1 = c[1][k], c2 = c[2][k], c3 = D == 3 ? c[D][k] : T(0);
+			for (std::size_t i = 0; i < count; ++i) {
+				T x = t[i];
+				dst[i] = ((c3 * x + c2) * x + c1) * x + c0;
+			}
+		}
+	}
+
+	// Append the points of the flattened curve, segments(tolerance) + 1 of them including both end points.
+	template<typename T, int N, int D>
+	void flatten(const Bezier<T, N, D>& curve, T tolerance, std::vector<glm::vec<N, T>>& out) {
+		std::size_t n = curve.segments(tolerance);
+		std::size_t start = out.size();
+		out.resize(start + n + 1);
+
+		std::array<glm::vec<N, T>, D + 1> c = curve.coefficients();
+		const T step = T(1) / T(n);
+		glm::vec<N, T>* dst = out.data() + start;
+		for (std::size_t i = 0; i <= n; ++i) {
+			T x = T(i) * step;
+			glm::vec<N, T> p = c[D];
+			for (int k = D - 1; k >= 0; --k) {
+				p = p * x + c[k];
+			}
+			dst[i] = p;
+		}
+		// The end points are exact.
+		dst[0] = curve.points[0];
+		dst[n] = curve.points[D];
+	}
+
+	// Append the segments of the flattened curve.
+	template<typename T, int D>
+	void flatten(const Bezier<T, 2, D>& curve, T tolerance, std::vector<Line2<T>>& out) {
+		std::size_t n = curve.segments(tolerance);
+		std::size_t start = out.size();
+		out.resize(start + n);
+
+		glm::tvec2<T> prev = curve.points[0];
+		const T step = T(1) / T(n);
+		for (std::size_t i = 1; i <= n; ++i) {
+			glm::tvec2<T> next = i == n ? curve.points[D] : curve.eval(T(i) * step);
+			out[start + i - 1] = Line2<T>{ prev, next };
+			prev = next;
+		}
+	}
+
+	// Flatten many curves, the points of curve i are points[offsets[i]] up to points[offsets[i + 1]].
+	// The segment counts are computed for all curves first so the output is sized once. The vectors keep their capacity between calls.
+	template<typename T, int N, int D>
+	void flatten_batch(const Bezier<T, N, D>* curves, std::size_t count, T tolerance, std::vector<glm::vec<N, T>>& points, std::vector<std::size_t>& offsets) {
+		offsets.resize(count + 1);
+		offsets[0] = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			offsets[i + 1] = offsets[i] + curves[i].segments(tolerance) + 1;
+		}
+		points.resize(offsets[count]);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			std::array<glm::vec<N, T>, D + 1> c = curves[i].coefficients();
+			glm::vec<N, T>* dst = points.data() + offsets[i];
+			std::size_t n = offsets[i + 1] - offsets[i] - 1;
+			const T step = T(1) / T(n);
+			for (int k = 0; k < N; ++k) {
+				const T c0 = c[0][k], c1 = c[1][k], c2 = c[2][k], c3 = D == 3 ? c[D][k] : T(0);
+				for (std::size_t j = 0; j <= n; ++j) {
+					T x = T(j) * step;
+					dst[j][k] = ((c3 * x + c2) * x + c1) * x + c0;
+				}
+			}
+			dst[0] = curves[i].points[0];
+			dst[n] = curves[i].points[D];
+		}
+	}
+
+	// Intersections of a ray with a curve, returns their count, at most the degree of the curve.
+	// curveT receives the curve parameters and rayT the distances along the ray in multiples of its axis, sorted by distance.
+	template<typename T, int D>
+	int intersect(const Ray2<T>& ray, const Bezier<T, 2, D>& curve, T* curveT, T* rayT) noexcept {
+		return intern::line_curve(ray.origin, ray.axis, T(0), std::numeric_limits<T>::max(), curve, curveT, rayT);
+	}
+	// Intersections of a segment with a curve, lineT receives the parameters along the segment, in [0, 1].
+	template<typename T, int D>
+	int intersect(const Line2<T>& line, const Bezier<T, 2, D>& curve, T* curveT, T* lineT) noexcept {
+		return intern::line_curve(line.start, line.end - line.start, T(0), T(1), curve, curveT, lineT);
+	}
+};
@@ -0,0 +1,373 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <limits>
+#include <random>
+#include <algorithm>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include "MMRect.hpp"
+#include "Circle.hpp"
+#include "Sphere.hpp"
+#include "SoA.hpp"
+
+// Bounding volumes of large point sets.
+
+namespace ez {
+	namespace intern {
+		// Independent min/max accumulators per pass, enough to hide the latency of the min/max chain and fill the vector registers.
+		static constexpr std::size_t BoundsLanes = 8;
+
+		// Bounds of count tightly packed N dimensional points, stored as a flat array of scalars.
+		template<typename T, int N>
+		MMRect<T, N> bounds_flat(const T* flat, std::size_t count) noexcept {
+			constexpr std::size_t Stride = N * BoundsLanes;
+			T lo[Stride], hi[Stride];
+			for (std::size_t l = 0; l < Stride; ++l) {
+				lo[l] = std::numeric_limits<T>::max();
+				hi[l] = std::numeric_limits<T>::lowest();
+			}
+
+			// Stride is a multiple of N, so lane l always holds axis l % N.
+			std::size_t total = count * N;
+			std::size_t i = 0;
+			for (; i + Stride <= total; i += Stride) {
+				for (std::size_t l = 0; l < Stride; ++l) {
+					lo[l] = std::min(lo[l], flat[i + l]);
+					hi[l] = std::max(hi[l], flat[i + l]);
+				}
+			}
+			for (std::size_t l = 0; i < total; ++i, ++l) {
+				lo[l] = std::min(lo[l], flat[i]);
+				hi[l] = std::max(hi[l], flat[i]);
+			}
+
+			MMRect<T, N> ret;
+			for (int k = 0; k < N; ++k) {
+				ret.min[k] = lo[k];
+				ret.max[k] = hi[k];
+				for (std::size_t l = k + N; l < Stride; l += N) {
+					ret.min[k] = std::min(ret.min[k], lo[l]);
+					ret.max[k] = std::max(ret.max[k], hi[l]);
+				}
+			}
+			return ret;
+		}
+
+		template<typename T>
+		void bounds_axis(const T* values, std::size_t begin, std::size_t end, T& outMin, T& outMax) noexcept {
+			T lo[BoundsLanes], hi[BoundsLanes];
+			for (std::size_t l = 0; l < BoundsLanes; ++l) {
+				lo[l] = std::numeric_limits<T>::max();
+				hi[l] = std::numeric_limits<T>::lowest();
+			}
+
+			std::size_t i = begin;
+			for (; i + BoundsLanes <= end; i += BoundsLanes) {
+				for (std::size_t l = 0; l < BoundsLanes; ++l) {
+					lo[l] = std::min(lo[l], values[i + l]);
+					hi[l] = std::max(hi[l], values[i + l]);
+				}
+			}
+			for (; i < end; ++i) {
+				lo[0] = std::min(lo[0], values[i]);
+				hi[0] = std::max(hi[0], values[i]);
+			}
+
+			outMin = *std::min_element(lo, lo + BoundsLanes);
+			outMax = *std::max_element(hi, hi + BoundsLanes);
+		}
+
+		template<typename T, int N>
+		MMRect<T, N> empty_bounds() noexcept {
+			return MMRect<T, N>{ glm::vec<N, T>{ std::numeric_limits<T>::max() }, glm::vec<N, T>{ std::numeric_limits<T>::lowest() } };
+		}
+
+		// Minimum number of points given to each worker thread, below this the threading overhead dominates.
+		static constexpr std::size_t BoundsGrain = 1 << 16;
+
+		inline std::size_t worker_count(std::size_t count, std::size_t threads) noexcept {
+			if (threads == 0) {
+				threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+			}
+			return std::max<std::size_t>(std::min(threads, count / BoundsGrain), 1);
+		}
+
+		// Run func(begin, end, worker) over count items split evenly, using the calling thread as the first worker.
+		template<typename F>
+		void parallel_chunks(std::size_t count, std::size_t workers, F&& func) {
+			std::vector<std::thread> pool;
+			pool.reserve(workers - 1);
+
+			std::size_t chunk = (count + workers - 1) / workers;
+			for (std::size_t w = 1; w < workers; ++w) {
+				std::size_t begin = std::min(count, w * chunk);
+				std::size_t end = std::min(count, begin + chunk);
+				pool.emplace_back([&func, begin, end, w]() {
+					func(begin, end, w);
+				});
+			}
+			func(std::size_t(0), std::min(count, chunk), std::size_t(0));
+
+			for (std::thread& t : pool) {
+				t.join();
+			}
+		}
+
+		// Ritter's update, moves the sphere toward the point just enough to enclose it.
+		template<typename T>
+		void grow(Sphere<T>& sphere, const glm::tvec3<T>& point) noexcept {
+			glm::tvec3<T> d = point - sphere.origin;
+			T d2 = glm::dot(d, d);
+			if (d2 > sphere.radius * sphere.radius) {
+				T dist = std::sqrt(d2);
+				T radius = (sphere.radius + dist) / T(2);
+				sphere.origin += d * ((radius - sphere.radius) / dist);
+				sphere.radius = radius;
+			}
+		}
+	}
+
+	// Bounds of a point array. Returns an inverted (invalid) rect when count is zero, so the result can still be merged.
+	template<typename T, int N>
+	MMRect<T, N> bounds(const glm::vec<N, T>* points, std::size_t count) noexcept {
+		static_assert(sizeof(glm::vec<N, T>) == sizeof(T) * N, "ez::bounds requires tightly packed vectors!");
+		if (count == 0) {
+			return intern::empty_bounds<T, N>();
+		}
+		return intern::bounds_flat<T, N>(reinterpret_cast<const T*>(points), count);
+	}
+	template<typename T, int N>
+	MMRect<T, N> bounds(const std::vector<glm::vec<N, T>>& points) noexcept {
+		return bounds(points.data(), points.size());
+	}
+
+	template<typename T, int N>
+	MMRect<T, N> bounds(const PointSoA<T, N>& points) noexcept {
+		MMRect<T, N> ret = intern::empty_bounds<T, N>();
+		for (int k = 0; k < N; ++k) {
+			intern::bounds_axis(points.data(k), 0, points.size(), ret.min[k], ret.max[k]);
+		}
+		return ret;
+	}
+
+	// Multithreaded bounds, each worker reduces a contiguous chunk and the partial results are merged.
+	// When threads is zero the hardware concurrency is used.
+	template<typename T, int N>
+	MMRect<T, N> bounds_parallel(const glm::vec<N, T>* points, std::size_t count, std::size_t threads = 0) {
+		std::size_t workers = intern::worker_count(count, threads);
+		if (workers == 1) {
+			return bounds(points, count);
+		}
+
+		std::vector<MMRect<T, N>> partial(workers, intern::empty_bounds<T, N>());
+		intern::parallel_chunks(count, workers, [&](std::size_t begin, std::size_t end, std::size_t w) {
+			if (begin < end) {
+				partial[w] = bounds(points + begin, end - begin);
+			}
+		});
+
+		MMRect<T, N> ret = partial[0];
+		for (std::size_t w = 1; w < workers; ++w) {
+			ret.merge(partial[w]);
+		}
+		return ret;
+	}
+	template<typename T, int N>
+	MMRect<T, N> bounds_parallel(const std::vector<glm::vec<N, T>>& points, std::size_t threads = 0) {
+		return bounds_parallel(points.data(), points.size(), threads);
+	}
+
+	template<typename T, int N>
+	MMRect<T, N> bounds_parallel(const PointSoA<T, N>& points, std::size_t threads = 0) {
+		std::size_t count = points.size();
+		std::size_t workers = intern::worker_count(count, threads);
+		if (workers == 1) {
+			return bounds(points);
+		}
+
+		std::vector<MMRect<T, N>> partial(workers, intern::empty_bounds<T, N>());
+		intern::parallel_chunks(count, workers, [&](std::size_t begin, std::size_t end, std::size_t w) {
+			for (int k = 0; k < N; ++k) {
+				intern::bounds_axis(points.data(k), begin, end, partial[w].min[k], partial[w].max[k]);
+			}
+		});
+
+		MMRect<T, N> ret = partial[0];
+		for (std::size_t w = 1; w < workers; ++w) {
+			ret.merge(partial[w]);
+		}
+		return ret;
+	}
+
+	// Ritter's bounding sphere, seeded with an approximate diameter and grown over a second pass.
+	// The result is not minimal, typically within 5 to 20 percent of the optimal radius.
+	template<typename T>
+	Sphere<T> ritter_sphere(const glm::tvec3<T>* points, std::size_t count) noexcept {
+		if (count == 0) {
+			return Sphere<T>{ T(0) };
+		}
+
+		auto farthest = [&](const glm::tvec3<T>& from) {
+			std::size_t best = 0;
+			T dist = T(-1);
+			for (std::size_t i = 0; i < count; ++i) {
+				glm::tvec3<T> d = points[i] - from;
+				T d2 = glm::dot(d, d);
+				if (d2 > dist) {
+					dist = d2;
+					best = i;
+				}
+			}
+			return points[best];
+		};
+
+		glm::tvec3<T> a = farthest(points[0]);
+		glm::tvec3<T> b = farthest(a);
+
+		Sphere<T> sphere{ glm::length(b - a) / T(2), (a + b) / T(2) };
+		for (std::size_t i = 0; i < count; ++i) {
+			intern::grow(sphere, points[i]);
+		}
+		return sphere;
+	}
+	template<typename T>
+	Sphere<T> ritter_sphere(const std::vector<glm::tvec3<T>>& points) noexcept {
+		return ritter_sphere(points.data(), points.size());
+	}
+
+	// Bounding sphere seeded with the widest pair of extremal points along 13 fixed directions, then grown by a Ritter pass to fit the rest.
+	// The seed is much closer to the true diameter than Ritter's, which usually gives a tighter sphere for the same linear cost.
+	template<typename T>
+	Sphere<T> bounding_sphere(const glm::tvec3<T>* points, std::size_t count) noexcept {
+		if (count == 0) {
+			return Sphere<T>{ T(0) };
+		}
+
+		static constexpr int Dirs = 13;
+		const glm::tvec3<T> dirs[Dirs] = {
+			{ T(1), T(0), T(0) }, { T(0), T(1), T(0) }, { T(0), T(0), T(1) },
+			{ T(1), T(1), T(1) }, { T(1), T(1), T(-1) }, { T(1), T(-1), T(1) }, { T(1), T(-1), T(-1) },
+			{ T(1), T(1), T(0) }, { T(1), T(-1), T(0) }, { T(1), T(0), T(1) }, { T(1), T(0), T(-1) },
+			{ T(0), T(1), T(1) }, { T(0), T(1), T(-1) },
+		};
+
+		T lo[Dirs], hi[Dirs];
+		std::size_t loIdx[Dirs], hiIdx[Dirs];
+		for (int k = 0; k < Dirs; ++k) {
+			lo[k] = std::numeric_limits<T>::max();
+			hi[k] = std::numeric_limits<T>::lowest();
+			loIdx[k] = hiIdx[k] = 0;
+		}
+
+		for (std::size_t i = 0; i < count; ++i) {
+			for (int k = 0; k < Dirs; ++k) {
+				T proj = glm::dot(points[i], dirs[k]);
+				if (proj < lo[k]) {
+					lo[k] = proj;
+					loIdx[k] = i;
+				}
+				if (proj > hi[k]) {
+					hi[k] = proj;
+					hiIdx[k] = i;
+				}
+			}
+		}
+
+		// The widest pair among the extremal points.
+		glm::tvec3<T> extremal[Dirs * 2];
+		for (int k = 0; k < Dirs; ++k) {
+			extremal[k * 2 + 0] = points[loIdx[k]];
+			extremal[k * 2 + 1] = points[hiIdx[k]];
+		}
+		glm::tvec3<T> a = extremal[0], b = extremal[1];
+		T widest = T(-1);
+		for (int i = 0; i < Dirs * 2; ++i) {
+			for (int j = i + 1; j < Dirs * 2; ++j) {
+				glm::tvec3<T> d = extremal[j] - extremal[i];
+				T d2 = glm::dot(d, d);
+				if (d2 > widest) {
+					widest = d2;
+					a = extremal[i];
+					b = extremal[j];
+				}
+			}
+		}
+
+		Sphere<T> sphere{ glm::length(b - a) / T(2), (a + b) / T(2) };
+		for (int i = 0; i < Dirs * 2; ++i) {
+			intern::grow(sphere, extremal[i]);
+		}
+		for (std::size_t i = 0; i < count; ++i) {
+			intern::grow(sphere, points[i]);
+		}
+		return sphere;
+	}
+	template<typename T>
+	Sphere<T> bounding_sphere(const std::vector<glm::tvec3<T>>& points) noexcept {
+		return bounding_sphere(points.data(), points.size());
+	}
+
+	// Minimum enclosing circle, Welzl's algorithm in its iterative form.
+	// The points are visited in random order, giving expected linear time. The seed makes the result deterministic.
+	template<typename T>
+	Circle<T> enclosing_circle(const glm::tvec2<T>* points, std::size_t count, unsigned seed = 0x9e3779b9u) {
+		using vec2_t = glm::tvec2<T>;
+		if (count == 0) {
+			return Circle<T>{ T(0) };
+		}
+
+		std::vector<vec2_t> pts(points, points + count);
+		std::shuffle(pts.begin(), pts.end(), std::minstd_rand{ seed });
+
+		// Relative tolerance, prevents rebuilding the circle for points that lie on it.
+		const T tol = T(1) + T(64) * std::numeric_limits<T>::epsilon();
+		auto inside = [tol](const Circle<T>& c, const vec2_t& p) {
+			vec2_t d = p - c.origin;
+			return glm::dot(d, d) <= c.radius * c.radius * tol;
+		};
+		auto diameter = [](const vec2_t& a, const vec2_t& b) {
+			return Circle<T>{ glm::length(b - a) / T(2), (a + b) / T(2) };
+		};
+		auto triangle = [&](const vec2_t& a, const vec2_t& b, const vec2_t& c) {
+			vec2_t ab = b - a, ac = c - a;
+			T cross = ab.x * ac.y - ab.y * ac.x;
+			if (std::abs(cross) <= std::numeric_limits<T>::epsilon() * std::sqrt(glm::dot(ab, ab) * glm::dot(ac, ac))) {
+				// Degenerate, the widest pair is the diameter.
+				Circle<T> c0 = diameter(a, b), c1 = diameter(a, c), c2 = diameter(b, c);
+				if (c1.radius > c0.radius) {
+					c0 = c1;
+				}
+				return c2.radius > c0.radius ? c2 : c0;
+			}
+			return Circle<T>::fromOuterTriangle(a, b, c);
+		};
+
+		Circle<T> circle{ T(0), pts[0] };
+		for (std::size_t i = 1; i < count; ++i) {
+			if (inside(circle, pts[i])) {
+				continue;
+			}
+			circle = Circle<T>{ T(0), pts[i] };
+			for (std::size_t j = 0; j < i; ++j) {
+				if (inside(circle, pts[j])) {
+					continue;
+				}
+				circle = diameter(pts[i], pts[j]);
+				for (std::size_t k = 0; k < j; ++k) {
+					if (!inside(circle, pts[k])) {
+						circle = triangle(pts[i], pts[j], pts[k]);
+					}
+				}
+			}
+		}
+		return circle;
+	}
+	template<typename T>
+	Circle<T> enclosing_circle(const std::vector<glm::tvec2<T>>& points, unsigned seed = 0x9e3779b9u) {
+		return enclosing_circle(points.data(), points.size(), seed);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <glm/vec3.hpp>
+
+#include "Line.hpp"
+
+namespace ez {
+	// The points within radius of a segment, a sphere swept along the segment.
+	template<typename T>
+	struct Capsule {
+		using vec3_t = glm::tvec3<T>;
+		using line_t = Line3<T>;
+
+		Capsule(const line_t& _segment = line_t{}, T _radius = T(1)) noexcept
+			: segment(_segment)
+			, radius(_radius)
+		{}
+		Capsule(const vec3_t& start, const vec3_t& end, T _radius) noexcept
+			: segment(start, end)
+			, radius(_radius)
+		{}
+
+		~Capsule() = default;
+		Capsule(const Capsule&) = default;
+		Capsule(Capsule&&) noexcept = default;
+		Capsule& operator=(const Capsule&) = default;
+		Capsule& operator=(Capsule&&) noexcept = default;
+
+		void translate(const vec3_t& off) noexcept {
+			segment.start += off;
+			segment.end += off;
+		}
+
+		// Direction and length of the segment.
+		vec3_t axis() const noexcept {
+			return segment.end - segment.start;
+		}
+		vec3_t center() const noexcept {
+			return (segment.start + segment.end) * T(0.5);
+		}
+
+		line_t segment;
+		T radius;
+	};
+};
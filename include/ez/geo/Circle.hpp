@@ -54,17 +54,16 @@ namespace ez {
 			origin = loc;
 		}
 
+		// The circumcircle of the triangle, the points must not be collinear.
 		static Circle fromOuterTriangle(const vec2_t& c1, const vec2_t& c2, const vec2_t& c3) {
-			vec2_t H = (c3 + c1) / T(2);
-			vec2_t G = H - c2;
-			H -= c1;
-			T H2 = glm::dot(H, H);
-			T G2 = glm::dot(G, G);
-			vec2_t S = G * (H2 / G2);
-			vec2_t o = S + c2;
-			T r = glm::length(o - c1);
+			vec2_t a = c2 - c1;
+			vec2_t b = c3 - c1;
+			T a2 = glm::dot(a, a);
+			T b2 = glm::dot(b, b);
+			T d = T(2) * (a.x * b.y - a.y * b.x);
 
-			return Circle{ r, o };
+			vec2_t u{ (b.y * a2 - a.y * b2) / d, (a.x * b2 - b.x * a2) / d };
+			return Circle{ glm::length(u), c1 + u };
 		}
 
 		T radius;
@@ -0,0 +1,247 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include <glm/vec2.hpp>
+
+#include "Line.hpp"
+#include "MMRect.hpp"
+#include "SoA.hpp"
+
+/*
+Clipping of segments and polygons to an axis aligned rect.
+Segments use Liang-Barsky, polygons use Sutherland-Hodgman, one pass per side of the rect.
+The rect is closed, points on its boundary are kept. In the scalar functions outcodes give the trivial cases, a segment or
+polygon entirely inside is passed through and one entirely beyond a single side is dropped, without any of the per side work.
+The segment batch functions run the same selects on every segment instead, which costs less than a branch once vectorized.
+
+No function here allocates, the outputs are caller provided. A convex polygon of n vertices clips to at most n + 4 vertices,
+but a concave one can grow much more: a pass keeps the inside vertices and adds two per run of them, so it can turn n vertices
+into n + n / 2. clip_capacity gives the size of buffers that are always large enough.
+*/
+
+namespace ez {
+	namespace intern {
+		enum : std::uint32_t {
+			OutLeft = 1,
+			OutRight = 2,
+			OutBottom = 4,
+			OutTop = 8
+		};
+
+		// The sides of the rect the point lies beyond, zero when the rect contains the point.
+		template<typename T>
+		std::uint32_t outcode(const glm::tvec2<T>& p, const MMRect<T, 2>& rect) noexcept {
+			return
+				(std::uint32_t(p.x < rect.min.x) * OutLeft) |
+				(std::uint32_t(p.x > rect.max.x) * OutRight) |
+				(std::uint32_t(p.y < rect.min.y) * OutBottom) |
+				(std::uint32_t(p.y > rect.max.y) * OutTop);
+		}
+
+		// Liang-Barsky on the parametric segment p0 + t * d, narrows [t0, t1] and returns false when nothing is left.
+		// Written with selects only so the batch loop vectorizes.
+		template<typename T>
+		bool clip_range(T p0x, T p0y, T dx, T dy, const MMRect<T, 2>& rect, T& t0, T& t1) noexcept {
+			const T p[4] = { -dx, dx, -dy, dy };
+			const T q[4] = { p0x - rect.min.x, rect.max.x - p0x, p0y - rect.min.y, rect.max.y - p0y };
+
+			bool keep = true;
+			for (int k = 0; k < 4; ++k) {
+				T r = q[k] / (p[k] == T(0) ? T(1) : p[k]);
+				// A segment parallel to a side is either fully inside its slab or fully outside.
+				keep &= !((p[k] == T(0)) & (q[k] < T(0)));
+				t0 = p[k] < T(0) ? std::max(t0, r) : t0;
+				t1 = p[k] > T(0) ? std::min(t1, r) : t1;
+			}
+			return keep & (t0 <= t1);
+		}
+
+		// One Sutherland-Hodgman pass, keeps the side of the line p[axis] == bound where sign * (p[axis] - bound) >= 0.
+		template<typename T>
+		std::size_t clip_side(const glm::tvec2<T>* in, std::size_t count, int axis, T bound, T sign, glm::tvec2<T>* out) noexcept {
+			using vec2_t = glm::tvec2<T>;
+			std::size_t ret = 0;
+			if (count == 0) {
+				return 0;
+			}
+
+			vec2_t prev = in[count - 1];
+			bool prevIn = sign * (prev[axis] - bound) >= T(0);
+			for (std::size_t i = 0; i < count; ++i) {
+				vec2_t cur = in[i];
+				bool curIn = sign * (cur[axis] - bound) >= T(0);
+				if (curIn != prevIn) {
+					T t = (bound - prev[axis]) / (cur[axis] - prev[axis]);
+					vec2_t hit = prev + (cur - prev) * t;
+					hit[axis] = bound;
+					out[ret++] = hit;
+				}
+				if (curIn) {
+					out[ret++] = cur;
+				}
+				prev = cur;
+				prevIn = curIn;
+			}
+			return ret;
+		}
+	}
+
+	// Vertices the output and scratch buffers of a polygon clip must hold for a polygon of count vertices, concave or not.
+	// Each of the four passes can grow the polygon by half.
+	constexpr std::size_t clip_capacity(std::size_t count) noexcept {
+		for (int k = 0; k < 4; ++k) {
+			count += count / 2;
+		}
+		return count;
+	}
+
+	// Clip the segment to the rect in place, returns false when no part of it lies inside the rect.
+	template<typename T>
+	bool clip(Line2<T>& line, const MMRect<T, 2>& rect) noexcept {
+		std::uint32_t c0 = intern::outcode(line.start, rect), c1 = intern::outcode(line.end, rect);
+		if ((c0 | c1) == 0) {
+			return true;
+		}
+		if ((c0 & c1) != 0) {
+			return false;
+		}
+
+		glm::tvec2<T> p0 = line.start, d = line.end - line.start;
+		T t0 = T(0), t1 = T(1);
+		if (!intern::clip_range(p0.x, p0.y, d.x, d.y, rect, t0, t1)) {
+			return false;
+		}
+		line.start = p0 + d * t0;
+		line.end = p0 + d * t1;
+		return true;
+	}
+
+	// Clip a polygon to the rect, out receives the vertices of the clipped polygon and the count is returned, zero when nothing is left.
+	// Both out and scratch must hold clip_capacity(count) vertices, count + 4 is enough when the polygon is convex.
+	// Convex polygons clip to a single convex polygon, concave ones may produce degenerate edges along the rect where separate pieces are joined.
+	template<typename T>
+	std::size_t clip(const glm::tvec2<T>* in, std::size_t count, const MMRect<T, 2>& rect, glm::tvec2<T>* out, glm::tvec2<T>* scratch) noexcept {
+		std::uint32_t any = 0, all = ~std::uint32_t(0);
+		for (std::size_t i = 0; i < count; ++i) {
+			std::uint32_t code = intern::outcode(in[i], rect);
+			any |= code;
+			all &= code;
+		}
+		if (count == 0 || all != 0) {
+			return 0;
+		}
+		if (any == 0) {
+			std::copy(in, in + count, out);
+			return count;
+		}
+
+		// Only the sides some vertex lies beyond need a pass, ping pong between the buffers so the last pass lands in out.
+		const int axes[4] = { 0, 0, 1, 1 };
+		const T bounds[4] = { rect.min.x, rect.max.x, rect.min.y, rect.max.y };
+		const T signs[4] = { T(1), T(-1), T(1), T(-1) };
+
+		int passes = 0;
+		for (int k = 0; k < 4; ++k) {
+			passes += (any >> k) & 1;
+		}
+
+		const glm::tvec2<T>* src = in;
+		glm::tvec2<T>* dst = passes % 2 == 1 ? out : scratch;
+		for (int k = 0; k < 4 && count != 0; ++k) {
+			if (((any >> k) & 1) == 0) {
+				continue;
+			}
+			count = intern::clip_side(src, count, axes[k], bounds[k], signs[k], dst);
+			src = dst;
+			dst = dst == out ? scratch : out;
+		}
+		if (src != out) {
+			std::copy(src, src + count, out);
+		}
+		return count;
+	}
+
+	// Clip every segment to the rect, out is resized to match and visible[i] is set to 0 for the segments with nothing inside.
+	// The endpoints of invisible segments are left as they were. Out may be the same set as lines.
+	template<typename T>
+	void clip_batch(const LineSoA2<T>& lines, const MMRect<T, 2>& rect, LineSoA2<T>& out, std::uint8_t* visible) {
+		std::size_t count = lines.size();
+		out.resize(count);
+		const T* sx = lines.start.data(0), * sy = lines.start.data(1), * ex = lines.end.data(0), * ey = lines.end.data(1);
+		T* osx = out.start.data(0), * osy = out.start.data(1), * oex = out.end.data(0), * oey = out.end.data(1);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			T x0 = sx[i], y0 = sy[i], dx = ex[i] - x0, dy = ey[i] - y0;
+			T t0 = T(0), t1 = T(1);
+			bool keep = intern::clip_range(x0, y0, dx, dy, rect, t0, t1);
+			// Segments already inside keep their exact endpoints.
+			t0 = keep ? t0 : T(0);
+			t1 = keep ? t1 : T(1);
+			osx[i] = t0 == T(0) ? x0 : x0 + dx * t0;
+			osy[i] = t0 == T(0) ? y0 : y0 + dy * t0;
+			oex[i] = t1 == T(1) ? ex[i] : x0 + dx * t1;
+			oey[i] = t1 == T(1) ? ey[i] : y0 + dy * t1;
+			visible[i] = keep;
+		}
+	}
+
+	// Clip every segment to the rect and keep only the visible ones, out is resized to their count, which is returned.
+	// When source is given it receives the index in lines of each segment of out, it must hold lines.size() elements. Out may be the same set as lines.
+	template<typename T>
+	std::size_t clip_compact(const LineSoA2<T>& lines, const MMRect<T, 2>& rect, LineSoA2<T>& out, std::uint32_t* source = nullptr) {
+		std::size_t count = lines.size();
+		out.resize(count);
+		const T* sx = lines.start.data(0), * sy = lines.start.data(1), * ex = lines.end.data(0), * ey = lines.end.data(1);
+		T* osx = out.start.data(0), * osy = out.start.data(1), * oex = out.end.data(0), * oey = out.end.data(1);
+
+		std::size_t kept = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			T x0 = sx[i], y0 = sy[i], x1 = ex[i], y1 = ey[i], dx = x1 - x0, dy = y1 - y0;
+			T t0 = T(0), t1 = T(1);
+			bool keep = intern::clip_range(x0, y0, dx, dy, rect, t0, t1);
+			osx[kept] = t0 == T(0) ? x0 : x0 + dx * t0;
+			osy[kept] = t0 == T(0) ? y0 : y0 + dy * t0;
+			oex[kept] = t1 == T(1) ? x1 : x0 + dx * t1;
+			oey[kept] = t1 == T(1) ? y1 : y0 + dy * t1;
+			if (source) {
+				source[kept] = static_cast<std::uint32_t>(i);
+			}
+			kept += keep;
+		}
+		out.resize(kept);
+		return kept;
+	}
+
+	// Clip a batch of polygons stored back to back, polygon i has the vertices [offsets[i], offsets[i + 1]) of verts.
+	// The clipped polygons are written the same way to outVerts and outOffsets, empty results are kept as empty polygons
+	// so the indices still match. The vectors keep their capacity between calls, reusing them avoids any allocation.
+	template<typename T>
+	void clip_batch(const glm::tvec2<T>* verts, const std::size_t* offsets, std::size_t polygons, const MMRect<T, 2>& rect,
+		std::vector<glm::tvec2<T>>& outVerts, std::vector<std::size_t>& outOffsets, std::vector<glm::tvec2<T>>& scratch)
+	{
+		std::size_t total = offsets[polygons] - offsets[0], largest = 0;
+		for (std::size_t i = 0; i < polygons; ++i) {
+			largest = std::max(largest, offsets[i + 1] - offsets[i]);
+		}
+		// Sized for the common case of polygons that do not grow much, and grown when one might not fit.
+		outVerts.resize(std::max(outVerts.size(), total + 4 * polygons));
+		outOffsets.resize(polygons + 1);
+		scratch.resize(std::max(scratch.size(), clip_capacity(largest)));
+
+		std::size_t written = 0;
+		outOffsets[0] = 0;
+		for (std::size_t i = 0; i < polygons; ++i) {
+			std::size_t count = offsets[i + 1] - offsets[i];
+			std::size_t need = written + clip_capacity(count);
+			if (outVerts.size() < need) {
+				outVerts.resize(std::max(need, outVerts.size() * 2));
+			}
+			written += clip(verts + offsets[i], count, rect, outVerts.data() + written, scratch.data());
+			outOffsets[i + 1] = written;
+		}
+		outVerts.resize(written);
+	}
+};
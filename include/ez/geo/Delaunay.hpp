@@ -0,0 +1,410 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <array>
+#include <vector>
+#include <memory_resource>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <glm/vec2.hpp>
+
+#include "MMRect.hpp"
+#include "Predicates.hpp"
+
+/*
+Incremental 2d Delaunay triangulation.
+Points are inserted in a biased randomized insertion order (BRIO), each round sorted along a hilbert curve, so consecutive points are close together.
+Each point is located by walking from the last triangle created, then inserted by Bowyer-Watson: the triangles whose circumcircle contains the point are removed
+and the cavity is filled with triangles fanning out from the new point.
+The convex hull is closed off with ghost triangles sharing a vertex at infinity, so points outside the current hull need no special handling.
+All decisions use the robust predicates from Predicates.hpp.
+
+The result uses a compact half edge layout: triangle t has the vertices triangles()[3t + 0..2] in counterclockwise order,
+half edge e runs from triangles()[e] to triangles()[next(e)], and halfedges()[e] is the opposite half edge in the neighbouring triangle, or Invalid on the hull.
+*/
+
+namespace ez {
+	namespace intern {
+		// Position of a point along a hilbert curve filling a 65536 x 65536 grid.
+		inline std::uint32_t hilbert_index(std::uint32_t x, std::uint32_t y) noexcept {
+			std::uint32_t d = 0;
+			for (std::uint32_t s = 1u << 15; s > 0; s >>= 1) {
+				std::uint32_t rx = (x & s) ? 1 : 0;
+				std::uint32_t ry = (y & s) ? 1 : 0;
+				d += s * s * ((3 * rx) ^ ry);
+				if (ry == 0) {
+					if (rx == 1) {
+						x = 0xFFFF - x;
+						y = 0xFFFF - y;
+					}
+					std::swap(x, y);
+				}
+			}
+			return d;
+		}
+
+		// Biased randomized insertion order: the points are shuffled, split into rounds that double in size, and each round is sorted along a hilbert curve.
+		// Keys is scratch, both vectors are resized to count.
+		template<typename T, typename V>
+		void brio_order(const glm::tvec2<T>* points, std::size_t count, std::uint32_t seed, V& order, V& keys) {
+			order.resize(count);
+			std::iota(order.begin(), order.end(), std::uint32_t(0));
+			if (count == 0) {
+				return;
+			}
+			std::shuffle(order.begin(), order.end(), std::minstd_rand{ seed });
+
+			MMRect<T, 2> domain{ points[0], points[0] };
+			for (std::size_t i = 1; i < count; ++i) {
+				domain.min = glm::min(domain.min, points[i]);
+				domain.max = glm::max(domain.max, points[i]);
+			}
+			glm::tvec2<T> scale = domain.max - domain.min;
+			for (int i = 0; i < 2; ++i) {
+				scale[i] = scale[i] > T(0) ? T(65535) / scale[i] : T(0);
+			}
+
+			keys.resize(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				glm::tvec2<T> p = (points[i] - domain.min) * scale;
+				keys[i] = hilbert_index(static_cast<std::uint32_t>(p.x), static_cast<std::uint32_t>(p.y));
+			}
+
+			auto by_key = [&keys](std::uint32_t a, std::uint32_t b) {
+				return keys[a] < keys[b];
+			};
+			std::size_t end = count;
+			while (end > 0) {
+				std::size_t begin = end > 256 ? end / 2 : 0;
+				std::sort(order.begin() + begin, order.begin() + end, by_key);
+				end = begin;
+			}
+		}
+	}
+
+	template<typename T>
+	class Delaunay2 {
+	public:
+		using vec2_t = glm::tvec2<T>;
+		static constexpr std::uint32_t Invalid = std::numeric_limits<std::uint32_t>::max();
+
+		// The result and the working state are allocated from the resource.
+		explicit Delaunay2(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: tris(resource)
+			, twins(resource)
+			, order(resource)
+			, keys(resource)
+			, links(resource)
+			, stamps(resource)
+			, cavity(resource)
+			, boundary(resource)
+			, created(resource)
+			, rim(resource)
+		{}
+		Delaunay2(const vec2_t* points, std::size_t count, std::uint32_t seed = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Delaunay2(resource)
+		{
+			build(points, count, seed);
+		}
+		Delaunay2(const std::vector<vec2_t>& points, std::uint32_t seed = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Delaunay2(resource)
+		{
+			build(points.data(), points.size(), seed);
+		}
+
+		~Delaunay2() = default;
+		Delaunay2(const Delaunay2&) = default;
+		Delaunay2(Delaunay2&&) noexcept = default;
+		Delaunay2& operator=(const Delaunay2&) = default;
+		Delaunay2& operator=(Delaunay2&&) = default;
+
+		// Triangulate the points, replacing any previous result. Duplicate points are skipped.
+		// Returns false when there are fewer than three distinct points or they are all collinear, leaving the triangulation empty.
+		// The working state keeps its capacity, so rebuilding with no more points than before does not allocate.
+		bool build(const vec2_t* points, std::size_t count, std::uint32_t seed = 0) {
+			tris.clear();
+			twins.clear();
+			pts = points;
+
+			intern::brio_order(points, count, seed, order, keys);
+			if (!start(order)) {
+				return false;
+			}
+
+			links.assign(count + 1, Invalid);
+			stamps.assign(tris.size() / 3, 0);
+			stamp = 0;
+
+			for (std::uint32_t v : order) {
+				if (v != first[0] && v != first[1] && v != first[2]) {
+					insert(v);
+				}
+			}
+
+			finish();
+			return true;
+		}
+
+		std::size_t size() const noexcept {
+			return tris.size() / 3;
+		}
+		bool empty() const noexcept {
+			return tris.empty();
+		}
+
+		const std::pmr::vector<std::uint32_t>& triangles() const noexcept {
+			return tris;
+		}
+		const std::pmr::vector<std::uint32_t>& halfedges() const noexcept {
+			return twins;
+		}
+		std::pmr::memory_resource* resource() const noexcept {
+			return tris.get_allocator().resource();
+		}
+
+		static std::uint32_t next(std::uint32_t edge) noexcept {
+			return (edge % 3 == 2) ? edge - 2 : edge + 1;
+		}
+		static std::uint32_t prev(std::uint32_t edge) noexcept {
+			return (edge % 3 == 0) ? edge + 2 : edge - 1;
+		}
+	private:
+		// The vertex at infinity shared by the ghost triangles.
+		static constexpr std::uint32_t Ghost = Invalid;
+
+		struct RimEdge {
+			std::uint32_t u, w, twin;
+		};
+
+		bool is_ghost(std::uint32_t t) const noexcept {
+			return tris[3 * t] == Ghost || tris[3 * t + 1] == Ghost || tris[3 * t + 2] == Ghost;
+		}
+		std::uint32_t link_slot(std::uint32_t v) const noexcept {
+			return v == Ghost ? std::uint32_t(links.size() - 1) : v;
+		}
+
+		void set_twins(std::uint32_t a, std::uint32_t b) noexcept {
+			twins[a] = b;
+			twins[b] = a;
+		}
+
+		// Create the first triangle from the first three points in order that are not collinear, along with the three ghost triangles around it.
+		bool start(const std::pmr::vector<std::uint32_t>& order) {
+			std::size_t count = order.size();
+			if (count < 3) {
+				return false;
+			}
+			std::size_t i = 1;
+			while (i < count && pts[order[i]] == pts[order[0]]) {
+				++i;
+			}
+			std::size_t j = i + 1;
+			while (j < count && orient2d(pts[order[0]], pts[order[i]], pts[order[j]]) == 0.0) {
+				++j;
+			}
+			if (j >= count) {
+				return false;
+			}
+
+			std::uint32_t a = order[0], b = order[i], c = order[j];
+			if (orient2d(pts[a], pts[b], pts[c]) < 0.0) {
+				std::swap(b, c);
+			}
+			first = { a, b, c };
+
+			tris = {
+				a, b, c,
+				b, a, Ghost,
+				c, b, Ghost,
+				a, c, Ghost
+			};
+			twins.assign(12, Invalid);
+			set_twins(0, 3);
+			set_twins(1, 6);
+			set_twins(2, 9);
+			set_twins(4, 11);
+			set_twins(5, 7);
+			set_twins(8, 10);
+			last = 0;
+			return true;
+		}
+
+		// Find a triangle containing the point, either a real triangle or a ghost triangle whose hull edge faces it.
+		std::uint32_t locate(const vec2_t& p) noexcept {
+			std::uint32_t t = last;
+			std::uint32_t rot = 0;
+			for (;;) {
+				if (is_ghost(t)) {
+					return t;
+				}
+				bool moved = false;
+				for (std::uint32_t k = 0; k < 3; ++k) {
+					// Rotating the first edge tested keeps the walk from cycling.
+					std::uint32_t e = 3 * t + (k + rot) % 3;
+					if (orient2d(pts[tris[e]], pts[tris[next(e)]], p) < 0.0) {
+						t = twins[e] / 3;
+						moved = true;
+						break;
+					}
+				}
+				if (!moved) {
+					return t;
+				}
+				rot = (rot + 1) % 3;
+			}
+		}
+
+		// A ghost triangle with the hull edge u v conflicts with points strictly outside the edge, or on the open segment itself.
+		bool ghost_conflict(std::uint32_t u, std::uint32_t v, const vec2_t& p) const {
+			double o = orient2d(pts[u], pts[v], p);
+			if (o != 0.0) {
+				return o > 0.0;
+			}
+			const vec2_t& pu = pts[u];
+			const vec2_t& pv = pts[v];
+			return glm::dot(p - pu, pv - pu) > T(0) && glm::dot(p - pv, pu - pv) > T(0);
+		}
+
+		bool conflict(std::uint32_t t, const vec2_t& p) const {
+			std::uint32_t a = tris[3 * t], b = tris[3 * t + 1], c = tris[3 * t + 2];
+			if (c == Ghost) {
+				return ghost_conflict(a, b, p);
+			}
+			if (a == Ghost) {
+				return ghost_conflict(b, c, p);
+			}
+			if (b == Ghost) {
+				return ghost_conflict(c, a, p);
+			}
+			return incircle(pts[a], pts[b], pts[c], p) > 0.0;
+		}
+
+		void insert(std::uint32_t v) {
+			const vec2_t& p = pts[v];
+			std::uint32_t t = locate(p);
+			if (!is_ghost(t)) {
+				for (std::uint32_t k = 0; k < 3; ++k) {
+					if (pts[tris[3 * t + k]] == p) {
+						return;
+					}
+				}
+			}
+
+			// Gather the cavity, stamps mark triangles as inside (stamp) or rejected (stamp + 1) for this insertion.
+			stamp += 2;
+			const std::uint32_t in = stamp, out = stamp + 1;
+			cavity.clear();
+			boundary.clear();
+			cavity.push_back(t);
+			stamps[t] = in;
+			for (std::size_t i = 0; i < cavity.size(); ++i) {
+				std::uint32_t ct = cavity[i];
+				for (std::uint32_t k = 0; k < 3; ++k) {
+					std::uint32_t e = 3 * ct + k;
+					std::uint32_t n = twins[e] / 3;
+					if (stamps[n] == in) {
+						continue;
+					}
+					if (stamps[n] != out && conflict(n, p)) {
+						stamps[n] = in;
+						cavity.push_back(n);
+					}
+					else {
+						stamps[n] = out;
+						boundary.push_back(e);
+					}
+				}
+			}
+
+			// Read the boundary before any triangle is overwritten, the edges live in the cavity triangles being replaced.
+			rim.clear();
+			for (std::uint32_t e : boundary) {
+				rim.push_back(RimEdge{ tris[e], tris[next(e)], twins[e] });
+			}
+
+			// Fill the cavity with a fan of triangles around the new point, reusing the freed slots first.
+			// Each boundary edge u w becomes the triangle u w p.
+			created.clear();
+			for (std::size_t i = 0; i < rim.size(); ++i) {
+				const RimEdge& edge = rim[i];
+
+				std::uint32_t s;
+				if (i < cavity.size()) {
+					s = cavity[i];
+				}
+				else {
+					s = std::uint32_t(tris.size() / 3);
+					tris.resize(tris.size() + 3);
+					twins.resize(twins.size() + 3);
+					stamps.push_back(0);
+				}
+
+				tris[3 * s] = edge.u;
+				tris[3 * s + 1] = edge.w;
+				tris[3 * s + 2] = v;
+				set_twins(3 * s, edge.twin);
+				links[link_slot(edge.u)] = s;
+				created.push_back(s);
+			}
+
+			// Stitch the fan together, the edge w p of one triangle pairs with the edge p w of the triangle starting at w.
+			for (std::uint32_t s : created) {
+				std::uint32_t w = tris[3 * s + 1];
+				set_twins(3 * s + 1, 3 * links[link_slot(w)] + 2);
+				if (tris[3 * s] != Ghost && w != Ghost) {
+					last = s;
+				}
+			}
+		}
+
+		// Drop the ghost triangles and renumber in place, hull edges get Invalid twins.
+		void finish() {
+			std::size_t count = tris.size() / 3;
+			std::pmr::vector<std::uint32_t>& remap = keys;
+			remap.assign(count, Invalid);
+			std::uint32_t kept = 0;
+			for (std::size_t t = 0; t < count; ++t) {
+				if (!is_ghost(std::uint32_t(t))) {
+					remap[t] = kept++;
+				}
+			}
+
+			// A triangle only ever moves down, so it never overwrites one not yet moved.
+			for (std::size_t t = 0; t < count; ++t) {
+				std::uint32_t r = remap[t];
+				if (r == Invalid) {
+					continue;
+				}
+				for (std::uint32_t k = 0; k < 3; ++k) {
+					std::uint32_t e = twins[3 * t + k];
+					std::uint32_t n = remap[e / 3];
+					tris[3 * r + k] = tris[3 * t + k];
+					twins[3 * r + k] = n == Invalid ? Invalid : 3 * n + e % 3;
+				}
+			}
+
+			tris.resize(std::size_t(kept) * 3);
+			twins.resize(std::size_t(kept) * 3);
+
+			links.clear();
+			stamps.clear();
+			cavity.clear();
+			boundary.clear();
+			created.clear();
+			rim.clear();
+			pts = nullptr;
+		}
+
+		std::pmr::vector<std::uint32_t> tris, twins;
+
+		// Working state used while building, kept between builds to reuse the memory.
+		const vec2_t* pts = nullptr;
+		std::pmr::vector<std::uint32_t> order, keys;
+		std::pmr::vector<std::uint32_t> links, stamps, cavity, boundary, created;
+		std::pmr::vector<RimEdge> rim;
+		std::array<std::uint32_t, 3> first{ Invalid, Invalid, Invalid };
+		std::uint32_t last = 0, stamp = 0;
+	};
+};
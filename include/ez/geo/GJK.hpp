@@ -0,0 +1,566 @@
+#pragma once
+#include <cmath>
+#include <array>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <glm/geometric.hpp>
+
+#include "Support.hpp"
+
+/*
+Gilbert-Johnson-Keerthi distance and the Expanding Polytope Algorithm for penetration depth.
+Both operate on the minkowski difference A - B through the support functions in Support.hpp, so any pair of convex shapes can be tested.
+*/
+
+namespace ez {
+	template<typename T>
+	struct GJKVertex {
+		using vec3_t = glm::tvec3<T>;
+
+		// Support points on A and B, their difference, and the search direction that produced them.
+		vec3_t a, b, w, dir;
+	};
+
+	/*
+	The simplex is the state carried between calls.
+	Pass the simplex from the previous frame to warm start a coherent pair, the support points are recomputed from the stored search directions.
+	A default constructed simplex starts from scratch.
+	*/
+	template<typename T>
+	struct GJKSimplex {
+		void clear() noexcept {
+			count = 0;
+		}
+
+		std::array<GJKVertex<T>, 4> verts;
+		int count = 0;
+	};
+
+	template<typename T>
+	struct GJKResult {
+		using vec3_t = glm::tvec3<T>;
+
+		bool overlap;
+		// Zero when overlapping.
+		T distance;
+		// The closest points on A and B. Only meaningful when not overlapping.
+		vec3_t pointA, pointB;
+		int iterations;
+	};
+
+	template<typename T>
+	struct Penetration {
+		using vec3_t = glm::tvec3<T>;
+
+		// Unit vector pointing from A toward B, moving B by normal * depth separates the shapes.
+		vec3_t normal;
+		T depth;
+		// The deepest points of A inside B and of B inside A.
+		vec3_t pointA, pointB;
+	};
+
+	namespace intern {
+		template<typename T>
+		struct EPAFace {
+			int i[3];
+			glm::tvec3<T> n;
+			T d;
+		};
+		struct EPAEdge {
+			int a, b;
+		};
+	}
+
+	// Working memory of epa. Keeping one between calls reuses its buffers, so the polytopes of a narrowphase do not allocate.
+	template<typename T>
+	struct EPAScratch {
+		std::vector<GJKVertex<T>> verts;
+		std::vector<intern::EPAFace<T>> faces;
+		std::vector<intern::EPAEdge> horizon;
+	};
+
+	namespace intern {
+		template<typename V>
+		struct vec_value {};
+		template<glm::length_t L, typename T, glm::qualifier Q>
+		struct vec_value<glm::vec<L, T, Q>> {
+			using type = T;
+		};
+
+		// Whether support(shape, dir) is valid for directions of type glm::tvec3<D>, and the value type of the points it returns.
+		template<typename S, typename D, typename = void>
+		struct support_probe {
+			static constexpr bool valid = false;
+		};
+		template<typename S, typename D>
+		struct support_probe<S, D, std::void_t<decltype(support(std::declval<const S&>(), std::declval<const glm::tvec3<D>&>()))>> {
+			static constexpr bool valid = true;
+			using type = typename vec_value<std::decay_t<decltype(support(std::declval<const S&>(), std::declval<const glm::tvec3<D>&>()))>>::type;
+		};
+
+		// The value type of the shape, probed with float directions then double ones. No type when the shape has no support function.
+		template<typename S, bool Float = support_probe<S, float>::valid, bool Double = support_probe<S, double>::valid>
+		struct support_value {};
+		template<typename S, bool Double>
+		struct support_value<S, true, Double> {
+			using type = typename support_probe<S, float>::type;
+		};
+		template<typename S>
+		struct support_value<S, false, true> {
+			using type = typename support_probe<S, double>::type;
+		};
+
+		// The value type gjk works in for a pair of shapes, the overloads using it drop out for types without a support function.
+		template<typename A, typename B>
+		using gjk_value_t = std::common_type_t<typename support_value<A>::type, typename support_value<B>::type>;
+
+		template<typename T>
+		T gjk_tolerance() noexcept {
+			return std::sqrt(std::numeric_limits<T>::epsilon());
+		}
+
+		template<typename T, typename A, typename B>
+		void gjk_vertex(const A& a, const B& b, const glm::tvec3<T>& dir, GJKVertex<T>& vert) noexcept {
+			vert.dir = dir;
+			vert.a = support(a, dir);
+			vert.b = support(b, -dir);
+			vert.w = vert.a - vert.b;
+		}
+
+		// Closest point to the origin on a triangle, with barycentric weights. From Ericson, Real-Time Collision Detection 5.1.5.
+		template<typename T>
+		glm::tvec3<T> closest_triangle(const glm::tvec3<T>& a, const glm::tvec3<T>& b, const glm::tvec3<T>& c, T (&bary)[3]) noexcept {
+			glm::tvec3<T> ab = b - a, ac = c - a;
+
+			T d1 = -glm::dot(ab, a), d2 = -glm::dot(ac, a);
+			if (d1 <= T(0) && d2 <= T(0)) {
+				bary[0] = T(1); bary[1] = T(0); bary[2] = T(0);
+				return a;
+			}
+
+			T d3 = -glm::dot(ab, b), d4 = -glm::dot(ac, b);
+			if (d3 >= T(0) && d4 <= d3) {
+				bary[0] = T(0); bary[1] = T(1); bary[2] = T(0);
+				return b;
+			}
+
+			T vc = d1 * d4 - d3 * d2;
+			if (vc <= T(0) && d1 >= T(0) && d3 <= T(0)) {
+				T v = d1 / (d1 - d3);
+				bary[0] = T(1) - v; bary[1] = v; bary[2] = T(0);
+				return a + ab * v;
+			}
+
+			T d5 = -glm::dot(ab, c), d6 = -glm::dot(ac, c);
+			if (d6 >= T(0) && d5 <= d6) {
+				bary[0] = T(0); bary[1] = T(0); bary[2] = T(1);
+				return c;
+			}
+
+			T vb = d5 * d2 - d1 * d6;
+			if (vb <= T(0) && d2 >= T(0) && d6 <= T(0)) {
+				T w = d2 / (d2 - d6);
+				bary[0] = T(1) - w; bary[1] = T(0); bary[2] = w;
+				return a + ac * w;
+			}
+
+			T va = d3 * d6 - d5 * d4;
+			if (va <= T(0) && (d4 - d3) >= T(0) && (d5 - d6) >= T(0)) {
+				T w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+				bary[0] = T(0); bary[1] = T(1) - w; bary[2] = w;
+				return b + (c - b) * w;
+			}
+
+			T sum = va + vb + vc;
+			if (!(sum > T(0))) {
+				// Degenerate triangle, every region test failed on a zero area. Fall back to the closest edge.
+				T e0[3], e1[3], e2[3];
+				glm::tvec3<T> p0 = closest_triangle(a, b, b, e0);
+				glm::tvec3<T> p1 = closest_triangle(a, c, c, e1);
+				glm::tvec3<T> p2 = closest_triangle(b, c, c, e2);
+				T l0 = glm::dot(p0, p0), l1 = glm::dot(p1, p1), l2 = glm::dot(p2, p2);
+				if (l0 <= l1 && l0 <= l2) {
+					bary[0] = e0[0]; bary[1] = e0[1] + e0[2]; bary[2] = T(0);
+					return p0;
+				}
+				if (l1 <= l2) {
+					bary[0] = e1[0]; bary[1] = T(0); bary[2] = e1[1] + e1[2];
+					return p1;
+				}
+				bary[0] = T(0); bary[1] = e2[0]; bary[2] = e2[1] + e2[2];
+				return p2;
+			}
+
+			T denom = T(1) / sum;
+			T v = vb * denom, w = vc * denom;
+			bary[0] = T(1) - v - w; bary[1] = v; bary[2] = w;
+			return a + ab * v + ac * w;
+		}
+
+		// Find the point of the simplex closest to the origin, then drop the vertices that do not contribute to it.
+		// Returns the closest point, bary receives the weights of the remaining vertices.
+		// A simplex left with four vertices contains the origin.
+		template<typename T>
+		glm::tvec3<T> gjk_closest(GJKSimplex<T>& simplex, T (&bary)[4]) noexcept {
+			using vec3_t = glm::tvec3<T>;
+			auto& v = simplex.verts;
+
+			vec3_t closest;
+			switch (simplex.count) {
+			case 1:
+				bary[0] = T(1);
+				return v[0].w;
+			case 2: {
+				T tri[3];
+				closest = closest_triangle(v[0].w, v[1].w, v[1].w, tri);
+				bary[0] = tri[0];
+				bary[1] = tri[1] + tri[2];
+				break;
+			}
+			case 3: {
+				T tri[3];
+				closest = closest_triangle(v[0].w, v[1].w, v[2].w, tri);
+				bary[0] = tri[0];
+				bary[1] = tri[1];
+				bary[2] = tri[2];
+				break;
+			}
+			default: {
+				// The origin is outside a face when it lies on the opposite side of the face from the fourth vertex.
+				static constexpr int faces[4][4] = { {0, 1, 2, 3}, {0, 3, 1, 2}, {0, 2, 3, 1}, {1, 3, 2, 0} };
+
+				T best = std::numeric_limits<T>::max();
+				bool inside = true;
+				for (const auto& f : faces) {
+					const vec3_t& a = v[f[0]].w;
+					vec3_t n = glm::cross(v[f[1]].w - a, v[f[2]].w - a);
+					T signOrigin = -glm::dot(n, a);
+					T signOpposite = glm::dot(n, v[f[3]].w - a);
+
+					// A flat tetrahedron can not contain the origin, every face is a candidate.
+					if (signOrigin * signOpposite < T(0) || std::abs(signOpposite) <= std::numeric_limits<T>::epsilon() * glm::dot(n, n)) {
+						inside = false;
+
+						T tri[3];
+						vec3_t p = closest_triangle(a, v[f[1]].w, v[f[2]].w, tri);
+						T dist = glm::dot(p, p);
+						if (dist < best) {
+							best = dist;
+							closest = p;
+							bary[f[0]] = tri[0];
+							bary[f[1]] = tri[1];
+							bary[f[2]] = tri[2];
+							bary[f[3]] = T(0);
+						}
+					}
+				}
+
+				if (inside) {
+					return vec3_t{ T(0) };
+				}
+				break;
+			}
+			}
+
+			// Compact the vertices with a non-zero weight.
+			int count = 0;
+			for (int i = 0; i < simplex.count; ++i) {
+				if (bary[i] > T(0)) {
+					v[count] = v[i];
+					bary[count] = bary[i];
+					++count;
+				}
+			}
+			if (count == 0) {
+				count = 1;
+				bary[0] = T(1);
+			}
+			simplex.count = count;
+			return closest;
+		}
+	}
+
+	/*
+	Closest points between two convex shapes, or whether they overlap.
+	The simplex is both input and output, see GJKSimplex. Warm started coherent pairs typically converge in one or two iterations.
+	*/
+	template<typename A, typename B, typename T>
+	GJKResult<T> gjk(const A& a, const B& b, GJKSimplex<T>& simplex, int maxIterations = 32) noexcept {
+		using vec3_t = glm::tvec3<T>;
+		const T tol = intern::gjk_tolerance<T>();
+
+		T bary[4];
+		vec3_t v;
+		if (simplex.count > 0) {
+			for (int i = 0; i < simplex.count; ++i) {
+				intern::gjk_vertex(a, b, simplex.verts[i].dir, simplex.verts[i]);
+			}
+			v = intern::gjk_closest(simplex, bary);
+		}
+		else {
+			intern::gjk_vertex(a, b, vec3_t{ T(1), T(0), T(0) }, simplex.verts[0]);
+			simplex.count = 1;
+			bary[0] = T(1);
+			v = simplex.verts[0].w;
+		}
+
+		GJKResult<T> result;
+		result.overlap = false;
+		result.iterations = 0;
+
+		while (result.iterations < maxIterations) {
+			T vv = glm::dot(v, v);
+
+			T scale = T(0);
+			for (int i = 0; i < simplex.count; ++i) {
+				scale = std::max(scale, glm::dot(simplex.verts[i].w, simplex.verts[i].w));
+			}
+			if (simplex.count == 4 || vv <= tol * tol * scale) {
+				result.overlap = true;
+				break;
+			}
+
+			++result.iterations;
+
+			GJKVertex<T> next;
+			intern::gjk_vertex(a, b, -v, next);
+
+			// No support point gets meaningfully closer to the origin, v is the closest point.
+			if (vv - glm::dot(v, next.w) <= tol * vv) {
+				break;
+			}
+
+			simplex.verts[simplex.count++] = next;
+			vec3_t closer = intern::gjk_closest(simplex, bary);
+
+			// Numerical stall, the new simplex is no closer.
+			if (glm::dot(closer, closer) >= vv) {
+				v = closer;
+				break;
+			}
+			v = closer;
+		}
+
+		if (result.overlap) {
+			result.distance = T(0);
+			result.pointA = result.pointB = vec3_t{ T(0) };
+		}
+		else {
+			result.pointA = vec3_t{ T(0) };
+			result.pointB = vec3_t{ T(0) };
+			for (int i = 0; i < simplex.count; ++i) {
+				result.pointA += simplex.verts[i].a * bary[i];
+				result.pointB += simplex.verts[i].b * bary[i];
+			}
+			result.distance = glm::length(v);
+		}
+		return result;
+	}
+
+	// The value type is the one of the support points of the shapes.
+	template<typename A, typename B, typename T = intern::gjk_value_t<A, B>>
+	GJKResult<T> gjk(const A& a, const B& b, int maxIterations = 32) noexcept {
+		GJKSimplex<T> simplex;
+		return gjk(a, b, simplex, maxIterations);
+	}
+
+	template<typename A, typename B, typename T = intern::gjk_value_t<A, B>>
+	bool gjk_overlap(const A& a, const B& b) noexcept {
+		return gjk(a, b).overlap;
+	}
+
+	template<typename A, typename B, typename T = intern::gjk_value_t<A, B>>
+	T gjk_distance(const A& a, const B& b) noexcept {
+		return gjk(a, b).distance;
+	}
+
+	/*
+	Penetration depth of two overlapping shapes, starting from the simplex of a gjk call that reported an overlap.
+	Returns false when the polytope could not be built or did not converge, out then holds the best estimate found.
+	The polytope is built in scratch, see EPAScratch.
+	*/
+	template<typename A, typename B, typename T>
+	bool epa(const A& a, const B& b, const GJKSimplex<T>& simplex, Penetration<T>& out, EPAScratch<T>& scratch, int maxIterations = 64) {
+		using vec3_t = glm::tvec3<T>;
+		using Face = intern::EPAFace<T>;
+		using Edge = intern::EPAEdge;
+		const T tol = intern::gjk_tolerance<T>();
+
+		std::vector<GJKVertex<T>>& verts = scratch.verts;
+		verts.assign(simplex.verts.begin(), simplex.verts.begin() + simplex.count);
+		if (verts.empty()) {
+			verts.emplace_back();
+			intern::gjk_vertex(a, b, vec3_t{ T(1), T(0), T(0) }, verts.back());
+		}
+
+		// Grow a lower dimensional simplex into a tetrahedron.
+		static const vec3_t axes[6] = {
+			vec3_t{ T(1), T(0), T(0) }, vec3_t{ T(-1), T(0), T(0) },
+			vec3_t{ T(0), T(1), T(0) }, vec3_t{ T(0), T(-1), T(0) },
+			vec3_t{ T(0), T(0), T(1) }, vec3_t{ T(0), T(0), T(-1) },
+		};
+		while (verts.size() < 4) {
+			bool grown = false;
+			for (int i = 0; i < 6 && !grown; ++i) {
+				vec3_t dir = axes[i];
+				if (verts.size() == 2) {
+					dir = glm::cross(verts[1].w - verts[0].w, axes[i]);
+				}
+				else if (verts.size() == 3) {
+					dir = glm::cross(verts[1].w - verts[0].w, verts[2].w - verts[0].w);
+					if (i & 1) {
+						dir = -dir;
+					}
+				}
+				if (glm::dot(dir, dir) <= T(0)) {
+					continue;
+				}
+
+				GJKVertex<T> next;
+				intern::gjk_vertex(a, b, dir, next);
+
+				// Accept the vertex only if it adds a dimension.
+				T measure;
+				if (verts.size() == 1) {
+					vec3_t d = next.w - verts[0].w;
+					measure = glm::dot(d, d);
+				}
+				else if (verts.size() == 2) {
+					vec3_t c = glm::cross(verts[1].w - verts[0].w, next.w - verts[0].w);
+					measure = glm::dot(c, c);
+				}
+				else {
+					measure = std::abs(glm::dot(glm::cross(verts[1].w - verts[0].w, verts[2].w - verts[0].w), next.w - verts[0].w));
+				}
+				if (measure > tol * tol) {
+					verts.push_back(next);
+					grown = true;
+				}
+			}
+			if (!grown) {
+				// The minkowski difference is flat, the shapes are only touching.
+				out.normal = vec3_t{ T(1), T(0), T(0) };
+				out.depth = T(0);
+				out.pointA = out.pointB = verts[0].a;
+				return false;
+			}
+		}
+
+		std::vector<Face>& faces = scratch.faces;
+		std::vector<Edge>& horizon = scratch.horizon;
+		faces.clear();
+
+		// A face without area has no normal, its distance of zero would always make it the closest, so it is left out.
+		auto addFace = [&](int i0, int i1, int i2) {
+			Face f{ {i0, i1, i2}, vec3_t{ T(0) }, T(0) };
+			f.n = glm::cross(verts[i1].w - verts[i0].w, verts[i2].w - verts[i0].w);
+			T len = glm::length(f.n);
+			if (!(len > T(0))) {
+				return;
+			}
+			f.n /= len;
+			f.d = glm::dot(f.n, verts[i0].w);
+			faces.push_back(f);
+		};
+		auto closestFace = [&]() {
+			std::size_t best = 0;
+			for (std::size_t i = 1; i < faces.size(); ++i) {
+				if (faces[i].d < faces[best].d) {
+					best = i;
+				}
+			}
+			return faces[best];
+		};
+
+		// Orient the tetrahedron so the faces wind outward.
+		if (glm::dot(glm::cross(verts[1].w - verts[0].w, verts[2].w - verts[0].w), verts[3].w - verts[0].w) > T(0)) {
+			std::swap(verts[1], verts[2]);
+		}
+		addFace(0, 1, 2);
+		addFace(0, 3, 1);
+		addFace(0, 2, 3);
+		addFace(1, 3, 2);
+		if (faces.empty()) {
+			out.normal = vec3_t{ T(1), T(0), T(0) };
+			out.depth = T(0);
+			out.pointA = out.pointB = verts[0].a;
+			return false;
+		}
+
+		Face closest = faces[0];
+		bool converged = false;
+		for (int iter = 0; iter < maxIterations; ++iter) {
+			closest = closestFace();
+
+			GJKVertex<T> next;
+			intern::gjk_vertex(a, b, closest.n, next);
+			if (glm::dot(next.w, closest.n) - closest.d <= tol * std::max(T(1), closest.d)) {
+				converged = true;
+				break;
+			}
+
+			// Remove every face the new vertex can see, keeping the boundary of the hole.
+			int index = static_cast<int>(verts.size());
+			verts.push_back(next);
+			horizon.clear();
+			for (std::size_t i = 0; i < faces.size();) {
+				const Face& f = faces[i];
+				if (glm::dot(f.n, next.w - verts[f.i[0]].w) > T(0)) {
+					for (int e = 0; e < 3; ++e) {
+						Edge edge{ f.i[e], f.i[(e + 1) % 3] };
+						// An edge shared by two removed faces is interior to the hole.
+						auto shared = std::find_if(horizon.begin(), horizon.end(), [&](const Edge& other) {
+							return other.a == edge.b && other.b == edge.a;
+						});
+						if (shared != horizon.end()) {
+							*shared = horizon.back();
+							horizon.pop_back();
+						}
+						else {
+							horizon.push_back(edge);
+						}
+					}
+					faces[i] = faces.back();
+					faces.pop_back();
+				}
+				else {
+					++i;
+				}
+			}
+
+			for (const Edge& edge : horizon) {
+				addFace(edge.a, edge.b, index);
+			}
+			if (faces.empty()) {
+				break;
+			}
+		}
+
+		// When the polytope could not be closed again the last closest face is the best estimate.
+		if (!faces.empty()) {
+			closest = closestFace();
+		}
+		const Face& f = closest;
+
+		// Contact points from the barycentric weights of the origin projected onto the closest face.
+		T bary[3];
+		const GJKVertex<T>& v0 = verts[f.i[0]];
+		const GJKVertex<T>& v1 = verts[f.i[1]];
+		const GJKVertex<T>& v2 = verts[f.i[2]];
+		intern::closest_triangle(v0.w - f.n * f.d, v1.w - f.n * f.d, v2.w - f.n * f.d, bary);
+
+		out.normal = f.n;
+		out.depth = f.d;
+		out.pointA = v0.a * bary[0] + v1.a * bary[1] + v2.a * bary[2];
+		out.pointB = v0.b * bary[0] + v1.b * bary[1] + v2.b * bary[2];
+		return converged;
+	}
+	template<typename A, typename B, typename T>
+	bool epa(const A& a, const B& b, const GJKSimplex<T>& simplex, Penetration<T>& out, int maxIterations = 64) {
+		EPAScratch<T> scratch;
+		return epa(a, b, simplex, out, scratch, maxIterations);
+	}
+};
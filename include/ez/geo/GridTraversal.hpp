@@ -0,0 +1,216 @@
+#pragma once
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <glm/vec3.hpp>
+
+#include "MMRect.hpp"
+#include "Ray.hpp"
+#include "Intersect.hpp"
+#include "Stats.hpp"
+
+/*
+Exact ray traversal of a uniform voxel grid, from Amanatides and Woo, "A Fast Voxel Traversal Algorithm for Ray Tracing".
+The grid covers an MMRect3 domain split into dims cells along each axis, cells are addressed by integer coordinates in [0, dims).
+Every cell the ray passes through is visited once, in order along the ray, with the t interval the ray spends inside it.
+*/
+
+namespace ez {
+	template<typename T>
+	class GridTraversal {
+	public:
+		using vec3_t = glm::tvec3<T>;
+		using rect_t = MMRect<T, 3>;
+
+		// Walk the cells crossed by the ray between tmin and tmax, clipped to the domain.
+		GridTraversal(const Ray3<T>& ray, const rect_t& domain, const glm::ivec3& _dims, T tmin = T(0), T tmax = std::numeric_limits<T>::max()) noexcept
+			: dims(_dims)
+			, axisEntered(-1)
+		{
+			T lo, hi;
+			intern::ray_slabs(ray.origin, T(1) / ray.axis, domain.min, domain.max, lo, hi);
+			t0 = std::max(lo, tmin);
+			tend = std::min(hi, tmax);
+
+			live = t0 < tend && dims.x > 0 && dims.y > 0 && dims.z > 0;
+			if (!live) {
+				t1 = t0;
+				return;
+			}
+
+			vec3_t size = (domain.max - domain.min) / vec3_t(dims);
+			vec3_t start = ray.eval(t0);
+			for (int i = 0; i < 3; ++i) {
+				// The entry point can land on the far side of a boundary through rounding, clamp it back into the grid.
+				int c = static_cast<int>(std::floor((start[i] - domain.min[i]) / size[i]));
+				cell[i] = std::min(std::max(c, 0), dims[i] - 1);
+
+				if (ray.axis[i] > T(0)) {
+					step[i] = 1;
+					tnext[i] = (domain.min[i] + size[i] * T(cell[i] + 1) - ray.origin[i]) / ray.axis[i];
+					tdelta[i] = size[i] / ray.axis[i];
+				}
+				else if (ray.axis[i] < T(0)) {
+					step[i] = -1;
+					tnext[i] = (domain.min[i] + size[i] * T(cell[i]) - ray.origin[i]) / ray.axis[i];
+					tdelta[i] = -size[i] / ray.axis[i];
+				}
+				else {
+					step[i] = 0;
+					tnext[i] = std::numeric_limits<T>::max();
+					tdelta[i] = std::numeric_limits<T>::max();
+				}
+			}
+
+			t1 = std::min(std::min(std::min(tnext.x, tnext.y), tnext.z), tend);
+		}
+
+		// True while the traversal points at a cell.
+		bool valid() const noexcept {
+			return live;
+		}
+		explicit operator bool() const noexcept {
+			return live;
+		}
+
+		// Move to the next cell along the ray.
+		void next() noexcept {
+			int i = 0;
+			if (tnext.y < tnext[i]) {
+				i = 1;
+			}
+			if (tnext.z < tnext[i]) {
+				i = 2;
+			}
+
+			t0 = tnext[i];
+			cell[i] += step[i];
+			tnext[i] += tdelta[i];
+			axisEntered = i;
+
+			if (t0 >= tend || cell[i] < 0 || cell[i] >= dims[i]) {
+				live = false;
+				return;
+			}
+			t1 = std::min(std::min(std::min(tnext.x, tnext.y), tnext.z), tend);
+		}
+
+		const glm::ivec3& current() const noexcept {
+			return cell;
+		}
+		// The ray parameter where the ray enters the current cell.
+		T entry() const noexcept {
+			return t0;
+		}
+		// The ray parameter where the ray leaves the current cell.
+		T exit() const noexcept {
+			return t1;
+		}
+		// The axis whose boundary was crossed to enter the current cell, -1 for the first cell.
+		int axis() const noexcept {
+			return axisEntered;
+		}
+	private:
+		glm::ivec3 dims, cell, step;
+		vec3_t tnext, tdelta;
+		T t0, t1, tend;
+		int axisEntered;
+		bool live;
+	};
+
+	/*
+	Coarse occupancy level for a grid, one flag per cubic block of cells.
+	Blocks that are never marked are skipped whole by traverse_hierarchical.
+	*/
+	class GridOccupancy {
+	public:
+		GridOccupancy(const glm::ivec3& _cells, int _blockSize)
+			: cells(_cells)
+			, blockSize(std::max(_blockSize, 1))
+		{
+			blocks = (cells + glm::ivec3(blockSize - 1)) / blockSize;
+			flags.resize(static_cast<std::size_t>(blocks.x) * blocks.y * blocks.z, 0);
+		}
+
+		// Mark the block containing the cell as occupied.
+		void mark(const glm::ivec3& cell) noexcept {
+			flags[index(cell / blockSize)] = 1;
+		}
+		void clear() noexcept {
+			std::fill(flags.begin(), flags.end(), std::uint8_t(0));
+		}
+
+		bool occupied(const glm::ivec3& block) const noexcept {
+			return flags[index(block)] != 0;
+		}
+
+		const glm::ivec3& cellCount() const noexcept {
+			return cells;
+		}
+		const glm::ivec3& blockCount() const noexcept {
+			return blocks;
+		}
+		int size() const noexcept {
+			return blockSize;
+		}
+	private:
+		std::size_t index(const glm::ivec3& block) const noexcept {
+			return (static_cast<std::size_t>(block.z) * blocks.y + block.y) * blocks.x + block.x;
+		}
+
+		glm::ivec3 cells, blocks;
+		int blockSize;
+		std::vector<std::uint8_t> flags;
+	};
+
+	// Calls func(cell, entry, exit) for every cell the ray crosses, in order. The walk stops early when func returns false.
+	// Returns true if the walk was stopped by func.
+	template<typename T, typename F>
+	bool traverse(const Ray3<T>& ray, const MMRect<T, 3>& domain, const glm::ivec3& dims, F&& func, T tmin = T(0), T tmax = std::numeric_limits<T>::max()) {
+		for (GridTraversal<T> walk{ ray, domain, dims, tmin, tmax }; walk; walk.next()) {
+			EZ_GEO_STAT_EVENT(LeafVisit);
+			if (!func(walk.current(), walk.entry(), walk.exit())) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Same as traverse, but only visits the cells inside blocks marked in the occupancy level.
+	// The ray first walks the coarse grid of blocks, then the fine cells of each occupied block over the interval spent inside it.
+	template<typename T, typename F>
+	bool traverse_hierarchical(const Ray3<T>& ray, const MMRect<T, 3>& domain, const GridOccupancy& occupancy, F&& func, T tmin = T(0), T tmax = std::numeric_limits<T>::max()) {
+		using vec3_t = glm::tvec3<T>;
+		const glm::ivec3& dims = occupancy.cellCount();
+		const int bsize = occupancy.size();
+
+		// The coarse grid may overhang the domain when the cell count is not a multiple of the block size.
+		vec3_t cell = (domain.max - domain.min) / vec3_t(dims);
+		vec3_t span = cell * T(bsize);
+		MMRect<T, 3> coarse{ domain.min, domain.min + span * vec3_t(occupancy.blockCount()) };
+
+		for (GridTraversal<T> outer{ ray, coarse, occupancy.blockCount(), tmin, tmax }; outer; outer.next()) {
+			const glm::ivec3& block = outer.current();
+			EZ_GEO_STAT_EVENT(NodeVisit);
+			if (!occupancy.occupied(block)) {
+				EZ_GEO_STAT_EVENT(EarlyOut);
+				continue;
+			}
+
+			glm::ivec3 first = block * bsize;
+			glm::ivec3 count = glm::min(dims - first, glm::ivec3(bsize));
+			vec3_t lo = domain.min + cell * vec3_t(first);
+			MMRect<T, 3> sub{ lo, lo + cell * vec3_t(count) };
+
+			for (GridTraversal<T> inner{ ray, sub, count, outer.entry(), outer.exit() }; inner; inner.next()) {
+				EZ_GEO_STAT_EVENT(LeafVisit);
+				if (!func(first + inner.current(), inner.entry(), inner.exit())) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+};
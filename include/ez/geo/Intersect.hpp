@@ -8,8 +8,13 @@
 #include "Ray.hpp"
 #include "Rect.hpp"
 #include "Sphere.hpp"
+#include "Capsule.hpp"
+#include "Circle.hpp"
 #include "AABB.hpp"
 #include "Plane.hpp"
+#include "OBB.hpp"
+#include "Predicates.hpp"
+#include "Stats.hpp"
 
 #include <glm/gtx/quaternion.hpp>
 
@@ -17,185 +22,140 @@
 #include <ez/math/poly.hpp>
 
 namespace ez {
-	template<typename T>
-	bool intersect(const Line2<T>& l1, const Line2<T>& l2) {
-		glm::tvec2<T> d1 = l1.end - l1.start;
-		glm::tvec2<T> d2 = l2.end - l2.start;
-
-		T det = (d2.y * d1.x - d2.x * d1.y);
-
-		if (std::abs(det) < ez::epsilon<T>()) {
-			return false;
-		}
-		else {
-			glm::tvec2<T> diff = l2.start - l1.start;
-			T numer = (diff.x * d1.y - diff.y * d1.x);
-
-			T t2 = numer / det;
-			T t1;
-			if (t2 < static_cast<T>(0) || t2 > static_cast<T>(1)) {
-				return false;
-			}
-
-			if (std::abs(d1.x) < ez::epsilon<T>()) {
-				t1 = (diff.y + d2.y * t2) / d1.y;
-			}
-			else {
-				t1 = (diff.x + d2.x * t2) / d1.x;
+	namespace intern {
+		// Clip a ray against the slabs of a box. The ray overlaps the slabs over [tmin, tmax], which is empty when tmax < tmin.
+		// Either value may be negative, callers decide how to treat rays that start inside or behind the box.
+		template<typename T, int N>
+		void ray_slabs(const glm::vec<N, T>& origin, const glm::vec<N, T>& inverseAxis, const glm::vec<N, T>& min, const glm::vec<N, T>& max, T& tmin, T& tmax) noexcept {
+			tmin = -std::numeric_limits<T>::max();
+			tmax = std::numeric_limits<T>::max();
+
+			for (int i = 0; i < N; ++i) {
+				T t1 = (min[i] - origin[i]) * inverseAxis[i];
+				T t2 = (max[i] - origin[i]) * inverseAxis[i];
+
+				tmin = std::max(tmin, std::min(t1, t2));
+				tmax = std::min(tmax, std::max(t1, t2));
 			}
-
-			return (t1 < static_cast<T>(0) || t1 > static_cast<T>(1));
 		}
-	}
 
-	template<typename T>
-	bool intersect(const Line2<T>& l1, const Line2<T>& l2, glm::tvec2<T>& ret) {
-		glm::tvec2<T> d1 = l1.end - l1.start;
-		glm::tvec2<T> d2 = l2.end - l2.start;
-
-		T det = (d2.y * d1.x - d2.x * d1.y);
-
-		if (std::abs(det) < ez::epsilon<T>()) {
-			return false;
-		}
-		else {
-			glm::tvec2<T> diff = l2.start - l1.start;
-			T numer = (diff.x * d1.y - diff.y * d1.x);
+		// Closed segment intersection decided by the robust orientation predicate, so touching and nearly collinear segments are classified exactly.
+		// On success t1 and t2 locate a common point along each segment, for overlapping collinear segments it is the start of the overlap.
+		template<typename T>
+		bool segment_intersect(const Line2<T>& l1, const Line2<T>& l2, T& t1, T& t2) {
+			using vec2_t = glm::tvec2<T>;
+			const vec2_t& a = l1.start, & b = l1.end, & c = l2.start, & d = l2.end;
 
-			T t1;
-			T t2 = numer / det;
-			if (t2 < static_cast<T>(0) || t2 > static_cast<T>(1)) {
+			double o1 = orient2d(a, b, c), o2 = orient2d(a, b, d);
+			double o3 = orient2d(c, d, a), o4 = orient2d(c, d, b);
+			if ((o1 > 0.0 && o2 > 0.0) || (o1 < 0.0 && o2 < 0.0) || (o3 > 0.0 && o4 > 0.0) || (o3 < 0.0 && o4 < 0.0)) {
 				return false;
 			}
 
-			if (std::abs(d1.x) < ez::epsilon<T>()) {
-				t1 = (diff.y + d2.y * t2) / d1.y;
-			}
-			else {
-				t1 = (diff.x + d2.x * t2) / d1.x;
+			vec2_t d1 = b - a;
+			vec2_t d2 = d - c;
+			vec2_t diff = c - a;
+
+			if (o1 != 0.0 || o2 != 0.0 || o3 != 0.0 || o4 != 0.0) {
+				// A single crossing point, the lines can not be parallel here.
+				T det = d1.x * d2.y - d1.y * d2.x;
+				if (det == T(0)) {
+					t1 = o1 == 0.0 ? T(0) : T(1);
+					t2 = T(0);
+					return true;
+				}
+				t1 = std::min(std::max((diff.x * d2.y - diff.y * d2.x) / det, T(0)), T(1));
+				t2 = std::min(std::max((diff.x * d1.y - diff.y * d1.x) / det, T(0)), T(1));
+				return true;
 			}
 
-			if (t1 < static_cast<T>(0) || t1 > static_cast<T>(1)) {
-				ret = d2 * t2 + l2.start;
-				return true;
+			// Collinear, compare the projections onto the longer segment.
+			T dd1 = glm::dot(d1, d1), dd2 = glm::dot(d2, d2);
+			if (dd1 == T(0) && dd2 == T(0)) {
+				t1 = t2 = T(0);
+				return a == c;
+			}
+			if (dd1 >= dd2) {
+				T s0 = glm::dot(c - a, d1) / dd1;
+				T s1 = glm::dot(d - a, d1) / dd1;
+				T lo = std::max(std::min(s0, s1), T(0));
+				T hi = std::min(std::max(s0, s1), T(1));
+				if (lo > hi) {
+					return false;
+				}
+				t1 = lo;
+				t2 = dd2 > T(0) ? glm::dot(a + d1 * lo - c, d2) / dd2 : T(0);
 			}
 			else {
-				return false;
+				T s0 = glm::dot(a - c, d2) / dd2;
+				T s1 = glm::dot(b - c, d2) / dd2;
+				T lo = std::max(std::min(s0, s1), T(0));
+				T hi = std::min(std::max(s0, s1), T(1));
+				if (lo > hi) {
+					return false;
+				}
+				t2 = lo;
+				t1 = dd1 > T(0) ? glm::dot(c + d2 * lo - a, d1) / dd1 : T(0);
 			}
+			t1 = std::min(std::max(t1, T(0)), T(1));
+			t2 = std::min(std::max(t2, T(0)), T(1));
+			return true;
 		}
 	}
 
+	// Segments are closed, touching at an endpoint or overlapping along a shared line counts as an intersection.
 	template<typename T>
-	bool intersect(const Line2<T>& l1, const Line2<T>& l2, T& t1) {
-		glm::tvec2<T> d1 = l1.end - l1.start;
-		glm::tvec2<T> d2 = l2.end - l2.start;
-
-		T det = (d2.y * d1.x - d2.x * d1.y);
-
-		if (std::abs(det) < ez::epsilon<T>()) {
-			return false;
-		}
-		else {
-			glm::tvec2<T> diff = l2.start - l1.start;
-			T numer = (diff.x * d1.y - diff.y * d1.x);
+	bool intersect(const Line2<T>& l1, const Line2<T>& l2) {
+		EZ_GEO_STAT_TEST(LineLine);
 
-			T t2 = numer / det;
-			if (t2 < static_cast<T>(0) || t2 > static_cast<T>(1)) {
-				return false;
-			}
+		T t1, t2;
+		return intern::segment_intersect(l1, l2, t1, t2);
+	}
 
-			if (std::abs(d1.x) < ez::epsilon<T>()) {
-				t1 = (diff.y + d2.y * t2) / d1.y;
-			}
-			else {
-				t1 = (diff.x + d2.x * t2) / d1.x;
-			}
+	template<typename T>
+	bool intersect(const Line2<T>& l1, const Line2<T>& l2, glm::tvec2<T>& ret) {
+		EZ_GEO_STAT_TEST(LineLine);
 
-			return (t1 < static_cast<T>(0) || t1 > static_cast<T>(1));
+		T t1, t2;
+		if (intern::segment_intersect(l1, l2, t1, t2)) {
+			ret = l1.start + (l1.end - l1.start) * t1;
+			return true;
 		}
+		return false;
 	}
 
 	template<typename T>
-	bool intersect(const Line2<T>& l1, const Line2<T>& l2, T& t1, T& t2) {
-		glm::tvec2<T> d1 = l1.end - l1.start;
-		glm::tvec2<T> d2 = l2.end - l2.start;
-
-		T det = (d2.y * d1.x - d2.x * d1.y);
-
-		if (std::abs(det) < ez::epsilon<T>()) {
-			return false;
-		}
-		else {
-			glm::tvec2<T> diff = l2.start - l1.start;
-			T numer = (diff.x * d1.y - diff.y * d1.x);
+	bool intersect(const Line2<T>& l1, const Line2<T>& l2, T& t1) {
+		EZ_GEO_STAT_TEST(LineLine);
 
-			T t2 = numer / det;
-			if (t2 < static_cast<T>(0) || t2 > static_cast<T>(1)) {
-				return false;
-			}
+		T t2;
+		return intern::segment_intersect(l1, l2, t1, t2);
+	}
 
-			if (std::abs(d1.x) < ez::epsilon<T>()) {
-				t1 = (diff.y + d2.y * t2) / d1.y;
-			}
-			else {
-				t1 = (diff.x + d2.x * t2) / d1.x;
-			}
+	template<typename T>
+	bool intersect(const Line2<T>& l1, const Line2<T>& l2, T& t1, T& t2) {
+		EZ_GEO_STAT_TEST(LineLine);
 
-			return (t1 < static_cast<T>(0) || t1 > static_cast<T>(1));
-		}
+		return intern::segment_intersect(l1, l2, t1, t2);
 	}
 
 
 	template<typename T>
 	bool intersect(const Ray3<T>& r, const AABB3<T>& b) {
-		T tmin = -std::numeric_limits<T>::max(), tmax = std::numeric_limits<T>::max();
-
-		glm::tvec3<T> inverseAxis = static_cast<T>(1) / r.axis;
-
-		T t1 = (b.min[0] - r.origin[0]) * inverseAxis[0];
-		T t2 = (b.max[0] - r.origin[0]) * inverseAxis[0];
-
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
-
-		t1 = (b.min[1] - r.origin[1]) * inverseAxis[1];
-		t2 = (b.max[1] - r.origin[1]) * inverseAxis[1];
-
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
-
-		t1 = (b.min[2] - r.origin[2]) * inverseAxis[2];
-		t2 = (b.max[2] - r.origin[2]) * inverseAxis[2];
+		EZ_GEO_STAT_TEST(RayAABB);
 
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
+		T tmin, tmax;
+		intern::ray_slabs(r.origin, static_cast<T>(1) / r.axis, b.min, b.max, tmin, tmax);
 
 		return tmax > std::max(tmin, static_cast<T>(0));
 	}
 
 	template<typename T>
 	bool intersect(const Ray3<T>& r, const AABB3<T>& b, T& t) {
-		T tmin = -std::numeric_limits<T>::max(), tmax = std::numeric_limits<T>::max();
-
-		glm::tvec3<T> inverseAxis = static_cast<T>(1) / r.axis;
-
-		T t1 = (b.min[0] - r.origin[0]) * inverseAxis[0];
-		T t2 = (b.max[0] - r.origin[0]) * inverseAxis[0];
-
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
-
-		t1 = (b.min[1] - r.origin[1]) * inverseAxis[1];
-		t2 = (b.max[1] - r.origin[1]) * inverseAxis[1];
-
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
-
-		t1 = (b.min[2] - r.origin[2]) * inverseAxis[2];
-		t2 = (b.max[2] - r.origin[2]) * inverseAxis[2];
+		EZ_GEO_STAT_TEST(RayAABB);
 
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
+		T tmin, tmax;
+		intern::ray_slabs(r.origin, static_cast<T>(1) / r.axis, b.min, b.max, tmin, tmax);
 
 		if (tmax > tmin) {
 			if (tmin < 0.0) {
@@ -211,27 +171,10 @@ namespace ez {
 
 	template<typename T>
 	bool intersect(const Ray3<T>& r, const AABB3<T>& b, glm::tvec3<T>& hit) {
-		T tmin = -std::numeric_limits<T>::max(), tmax = std::numeric_limits<T>::max();
-
-		glm::tvec3<T> inverseAxis = static_cast<T>(1) / r.axis;
-
-		T t1 = (b.min[0] - r.origin[0]) * inverseAxis[0];
-		T t2 = (b.max[0] - r.origin[0]) * inverseAxis[0];
-
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
+		EZ_GEO_STAT_TEST(RayAABB);
 
-		t1 = (b.min[1] - r.origin[1]) * inverseAxis[1];
-		t2 = (b.max[1] - r.origin[1]) * inverseAxis[1];
-
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
-
-		t1 = (b.min[2] - r.origin[2]) * inverseAxis[2];
-		t2 = (b.max[2] - r.origin[2]) * inverseAxis[2];
-
-		tmin = std::max(tmin, std::min(t1, t2));
-		tmax = std::min(tmax, std::max(t1, t2));
+		T tmin, tmax;
+		intern::ray_slabs(r.origin, static_cast<T>(1) / r.axis, b.min, b.max, tmin, tmax);
 
 		if (tmax > tmin) {
 			if (tmin < 0.0) {
@@ -248,6 +191,8 @@ namespace ez {
 
 	template<typename T>
 	bool intersect(const Ray3<T>& r, const Plane3<T>& p) {
+		EZ_GEO_STAT_TEST(RayPlane);
+
 		T numer = glm::dot(p.origin, p.normal) - glm::dot(p.normal, r.origin);
 		T denom = glm::dot(r.axis, p.normal);
 
@@ -261,6 +206,8 @@ namespace ez {
 
 	template<typename T>
 	bool intersect(const Ray3<T>& r, const Plane3<T>& p, T& t) {
+		EZ_GEO_STAT_TEST(RayPlane);
+
 		T numer = glm::dot(p.origin, p.normal) - glm::dot(p.normal, r.origin);
 		T denom = glm::dot(r.axis, p.normal);
 
@@ -273,6 +220,8 @@ namespace ez {
 
 	template<typename T>
 	bool intersect(const Ray3<T>& r, const Plane3<T>& p, glm::tvec3<T>& hit) {
+		EZ_GEO_STAT_TEST(RayPlane);
+
 		T numer = glm::dot(p.origin, p.normal) - glm::dot(p.normal, r.origin);
 		T denom = glm::dot(r.axis, p.normal);
 
@@ -289,6 +238,8 @@ namespace ez {
 
 	template<typename T>
 	bool intersect(const Ray3<T>& r, const Sphere<T>& s) {
+		EZ_GEO_STAT_TEST(RaySphere);
+
 		glm::tvec3<T> L = r.origin - s.origin;
 		T a = glm::dot(r.axis, r.axis);
 		T b = static_cast<T>(2) * glm::dot(r.axis, L);
@@ -299,37 +250,48 @@ namespace ez {
 		return D >= static_cast<T>(0);
 	}
 
-	template<typename T>
-	bool intersect(const Ray3<T>& r, const Sphere<T>& s, T& t) {
-		glm::tvec3<T> L = r.origin - s.origin;
-		T a = glm::dot(r.axis, r.axis);
-		T b = static_cast<T>(2) * glm::dot(r.axis, L);
-		T c = glm::dot(L, L) - s.radius * s.radius;
-
-		T roots[2];
-		int count = ez::poly::solveQuadratic<T>(a, b, c, roots);
-
-		if (count == 2) {
-			T closest = std::min(roots[0], roots[1]);
-			if (closest < static_cast<T>(0)) {
-				closest = roots[1];
+	namespace intern {
+		// The ray sphere test without the statistics, for the shapes built from spheres that count their own tests.
+		template<typename T>
+		bool ray_sphere(const glm::tvec3<T>& origin, const glm::tvec3<T>& axis, const glm::tvec3<T>& center, T radius, T& t) noexcept {
+			glm::tvec3<T> L = origin - center;
+			T a = glm::dot(axis, axis);
+			T b = static_cast<T>(2) * glm::dot(axis, L);
+			T c = glm::dot(L, L) - radius * radius;
+
+			T roots[2];
+			int count = ez::poly::solveQuadratic<T>(a, b, c, roots);
+
+			if (count == 2) {
+				T closest = std::min(roots[0], roots[1]);
+				if (closest < static_cast<T>(0)) {
+					closest = roots[1];
+				}
+				if (closest < static_cast<T>(0)) {
+					return false;
+				}
+				t = closest;
+				return true;
 			}
-			if (closest < static_cast<T>(0)) {
-				return false;
+			else if (count == 1 && roots[0] >= static_cast<T>(0)) {
+				t = roots[0];
+				return true;
 			}
-			t = closest;
-			return true;
-		}
-		else if (count == 1 && roots[0] >= static_cast<T>(0)) {
-			t = roots[0];
-			return true;
+
+			return false;
 		}
+	}
 
-		return false;
+	template<typename T>
+	bool intersect(const Ray3<T>& r, const Sphere<T>& s, T& t) {
+		EZ_GEO_STAT_TEST(RaySphere);
+		return intern::ray_sphere(r.origin, r.axis, s.origin, s.radius, t);
 	}
 
 	template<typename T>
 	bool intersect(const Ray3<T>& r, const Sphere<T>& s, glm::tvec3<T>& hit) {
+		EZ_GEO_STAT_TEST(RaySphere);
+
 		glm::tvec3<T> L = r.origin - s.origin;
 		T a = glm::dot(r.axis, r.axis);
 		T b = static_cast<T>(2) * glm::dot(r.axis, L);
@@ -374,4 +336,375 @@ namespace ez {
 	inline bool intersect(const Plane3<float>& p, const Ray3<float>& r, glm::vec3& hit) {
 		return intersect(r, p, hit);
 	}
+
+	// Overlap of two min max rects. Inclusive rects also report rects that only share a boundary.
+	template<typename T, int N, bool inclusive>
+	bool intersect(const MMRect<T, N, inclusive>& a, const MMRect<T, N, inclusive>& b) noexcept {
+		EZ_GEO_STAT_TEST(RectRect);
+
+		if constexpr (N == 1) {
+			if constexpr (inclusive) {
+				return a.min <= b.max && b.min <= a.max;
+			}
+			else {
+				return a.min < b.max && b.min < a.max;
+			}
+		}
+		else {
+			if constexpr (inclusive) {
+				return
+					glm::all(glm::lessThanEqual(a.min, b.max)) &&
+					glm::all(glm::lessThanEqual(b.min, a.max));
+			}
+			else {
+				return
+					glm::all(glm::lessThan(a.min, b.max)) &&
+					glm::all(glm::lessThan(b.min, a.max));
+			}
+		}
+	}
+
+	template<typename T>
+	bool intersect(const Sphere<T>& a, const Sphere<T>& b) noexcept {
+		EZ_GEO_STAT_TEST(SphereSphere);
+
+		glm::tvec3<T> d = b.origin - a.origin;
+		T r = a.radius + b.radius;
+		return glm::dot(d, d) <= r * r;
+	}
+
+	template<typename T>
+	bool intersect(const Circle<T>& a, const Circle<T>& b) noexcept {
+		EZ_GEO_STAT_TEST(CircleCircle);
+
+		glm::tvec2<T> d = b.origin - a.origin;
+		T r = a.radius + b.radius;
+		return glm::dot(d, d) <= r * r;
+	}
+
+	// Distance from the sphere origin to the closest point in the box, compared against the radius.
+	template<typename T>
+	bool intersect(const Sphere<T>& s, const AABB3<T>& b) noexcept {
+		EZ_GEO_STAT_TEST(SphereRect);
+
+		glm::tvec3<T> d = s.origin - glm::clamp(s.origin, b.min, b.max);
+		return glm::dot(d, d) <= s.radius * s.radius;
+	}
+	template<typename T>
+	bool intersect(const AABB3<T>& b, const Sphere<T>& s) noexcept {
+		return intersect(s, b);
+	}
+
+	template<typename T>
+	bool intersect(const Circle<T>& c, const AABB2<T>& b) noexcept {
+		EZ_GEO_STAT_TEST(CircleRect);
+
+		glm::tvec2<T> d = c.origin - glm::clamp(c.origin, b.min, b.max);
+		return glm::dot(d, d) <= c.radius * c.radius;
+	}
+	template<typename T>
+	bool intersect(const AABB2<T>& b, const Circle<T>& c) noexcept {
+		return intersect(c, b);
+	}
+
+	// Separating axis test.
+	template<typename T, int N>
+	bool intersect(const OBB<T, N>& a, const OBB<T, N>& b) noexcept {
+		EZ_GEO_STAT_TEST(OBBOBB);
+
+		T R[N][N], t[N], ea[N], eb[N];
+		glm::vec<N, T> d = b.origin - a.origin;
+		for (int i = 0; i < N; ++i) {
+			for (int j = 0; j < N; ++j) {
+				R[i][j] = glm::dot(a.axes[i], b.axes[j]);
+			}
+			t[i] = glm::dot(d, a.axes[i]);
+			ea[i] = a.half[i];
+			eb[i] = b.half[i];
+		}
+		return intern::sat_overlap<T, N>(R, t, ea, eb);
+	}
+
+	template<typename T, int N>
+	bool intersect(const OBB<T, N>& a, const MMRect<T, N>& b) noexcept {
+		return intersect(a, OBB<T, N>{ b.center(), typename OBB<T, N>::basis_t{ T(1) }, b.size() / T(2) });
+	}
+	template<typename T, int N>
+	bool intersect(const MMRect<T, N>& a, const OBB<T, N>& b) noexcept {
+		return intersect(b, a);
+	}
+
+	// The ray is moved into the frame of the box, then treated as a ray vs AABB test.
+	template<typename T, int N>
+	bool intersect(const Ray<T, N>& r, const OBB<T, N>& b, T& t) noexcept {
+		EZ_GEO_STAT_TEST(RayOBB);
+
+		glm::vec<N, T> origin = b.toLocal(r.origin);
+
+		T tmin = -std::numeric_limits<T>::max(), tmax = std::numeric_limits<T>::max();
+		for (int i = 0; i < N; ++i) {
+			T inverseAxis = static_cast<T>(1) / glm::dot(r.axis, b.axes[i]);
+
+			T t1 = (-b.half[i] - origin[i]) * inverseAxis;
+			T t2 = (b.half[i] - origin[i]) * inverseAxis;
+
+			tmin = std::max(tmin, std::min(t1, t2));
+			tmax = std::min(tmax, std::max(t1, t2));
+		}
+
+		if (tmax > std::max(tmin, static_cast<T>(0))) {
+			if (tmin < static_cast<T>(0)) {
+				t = tmax;
+			}
+			else {
+				t = tmin;
+			}
+			return true;
+		}
+		return false;
+	}
+	template<typename T, int N>
+	bool intersect(const Ray<T, N>& r, const OBB<T, N>& b) noexcept {
+		T t;
+		return intersect(r, b, t);
+	}
+	template<typename T, int N>
+	bool intersect(const Ray<T, N>& r, const OBB<T, N>& b, glm::vec<N, T>& hit) noexcept {
+		T t;
+		if (intersect(r, b, t)) {
+			hit = r.eval(t);
+			return true;
+		}
+		return false;
+	}
+
+	template<typename T, int N>
+	bool intersect(const OBB<T, N>& b, const Ray<T, N>& r) noexcept {
+		return intersect(r, b);
+	}
+	template<typename T, int N>
+	bool intersect(const OBB<T, N>& b, const Ray<T, N>& r, glm::vec<N, T>& hit) noexcept {
+		return intersect(r, b, hit);
+	}
+
+	namespace intern {
+		// Earliest t >= 0 where the ray enters the capsule formed by the segment a b and the radius. Rays starting inside hit at t = 0.
+		template<typename T>
+		bool ray_capsule(const glm::tvec3<T>& origin, const glm::tvec3<T>& axis, const glm::tvec3<T>& a, const glm::tvec3<T>& b, T radius, T& t) noexcept {
+			using vec3_t = glm::tvec3<T>;
+			vec3_t ab = b - a;
+			vec3_t m = origin - a;
+			T dd = glm::dot(ab, ab);
+			T md = glm::dot(m, ab);
+
+			// Starting inside
+			T s = dd > T(0) ? std::min(std::max(md / dd, T(0)), T(1)) : T(0);
+			vec3_t off = m - ab * s;
+			if (glm::dot(off, off) <= radius * radius) {
+				t = T(0);
+				return true;
+			}
+
+			T best = std::numeric_limits<T>::max();
+
+			// The side of the cylinder, from Ericson, Real-Time Collision Detection 5.3.7.
+			T nd = glm::dot(axis, ab);
+			T nn = glm::dot(axis, axis);
+			T mn = glm::dot(m, axis);
+			T qa = dd * nn - nd * nd;
+			T k = glm::dot(m, m) - radius * radius;
+			T qc = dd * k - md * md;
+			T qb = dd * mn - nd * md;
+			if (std::abs(qa) > ez::epsilon<T>() * dd * nn) {
+				T disc = qb * qb - qa * qc;
+				if (disc >= T(0)) {
+					T root = (-qb - std::sqrt(disc)) / qa;
+					T along = md + root * nd;
+					if (root >= T(0) && along >= T(0) && along <= dd) {
+						best = root;
+					}
+				}
+			}
+
+			// The end caps
+			T cap;
+			if (ray_sphere(origin, axis, a, radius, cap) && cap < best) {
+				best = cap;
+			}
+			if (ray_sphere(origin, axis, b, radius, cap) && cap < best) {
+				best = cap;
+			}
+
+			if (best == std::numeric_limits<T>::max()) {
+				return false;
+			}
+			t = best;
+			return true;
+		}
+
+		// Closest points of the segments p1 q1 and p2 q2 at p1 + (q1 - p1) * s and p2 + (q2 - p2) * t, returns their squared distance.
+		// From Ericson, Real-Time Collision Detection 5.1.9, written with selects instead of branches so the batch kernels vectorize:
+		// t is found from the clamped s, then s again from the clamped t. Degenerate segments and parallel segments, where any s
+		// is a solution, start from s = 0.
+		template<typename T>
+		T closest_segments(const glm::tvec3<T>& p1, const glm::tvec3<T>& q1, const glm::tvec3<T>& p2, const glm::tvec3<T>& q2, T& s, T& t) noexcept {
+			using vec3_t = glm::tvec3<T>;
+			vec3_t d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+			T a = glm::dot(d1, d1), e = glm::dot(d2, d2);
+			T b = glm::dot(d1, d2), c = glm::dot(d1, r), f = glm::dot(d2, r);
+			T tiny = std::numeric_limits<T>::min();
+
+			T denom = a * e - b * b;
+			bool parallel = denom <= ez::epsilon<T>() * a * e;
+			s = parallel ? T(0) : std::min(std::max((b * f - c * e) / std::max(denom, tiny), T(0)), T(1));
+			t = std::min(std::max((b * s + f) / std::max(e, tiny), T(0)), T(1));
+			s = std::min(std::max((b * t - c) / std::max(a, tiny), T(0)), T(1));
+
+			vec3_t diff = (p1 + d1 * s) - (p2 + d2 * t);
+			return glm::dot(diff, diff);
+		}
+
+		// Squared distance from the point to the segment a b, the closest point is at a + (b - a) * s.
+		template<typename T>
+		T closest_segment_point(const glm::tvec3<T>& a, const glm::tvec3<T>& b, const glm::tvec3<T>& p, T& s) noexcept {
+			glm::tvec3<T> ab = b - a;
+			T dd = glm::dot(ab, ab);
+			s = std::min(std::max(glm::dot(p - a, ab) / std::max(dd, std::numeric_limits<T>::min()), T(0)), T(1));
+			glm::tvec3<T> diff = p - (a + ab * s);
+			return glm::dot(diff, diff);
+		}
+
+		// Squared distance from the segment p q to the box. The squared distance from the box along the segment is a convex
+		// quadratic between the points where the segment crosses the planes of the slabs, so it is minimized exactly on each
+		// of those pieces, with no iteration.
+		template<typename T>
+		T segment_box_distance2(const glm::tvec3<T>& p, const glm::tvec3<T>& q, const glm::tvec3<T>& min, const glm::tvec3<T>& max) noexcept {
+			glm::tvec3<T> d = q - p;
+
+			T cuts[8];
+			int count = 0;
+			cuts[count++] = T(0);
+			for (int k = 0; k < 3; ++k) {
+				if (d[k] != T(0)) {
+					const T bounds[2] = { min[k], max[k] };
+					for (T bound : bounds) {
+						T s = (bound - p[k]) / d[k];
+						if (s > T(0) && s < T(1)) {
+							// Insertion sort, there are at most 6 cuts.
+							int i = count++;
+							for (; cuts[i - 1] > s; --i) {
+								cuts[i] = cuts[i - 1];
+							}
+							cuts[i] = s;
+						}
+					}
+				}
+			}
+			cuts[count++] = T(1);
+
+			T best = std::numeric_limits<T>::max();
+			for (int i = 0; i + 1 < count; ++i) {
+				T s0 = cuts[i], s1 = cuts[i + 1];
+				T mid = (s0 + s1) * T(0.5);
+
+				// Over the piece every axis stays below, inside or above its slab, the axes outside contribute a quadratic.
+				T qa = T(0), qb = T(0);
+				for (int k = 0; k < 3; ++k) {
+					T x = p[k] + d[k] * mid;
+					if (x < min[k] || x > max[k]) {
+						T bound = x < min[k] ? min[k] : max[k];
+						qa += d[k] * d[k];
+						qb += d[k] * (p[k] - bound);
+					}
+				}
+				T s = qa > T(0) ? std::min(std::max(-qb / qa, s0), s1) : s0;
+
+				glm::tvec3<T> x = p + d * s;
+				glm::tvec3<T> off = x - glm::clamp(x, min, max);
+				best = std::min(best, glm::dot(off, off));
+			}
+			return best;
+		}
+	}
+
+	// Closest points of two segments, returns their squared distance.
+	template<typename T>
+	T closest_points(const Line3<T>& a, const Line3<T>& b, glm::tvec3<T>& onA, glm::tvec3<T>& onB) noexcept {
+		T s, t;
+		T dist = intern::closest_segments(a.start, a.end, b.start, b.end, s, t);
+		onA = a.start + (a.end - a.start) * s;
+		onB = b.start + (b.end - b.start) * t;
+		return dist;
+	}
+	// Closest point of the segment to a point, returns their squared distance.
+	template<typename T>
+	T closest_point(const Line3<T>& line, const glm::tvec3<T>& point, glm::tvec3<T>& onLine) noexcept {
+		T s;
+		T dist = intern::closest_segment_point(line.start, line.end, point, s);
+		onLine = line.start + (line.end - line.start) * s;
+		return dist;
+	}
+
+	template<typename T>
+	bool intersect(const Capsule<T>& a, const Capsule<T>& b) noexcept {
+		EZ_GEO_STAT_TEST(CapsuleCapsule);
+
+		T s, t;
+		T r = a.radius + b.radius;
+		return intern::closest_segments(a.segment.start, a.segment.end, b.segment.start, b.segment.end, s, t) <= r * r;
+	}
+
+	template<typename T>
+	bool intersect(const Capsule<T>& c, const Sphere<T>& s) noexcept {
+		EZ_GEO_STAT_TEST(CapsuleSphere);
+
+		T along;
+		T r = c.radius + s.radius;
+		return intern::closest_segment_point(c.segment.start, c.segment.end, s.origin, along) <= r * r;
+	}
+	template<typename T>
+	bool intersect(const Sphere<T>& s, const Capsule<T>& c) noexcept {
+		return intersect(c, s);
+	}
+
+	template<typename T>
+	bool intersect(const Capsule<T>& c, const AABB3<T>& b) noexcept {
+		EZ_GEO_STAT_TEST(CapsuleRect);
+
+		return intern::segment_box_distance2(c.segment.start, c.segment.end, b.min, b.max) <= c.radius * c.radius;
+	}
+	template<typename T>
+	bool intersect(const AABB3<T>& b, const Capsule<T>& c) noexcept {
+		return intersect(c, b);
+	}
+
+	// Rays starting inside the capsule hit at t = 0.
+	template<typename T>
+	bool intersect(const Ray3<T>& r, const Capsule<T>& c, T& t) noexcept {
+		EZ_GEO_STAT_TEST(RayCapsule);
+
+		return intern::ray_capsule(r.origin, r.axis, c.segment.start, c.segment.end, c.radius, t);
+	}
+	template<typename T>
+	bool intersect(const Ray3<T>& r, const Capsule<T>& c) noexcept {
+		T t;
+		return intersect(r, c, t);
+	}
+	template<typename T>
+	bool intersect(const Ray3<T>& r, const Capsule<T>& c, glm::tvec3<T>& hit) noexcept {
+		T t;
+		if (intersect(r, c, t)) {
+			hit = r.eval(t);
+			return true;
+		}
+		return false;
+	}
+	template<typename T>
+	bool intersect(const Capsule<T>& c, const Ray3<T>& r) noexcept {
+		return intersect(r, c);
+	}
+	template<typename T>
+	bool intersect(const Capsule<T>& c, const Ray3<T>& r, glm::tvec3<T>& hit) noexcept {
+		return intersect(r, c, hit);
+	}
 };
\ No newline at end of file
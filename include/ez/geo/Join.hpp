@@ -0,0 +1,241 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include <glm/vec2.hpp>
+#include <glm/common.hpp>
+
+#include "MMRect.hpp"
+#include "SoA.hpp"
+#include "BatchIntersect.hpp"
+#include "ThreadPool.hpp"
+
+/*
+Spatial join, every overlapping pair between two large sets of 2d rects.
+
+The common bounds of both sets are cut into a uniform grid and every rect is listed in each cell it overlaps.
+The cells are then joined independently, in parallel on an executor (see ThreadPool.hpp), with a plane sweep along x.
+A pair that shares several cells is only reported by the cell that holds its reference point,
+the min corner of the intersection of the two rects, so no pair is reported twice and no global deduplication is needed.
+
+Each task writes its own buffer, and the buffers are concatenated in task order at the end, so the output is the same
+whatever the executor. The pairs are in no particular order. Overlap is strict as in intersect_batch, touching rects do not count.
+*/
+
+namespace ez {
+	namespace intern {
+		// Grid over the join domain, cell coordinates are clamped so every point of the domain maps to a cell.
+		template<typename T>
+		struct JoinGrid {
+			int cell(T v, int axis) const noexcept {
+				T c = (v - origin[axis]) * scale[axis];
+				return c <= T(0) ? 0 : std::min(static_cast<int>(c), dims - 1);
+			}
+
+			T origin[2];
+			T scale[2];
+			int dims;
+		};
+
+		// The rects of one set listed per cell, the rects of cell c are items[offsets[c]] up to items[offsets[c + 1]].
+		struct JoinCells {
+			std::vector<std::size_t> offsets;
+			std::vector<std::uint32_t> items;
+		};
+
+		// Rects entirely outside the domain cannot overlap the other set, they are left out instead of piling up in the border cells.
+		template<typename T>
+		void join_cells(const MMRectSoA<T, 2>& set, const JoinGrid<T>& grid, const MMRect<T, 2>& domain, JoinCells& out) {
+			const T* minx = set.min.data(0), * miny = set.min.data(1), * maxx = set.max.data(0), * maxy = set.max.data(1);
+			std::size_t count = set.size(), cells = std::size_t(grid.dims) * std::size_t(grid.dims);
+
+			out.offsets.assign(cells + 1, 0);
+			for (int pass = 0; pass < 2; ++pass) {
+				if (pass == 1) {
+					for (std::size_t c = 0; c < cells; ++c) {
+						out.offsets[c + 1] += out.offsets[c];
+					}
+					out.items.resize(out.offsets[cells]);
+				}
+				for (std::size_t i = 0; i < count; ++i) {
+					bool miss =
+						(maxx[i] < domain.min.x) | (domain.max.x < minx[i]) |
+						(maxy[i] < domain.min.y) | (domain.max.y < miny[i]);
+					if (miss) {
+						continue;
+					}
+					int x0 = grid.cell(minx[i], 0), x1 = grid.cell(maxx[i], 0);
+					int y0 = grid.cell(miny[i], 1), y1 = grid.cell(maxy[i], 1);
+					for (int y = y0; y <= y1; ++y) {
+						for (int x = x0; x <= x1; ++x) {
+							std::size_t c = std::size_t(y) * std::size_t(grid.dims) + std::size_t(x);
+							if (pass == 0) {
+								++out.offsets[c + 1];
+							}
+							else {
+								// The first pass left the counts one cell ahead, so this doubles as the write cursor.
+								out.items[out.offsets[c]++] = static_cast<std::uint32_t>(i);
+							}
+						}
+					}
+				}
+				if (pass == 1) {
+					// Undo the shift of the write cursors.
+					for (std::size_t c = cells; c > 0; --c) {
+						out.offsets[c] = out.offsets[c - 1];
+					}
+					out.offsets[0] = 0;
+				}
+			}
+		}
+
+		// Plane sweep of the rects of a and b listed in one cell, appends the pairs whose reference point is in the cell.
+		template<typename T>
+		void join_cell(const MMRectSoA<T, 2>& a, const MMRectSoA<T, 2>& b, const JoinGrid<T>& grid, int cx, int cy,
+			std::vector<std::uint32_t>& la, std::vector<std::uint32_t>& lb, std::vector<IndexPair>& out)
+		{
+			const T* aminx = a.min.data(0), * aminy = a.min.data(1), * amaxx = a.max.data(0), * amaxy = a.max.data(1);
+			const T* bminx = b.min.data(0), * bminy = b.min.data(1), * bmaxx = b.max.data(0), * bmaxy = b.max.data(1);
+
+			std::sort(la.begin(), la.end(), [aminx](std::uint32_t i, std::uint32_t j) {
+				return aminx[i] < aminx[j];
+			});
+			std::sort(lb.begin(), lb.end(), [bminx](std::uint32_t i, std::uint32_t j) {
+				return bminx[i] < bminx[j];
+			});
+
+			auto report = [&](std::uint32_t i, std::uint32_t j) {
+				bool overlap =
+					(aminx[i] < bmaxx[j]) & (bminx[j] < amaxx[i]) &
+					(aminy[i] < bmaxy[j]) & (bminy[j] < amaxy[i]);
+				if (!overlap) {
+					return;
+				}
+				T rx = std::max(aminx[i], bminx[j]), ry = std::max(aminy[i], bminy[j]);
+				if (grid.cell(rx, 0) == cx && grid.cell(ry, 1) == cy) {
+					out.push_back(IndexPair{ i, j });
+				}
+			};
+
+			std::size_t ia = 0, ib = 0, na = la.size(), nb = lb.size();
+			while (ia < na && ib < nb) {
+				if (aminx[la[ia]] < bminx[lb[ib]]) {
+					std::uint32_t i = la[ia++];
+					for (std::size_t k = ib; k < nb && bminx[lb[k]] < amaxx[i]; ++k) {
+						report(i, lb[k]);
+					}
+				}
+				else {
+					std::uint32_t j = lb[ib++];
+					for (std::size_t k = ia; k < na && aminx[la[k]] < bmaxx[j]; ++k) {
+						report(la[k], j);
+					}
+				}
+			}
+		}
+
+		// The buffers of one task of the join.
+		struct JoinTask {
+			std::vector<IndexPair> pairs;
+			std::vector<std::uint32_t> a, b;
+		};
+
+		// Cells per task, enough to keep the scheduling cost low while leaving plenty of tasks to balance.
+		static constexpr std::size_t JoinCellsPerTask = 16;
+		// Target average number of rects per cell when the grid size is picked automatically.
+		static constexpr std::size_t JoinCellLoad = 32;
+	}
+
+	// Working memory of spatial_join. Keeping one between joins reuses its buffers, so joins of similar sizes do not allocate.
+	struct JoinScratch {
+		intern::JoinCells a, b;
+		std::vector<intern::JoinTask> tasks;
+	};
+
+	// Every overlapping pair (index into a, index into b), appended to pairs. Returns the number of pairs appended.
+	// Dims is the number of grid cells along each axis, zero picks it from the sizes of the sets.
+	template<typename T, typename Exec>
+	std::size_t spatial_join(const MMRectSoA<T, 2>& a, const MMRectSoA<T, 2>& b, std::vector<IndexPair>& pairs, Exec&& exec, JoinScratch& scratch, int dims = 0) {
+		if (a.empty() || b.empty()) {
+			return 0;
+		}
+
+		// The overlapping pairs all lie in the intersection of the bounds of the two sets.
+		MMRect<T, 2> ba{ glm::tvec2<T>{ std::numeric_limits<T>::max() }, glm::tvec2<T>{ std::numeric_limits<T>::lowest() } };
+		MMRect<T, 2> bb = ba;
+		for (int k = 0; k < 2; ++k) {
+			const T* lo = a.min.data(k), * hi = a.max.data(k);
+			ba.min[k] = *std::min_element(lo, lo + a.size());
+			ba.max[k] = *std::max_element(hi, hi + a.size());
+			lo = b.min.data(k);
+			hi = b.max.data(k);
+			bb.min[k] = *std::min_element(lo, lo + b.size());
+			bb.max[k] = *std::max_element(hi, hi + b.size());
+		}
+		MMRect<T, 2> domain{ glm::max(ba.min, bb.min), glm::min(ba.max, bb.max) };
+		if (domain.min.x > domain.max.x || domain.min.y > domain.max.y) {
+			return 0;
+		}
+
+		if (dims <= 0) {
+			double side = std::sqrt(double(a.size() + b.size()) / double(intern::JoinCellLoad));
+			dims = static_cast<int>(std::min(std::max(side, 1.0), 4096.0));
+		}
+		intern::JoinGrid<T> grid;
+		grid.dims = dims;
+		for (int k = 0; k < 2; ++k) {
+			T extent = domain.max[k] - domain.min[k];
+			grid.origin[k] = domain.min[k];
+			grid.scale[k] = extent > T(0) ? T(dims) / extent : T(0);
+		}
+
+		intern::JoinCells& ca = scratch.a, & cb = scratch.b;
+		intern::join_cells(a, grid, domain, ca);
+		intern::join_cells(b, grid, domain, cb);
+
+		std::size_t cells = std::size_t(dims) * std::size_t(dims);
+		std::size_t tasks = (cells + intern::JoinCellsPerTask - 1) / intern::JoinCellsPerTask;
+		if (scratch.tasks.size() < tasks) {
+			scratch.tasks.resize(tasks);
+		}
+
+		exec(tasks, [&](std::size_t task) {
+			intern::JoinTask& buffers = scratch.tasks[task];
+			std::vector<std::uint32_t>& la = buffers.a, & lb = buffers.b;
+			buffers.pairs.clear();
+			std::size_t begin = task * intern::JoinCellsPerTask, end = std::min(cells, begin + intern::JoinCellsPerTask);
+			for (std::size_t c = begin; c < end; ++c) {
+				if (ca.offsets[c] == ca.offsets[c + 1] || cb.offsets[c] == cb.offsets[c + 1]) {
+					continue;
+				}
+				la.assign(ca.items.begin() + ca.offsets[c], ca.items.begin() + ca.offsets[c + 1]);
+				lb.assign(cb.items.begin() + cb.offsets[c], cb.items.begin() + cb.offsets[c + 1]);
+				intern::join_cell(a, b, grid, int(c % std::size_t(dims)), int(c / std::size_t(dims)), la, lb, buffers.pairs);
+			}
+		});
+
+		std::size_t start = pairs.size(), total = 0;
+		for (std::size_t t = 0; t < tasks; ++t) {
+			total += scratch.tasks[t].pairs.size();
+		}
+		pairs.reserve(start + total);
+		for (std::size_t t = 0; t < tasks; ++t) {
+			const std::vector<IndexPair>& buffer = scratch.tasks[t].pairs;
+			pairs.insert(pairs.end(), buffer.begin(), buffer.end());
+		}
+		return total;
+	}
+	template<typename T, typename Exec>
+	std::size_t spatial_join(const MMRectSoA<T, 2>& a, const MMRectSoA<T, 2>& b, std::vector<IndexPair>& pairs, Exec&& exec, int dims = 0) {
+		JoinScratch scratch;
+		return spatial_join(a, b, pairs, exec, scratch, dims);
+	}
+	template<typename T>
+	std::size_t spatial_join(const MMRectSoA<T, 2>& a, const MMRectSoA<T, 2>& b, std::vector<IndexPair>& pairs) {
+		return spatial_join(a, b, pairs, default_pool());
+	}
+};
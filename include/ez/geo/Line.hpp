@@ -14,7 +14,7 @@ namespace ez {
 		{}
 		Line(const vec_t& p0, const vec_t& p1)
 			: start(p0)
-			, end(p0)
+			, end(p1)
 		{}
 
 		~Line() = default;
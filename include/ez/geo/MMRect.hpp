@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <ez/math/constants.hpp>
 
+#include "Stats.hpp"
+
 namespace ez {
 	// Define a MMRect, a rect with min max points in absolute coordinates instead of one absolute and one relative.
 	template<typename T, glm::length_t N, bool inclusive = false>
@@ -218,12 +220,16 @@ namespace ez {
 
 
 		self_t& merge(const self_t& other) noexcept {
+			EZ_GEO_STAT_EVENT(RectMerge);
+
 			cvt(max) = glm::max(cvt(max), cvt(other.max));
 			cvt(min) = glm::min(cvt(min), cvt(other.min));
 
 			return *this;
 		};
 		self_t& merge(const vec_t& point) noexcept {
+			EZ_GEO_STAT_EVENT(RectMerge);
+
 			cvt(max) = glm::max(cvt(max), cvt(point));
 			cvt(min) = glm::min(cvt(min), cvt(point));
 
@@ -281,6 +287,8 @@ namespace ez {
 		};
 		
 		bool contains(const vec_t& point) const noexcept {
+			EZ_GEO_STAT_EVENT(RectContains);
+
 			if constexpr (inclusive) {
 				if constexpr (is_floating_point) {
 					return
@@ -308,6 +316,8 @@ namespace ez {
 		};
 
 		bool contains(const self_t& other) const noexcept {
+			EZ_GEO_STAT_EVENT(RectContains);
+
 			if constexpr (is_floating_point) {
 				return !(
 					glm::any(glm::greaterThan(cvt(min) - cvt(other.min), Eps())) ||
@@ -0,0 +1,587 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "MMRect.hpp"
+#include "RTree.hpp"
+#include "Stats.hpp"
+#include "intern/MappedFile.hpp"
+
+/*
+Out of core R-tree, stored in a file and memory mapped for queries, for sets of rects that do not fit in memory.
+
+MappedRTreeBuilder takes the rects one at a time and writes the tree file. The rects are sorted on the first axis with an
+external merge sort: sorted runs of a bounded size are spilled to temporary files next to the output, then merged.
+The merged stream is cut into the slabs of Sort-Tile-Recursive, each slab is tiled in memory over the remaining axes and
+written out as leaves, and the levels above are built in memory from the leaf bounds. The memory used is a run, a slab and
+one rect per leaf, a slab holds about sqrt(count * Fanout) rects in 2d.
+
+Every node fills exactly one page of the file, so a node is never split across two pages and a query touches one page per node.
+MappedRTree maps the file read only. The kernel pages nodes in on demand, so the resident set stays bounded by what the
+queries touch, and the children a query is about to descend into are prefetched with madvise (PrefetchVirtualMemory on windows).
+
+The file layout depends on the value type, the dimension and the endianness, it is not meant to move between platforms.
+Errors are reported by returning false, files with a header that does not match the tree type are rejected on open.
+*/
+
+namespace ez {
+	namespace intern {
+		static constexpr std::size_t MappedPageSize = 4096;
+		static constexpr std::uint32_t MappedVersion = 1;
+		static constexpr char MappedMagic[8] = { 'E', 'Z', 'R', 'T', 'R', 'E', 'E', '\0' };
+
+		// Levels of the deepest tree with 64 bit ids, each level has the nodes of the one below divided by the fanout.
+		constexpr std::size_t mapped_levels(std::size_t fanout) noexcept {
+			std::size_t levels = 0;
+			for (std::uint64_t count = ~std::uint64_t(0); count > 1; count = (count - 1) / fanout + 1) {
+				++levels;
+			}
+			return levels;
+		}
+
+		template<typename T, glm::length_t N>
+		struct MappedLayout {
+			// Children per node, as many as fit in a page next to the count and leaf flag.
+			static constexpr std::size_t Fanout = (MappedPageSize - 8) / (2 * N * sizeof(T) + sizeof(std::uint64_t));
+			static constexpr std::size_t MaxLevels = mapped_levels(Fanout);
+
+			struct Node {
+				std::uint32_t count;
+				std::uint32_t leaf;
+				T min[N][Fanout];
+				T max[N][Fanout];
+				// Node indices in inner nodes, rect ids in leaves.
+				std::uint64_t child[Fanout];
+			};
+			static_assert(sizeof(Node) <= MappedPageSize, "A mapped node must fit in a page!");
+
+			struct Header {
+				char magic[8];
+				std::uint32_t version;
+				std::uint32_t dims;
+				std::uint32_t valueSize;
+				std::uint32_t fanout;
+				std::uint64_t items;
+				std::uint64_t nodes;
+				std::uint64_t levels;
+				T min[N];
+				T max[N];
+			};
+			static_assert(sizeof(Header) <= MappedPageSize, "The mapped header must fit in a page!");
+
+			struct Record {
+				MMRect<T, N> rect;
+				std::uint64_t id;
+			};
+		};
+	}
+
+	template<typename T, glm::length_t N>
+	class MappedRTreeBuilder {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::MappedRTreeBuilder requires a floating point value type!");
+		using rect_t = MMRect<T, N>;
+		using layout_t = intern::MappedLayout<T, N>;
+		using node_t = typename layout_t::Node;
+		using record_t = typename layout_t::Record;
+		static constexpr std::size_t Fanout = layout_t::Fanout;
+
+		// Path is the file the tree is written to, the temporary runs use the same path with a suffix.
+		// RunSize is the number of rects held in memory before a sorted run is spilled to disk.
+		MappedRTreeBuilder(const std::string& _path, std::size_t _runSize = std::size_t(1) << 22)
+			: path(_path)
+			, runSize(std::max<std::size_t>(_runSize, Fanout))
+			, items(0)
+			, failed(false)
+		{}
+		~MappedRTreeBuilder() {
+			removeRuns();
+		}
+		MappedRTreeBuilder(const MappedRTreeBuilder&) = delete;
+		MappedRTreeBuilder& operator=(const MappedRTreeBuilder&) = delete;
+
+		// The number of rects added so far.
+		std::size_t size() const noexcept {
+			return items;
+		}
+
+		// Add a rect, queries report it by the number of rects added before it.
+		bool add(const rect_t& rect) {
+			return add(rect, items);
+		}
+		// Add a rect reported by the given id.
+		bool add(const rect_t& rect, std::uint64_t id) {
+			if (failed) {
+				return false;
+			}
+			buffer.push_back(record_t{ rect, id });
+			++items;
+			if (buffer.size() >= runSize) {
+				failed = !spill();
+			}
+			return !failed;
+		}
+
+		// Sort the rects, write the tree file and remove the temporary runs. Returns false when any file operation failed.
+		bool finish() {
+			if (failed) {
+				removeRuns();
+				return false;
+			}
+			std::FILE* file = std::fopen(path.c_str(), "wb");
+			if (!file) {
+				removeRuns();
+				return false;
+			}
+			bool ok = write(file);
+			ok &= std::fclose(file) == 0;
+			removeRuns();
+			buffer.clear();
+			buffer.shrink_to_fit();
+			return ok;
+		}
+	private:
+		static T center(const record_t& record, int axis) noexcept {
+			return record.rect.min[axis] + record.rect.max[axis];
+		}
+		static bool before(const record_t& l, const record_t& r) noexcept {
+			T a = center(l, 0), b = center(r, 0);
+			return a < b || (a == b && l.id < r.id);
+		}
+
+		std::string runPath(std::size_t index) const {
+			return path + ".run" + std::to_string(index);
+		}
+		void removeRuns() {
+			for (std::size_t i = 0; i < runs; ++i) {
+				std::remove(runPath(i).c_str());
+			}
+			runs = 0;
+		}
+
+		// Sort the buffered rects on the first axis and write them to a new run.
+		bool spill() {
+			std::sort(buffer.begin(), buffer.end(), before);
+			std::FILE* file = std::fopen(runPath(runs).c_str(), "wb");
+			if (!file) {
+				return false;
+			}
+			++runs;
+			bool ok = std::fwrite(buffer.data(), sizeof(record_t), buffer.size(), file) == buffer.size();
+			ok &= std::fclose(file) == 0;
+			buffer.clear();
+			return ok;
+		}
+
+		// Streams the records in the sorted order of the first axis, merging the runs when the rects did not fit in a single one.
+		class Merger {
+		public:
+			Merger(MappedRTreeBuilder& builder)
+				: owner(builder)
+			{}
+			~Merger() {
+				for (Input& in : inputs) {
+					if (in.file) {
+						std::fclose(in.file);
+					}
+				}
+			}
+
+			bool open() {
+				if (owner.runs == 0) {
+					std::sort(owner.buffer.begin(), owner.buffer.end(), before);
+					return true;
+				}
+				if (!owner.buffer.empty() && !owner.spill()) {
+					return false;
+				}
+				// Split the memory of a run between the read buffers of the runs.
+				std::size_t block = std::max<std::size_t>(owner.runSize / owner.runs, 256);
+				inputs.resize(owner.runs);
+				for (std::size_t i = 0; i < owner.runs; ++i) {
+					Input& in = inputs[i];
+					in.file = std::fopen(owner.runPath(i).c_str(), "rb");
+					if (!in.file) {
+						return false;
+					}
+					in.block.resize(block);
+					if (!refill(in)) {
+						return false;
+					}
+					if (in.cursor != in.block.size()) {
+						heap.push_back(i);
+					}
+				}
+				std::make_heap(heap.begin(), heap.end(), [this](std::size_t l, std::size_t r) {
+					return after(l, r);
+				});
+				return true;
+			}
+
+			// Copy up to count records into out, returns the number copied, less than count only at the end of the stream.
+			std::size_t read(record_t* out, std::size_t count) {
+				if (inputs.empty()) {
+					std::size_t n = std::min(count, owner.buffer.size() - memory);
+					std::copy(owner.buffer.begin() + memory, owner.buffer.begin() + memory + n, out);
+					memory += n;
+					return n;
+				}
+
+				auto cmp = [this](std::size_t l, std::size_t r) {
+					return after(l, r);
+				};
+				std::size_t n = 0;
+				while (n < count && !heap.empty() && !error) {
+					std::pop_heap(heap.begin(), heap.end(), cmp);
+					Input& in = inputs[heap.back()];
+					out[n++] = in.block[in.cursor++];
+					if (in.cursor == in.block.size()) {
+						error |= !refill(in);
+					}
+					if (in.cursor == in.block.size()) {
+						heap.pop_back();
+					}
+					else {
+						std::push_heap(heap.begin(), heap.end(), cmp);
+					}
+				}
+				return n;
+			}
+
+			bool failed() const noexcept {
+				return error;
+			}
+		private:
+			struct Input {
+				std::FILE* file = nullptr;
+				std::vector<record_t> block;
+				std::size_t cursor = 0;
+			};
+
+			// Heap order, the run with the smallest head record on top.
+			bool after(std::size_t l, std::size_t r) const noexcept {
+				const Input& a = inputs[l], & b = inputs[r];
+				return before(b.block[b.cursor], a.block[a.cursor]);
+			}
+
+			bool refill(Input& in) {
+				in.block.resize(in.block.capacity());
+				std::size_t n = std::fread(in.block.data(), sizeof(record_t), in.block.size(), in.file);
+				in.block.resize(n);
+				in.cursor = 0;
+				return n != 0 || std::feof(in.file);
+			}
+
+			MappedRTreeBuilder& owner;
+			std::vector<Input> inputs;
+			std::vector<std::size_t> heap;
+			std::size_t memory = 0;
+			bool error = false;
+		};
+
+		static bool writeNode(std::FILE* file, const node_t& node) {
+			unsigned char page[intern::MappedPageSize] = {};
+			std::memcpy(page, &node, sizeof(node_t));
+			return std::fwrite(page, 1, sizeof(page), file) == sizeof(page);
+		}
+
+		// Fill a node from a run of children and return their bounds.
+		template<typename F>
+		static rect_t fill(node_t& node, std::size_t count, bool leaf, F&& child) {
+			node = node_t{};
+			node.count = static_cast<std::uint32_t>(count);
+			node.leaf = leaf;
+			rect_t bound;
+			for (std::size_t c = 0; c < count; ++c) {
+				rect_t rect;
+				node.child[c] = child(c, rect);
+				for (int k = 0; k < N; ++k) {
+					node.min[k][c] = rect.min[k];
+					node.max[k][c] = rect.max[k];
+				}
+				if (c == 0) {
+					bound = rect;
+				}
+				else {
+					bound.merge(rect);
+				}
+			}
+			return bound;
+		}
+
+		bool write(std::FILE* file) {
+			typename layout_t::Header header{};
+			std::memcpy(header.magic, intern::MappedMagic, sizeof(header.magic));
+			header.version = intern::MappedVersion;
+			header.dims = N;
+			header.valueSize = sizeof(T);
+			header.fanout = Fanout;
+			header.items = items;
+
+			// The header page is written last, once the counts are known.
+			unsigned char page[intern::MappedPageSize] = {};
+			if (std::fwrite(page, 1, sizeof(page), file) != sizeof(page)) {
+				return false;
+			}
+
+			Merger merger{ *this };
+			if (!merger.open()) {
+				return false;
+			}
+
+			// Leaves, one slab of the first axis at a time.
+			std::size_t leaves = (items + Fanout - 1) / Fanout;
+			std::size_t slabs = static_cast<std::size_t>(std::ceil(std::pow(double(leaves), 1.0 / double(N))));
+			std::size_t slabSize = leaves == 0 ? 0 : ((leaves + slabs - 1) / slabs) * Fanout;
+
+			std::vector<record_t> slab(slabSize);
+			std::vector<rect_t> level;
+			level.reserve(leaves);
+			node_t node;
+			for (std::size_t done = 0; done < items;) {
+				std::size_t count = merger.read(slab.data(), std::min(slabSize, items - done));
+				if (count == 0 || merger.failed()) {
+					return false;
+				}
+				done += count;
+				intern::str_tile(slab.data(), slab.data() + count, 1, N, (count + Fanout - 1) / Fanout, Fanout, center);
+
+				for (std::size_t begin = 0; begin < count; begin += Fanout) {
+					const record_t* run = slab.data() + begin;
+					level.push_back(fill(node, std::min(Fanout, count - begin), true, [run](std::size_t c, rect_t& rect) {
+						rect = run[c].rect;
+						return run[c].id;
+					}));
+					if (!writeNode(file, node)) {
+						return false;
+					}
+				}
+			}
+			slab = std::vector<record_t>{};
+
+			// The levels above, in memory, until a single node is left.
+			std::uint64_t first = 0, written = level.size();
+			header.levels = items == 0 ? 0 : 1;
+			std::vector<std::uint64_t> order;
+			while (level.size() > 1) {
+				order.resize(level.size());
+				for (std::size_t i = 0; i < order.size(); ++i) {
+					order[i] = i;
+				}
+				intern::str_tile(order.begin(), order.end(), 0, N, (level.size() + Fanout - 1) / Fanout, Fanout, [&level](std::uint64_t i, int axis) {
+					return level[i].min[axis] + level[i].max[axis];
+				});
+
+				std::vector<rect_t> above;
+				above.reserve((level.size() + Fanout - 1) / Fanout);
+				for (std::size_t begin = 0; begin < order.size(); begin += Fanout) {
+					above.push_back(fill(node, std::min(Fanout, order.size() - begin), false, [&](std::size_t c, rect_t& rect) {
+						std::uint64_t index = order[begin + c];
+						rect = level[index];
+						return first + index;
+					}));
+					if (!writeNode(file, node)) {
+						return false;
+					}
+				}
+				first = written;
+				written += above.size();
+				level.swap(above);
+				++header.levels;
+			}
+
+			header.nodes = written;
+			if (!level.empty()) {
+				for (int k = 0; k < N; ++k) {
+					header.min[k] = level[0].min[k];
+					header.max[k] = level[0].max[k];
+				}
+			}
+			std::memcpy(page, &header, sizeof(header));
+			return
+				std::fseek(file, 0, SEEK_SET) == 0 &&
+				std::fwrite(page, 1, sizeof(page), file) == sizeof(page);
+		}
+
+		std::string path;
+		std::size_t runSize;
+		std::size_t runs = 0;
+		std::size_t items;
+		std::vector<record_t> buffer;
+		bool failed;
+	};
+
+	template<typename T, glm::length_t N>
+	class MappedRTree {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::MappedRTree requires a floating point value type!");
+		using rect_t = MMRect<T, N>;
+		using vec_t = glm::vec<N, T>;
+		using layout_t = intern::MappedLayout<T, N>;
+		using node_t = typename layout_t::Node;
+		static constexpr std::size_t Fanout = layout_t::Fanout;
+
+		MappedRTree() = default;
+
+		// Map a file written by MappedRTreeBuilder, returns false when it is missing, truncated or was built for another tree type.
+		// Only the header is checked, queries on a file whose nodes are damaged return incomplete results but stay within the mapping.
+		bool open(const std::string& path) {
+			close();
+			if (!file.open(path) || file.size() < intern::MappedPageSize) {
+				file.close();
+				return false;
+			}
+			std::memcpy(&header, file.data(), sizeof(header));
+			bool valid =
+				std::memcmp(header.magic, intern::MappedMagic, sizeof(header.magic)) == 0 &&
+				header.version == intern::MappedVersion &&
+				header.dims == N &&
+				header.valueSize == sizeof(T) &&
+				header.fanout == Fanout &&
+				header.levels <= layout_t::MaxLevels &&
+				file.size() / intern::MappedPageSize >= header.nodes + 1;
+			if (!valid) {
+				close();
+			}
+			return valid;
+		}
+		void close() noexcept {
+			file.close();
+			header = typename layout_t::Header{};
+		}
+		bool isOpen() const noexcept {
+			return file.isOpen();
+		}
+
+		std::size_t size() const noexcept {
+			return static_cast<std::size_t>(header.items);
+		}
+		bool empty() const noexcept {
+			return header.items == 0;
+		}
+		std::size_t nodeCount() const noexcept {
+			return static_cast<std::size_t>(header.nodes);
+		}
+		std::size_t depth() const noexcept {
+			return static_cast<std::size_t>(header.levels);
+		}
+		rect_t bounds() const noexcept {
+			rect_t ret;
+			for (int k = 0; k < N; ++k) {
+				ret.min[k] = header.min[k];
+				ret.max[k] = header.max[k];
+			}
+			return ret;
+		}
+
+		// Whether the children a query descends into are prefetched, on by default.
+		// Worth turning off when the whole file is expected to stay resident.
+		void setPrefetch(bool enable) noexcept {
+			prefetch = enable;
+		}
+
+		// Appends the ids of the rects overlapping the region, returns the number of ids appended.
+		std::size_t query(const rect_t& region, std::vector<std::uint64_t>& out) const {
+			std::size_t start = out.size();
+			walk([&](const node_t& node, std::size_t c) {
+				bool overlap = true;
+				for (int k = 0; k < N; ++k) {
+					overlap &= (node.min[k][c] < region.max[k]) & (region.min[k] < node.max[k][c]);
+				}
+				return overlap;
+			}, out);
+			return out.size() - start;
+		}
+
+		// Appends the ids of the rects containing the point, returns the number of ids appended.
+		std::size_t query(const vec_t& point, std::vector<std::uint64_t>& out) const {
+			std::size_t start = out.size();
+			walk([&](const node_t& node, std::size_t c) {
+				rect_t rect;
+				for (int k = 0; k < N; ++k) {
+					rect.min[k] = node.min[k][c];
+					rect.max[k] = node.max[k][c];
+				}
+				return rect.contains(point);
+			}, out);
+			return out.size() - start;
+		}
+	private:
+		const node_t& node(std::uint64_t index) const noexcept {
+			return *reinterpret_cast<const node_t*>(file.data() + (index + 1) * intern::MappedPageSize);
+		}
+
+		template<typename F>
+		void walk(F&& test, std::vector<std::uint64_t>& out) const {
+			if (!file.isOpen() || header.nodes == 0) {
+				return;
+			}
+			EZ_GEO_STAT_EVENT(Query);
+
+			// Each inner level pushes at most Fanout entries and pops one, and open rejects trees deeper than MaxLevels.
+			static constexpr std::size_t StackSize = (layout_t::MaxLevels - 1) * (Fanout - 1) + 1;
+			std::uint64_t stack[StackSize];
+			std::size_t top = 0;
+			stack[top++] = header.nodes - 1;
+			while (top != 0) {
+				std::uint64_t index = stack[--top];
+				const node_t& current = node(index);
+
+				// The nodes come from disk and only the header is checked by open, so a damaged page must not lead the walk
+				// out of its buffers. The builder writes children before their parent, so a child index at or above the index
+				// of its parent is invalid, which also rules out cycles.
+				std::size_t count = std::min<std::size_t>(current.count, Fanout);
+				bool pass[Fanout];
+				for (std::size_t c = 0; c < count; ++c) {
+					pass[c] = test(current, c);
+				}
+
+				if (current.leaf) {
+					EZ_GEO_STAT_EVENT(LeafVisit);
+					for (std::size_t c = 0; c < count; ++c) {
+						if (pass[c]) {
+							out.push_back(current.child[c]);
+						}
+					}
+					continue;
+				}
+
+				EZ_GEO_STAT_EVENT(NodeVisit);
+				for (std::size_t c = count; c-- > 0;) {
+					if (!pass[c]) {
+						EZ_GEO_STAT_EVENT(EarlyOut);
+						continue;
+					}
+					if (current.child[c] >= index || top == StackSize) {
+						continue;
+					}
+					// Ask for the pages of every child passing the test before descending, so they are read while the first one is processed.
+					if (prefetch) {
+						file.willNeed((current.child[c] + 1) * intern::MappedPageSize, intern::MappedPageSize);
+					}
+					stack[top++] = current.child[c];
+				}
+			}
+		}
+
+		intern::MappedFile file;
+		typename layout_t::Header header{};
+		bool prefetch = true;
+	};
+
+	template<typename T>
+	using MappedRTree2 = MappedRTree<T, 2>;
+	template<typename T>
+	using MappedRTree3 = MappedRTree<T, 3>;
+	template<typename T>
+	using MappedRTreeBuilder2 = MappedRTreeBuilder<T, 2>;
+	template<typename T>
+	using MappedRTreeBuilder3 = MappedRTreeBuilder<T, 3>;
+};
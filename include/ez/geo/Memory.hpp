@@ -0,0 +1,253 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <memory_resource>
+
+/*
+Memory resources for the structures of the library.
+
+The structures that own memory (RTree, Delaunay2, Polygon2) take a std::pmr::memory_resource, and keep the capacity of their
+buffers between builds, so once they have grown to the size of the data a rebuild allocates nothing.
+Query scratch that can't be kept in the structure, like the heap of RTree::nearest, starts in a small buffer on the stack
+and only goes to the resource of the structure when it outgrows it.
+The exact fallback of the predicates Delaunay2 relies on keeps its terms on the stack, so it never allocates either.
+
+ArenaResource is a bump allocator with frame reset: deallocation does nothing and reset frees everything at once.
+FixedPoolResource hands out blocks of a single size from a free list, for node based containers.
+Neither is synchronized, each thread should have its own, thread_arena and thread_pool_resource give one per thread.
+Memory from a resource must be released before reset or release is called on it, or before the thread that owns it exits.
+*/
+
+namespace ez {
+	class ArenaResource : public std::pmr::memory_resource {
+	public:
+		// Initial is the size of the first block, later blocks double in size.
+		explicit ArenaResource(std::size_t initial = std::size_t(1) << 16, std::pmr::memory_resource* _upstream = std::pmr::new_delete_resource()) noexcept
+			: upstream(_upstream)
+			, head(nullptr)
+			, cursor(nullptr)
+			, limit(nullptr)
+			, next(std::max<std::size_t>(initial, 256))
+		{}
+		~ArenaResource() {
+			release();
+		}
+		ArenaResource(const ArenaResource&) = delete;
+		ArenaResource& operator=(const ArenaResource&) = delete;
+
+		// Free every allocation at once. When the last frame needed more than one block, they are replaced by a single block
+		// as large as all of them together, so the same frame fits in one block next time.
+		void reset() {
+			if (head && head->next) {
+				std::size_t total = 0;
+				for (Block* block = head; block; block = block->next) {
+					total += block->size;
+				}
+				release();
+				next = total;
+				grow(0, 1);
+			}
+			else if (head) {
+				cursor = data(head);
+			}
+		}
+
+		// Return all the blocks to the upstream resource.
+		void release() noexcept {
+			while (head) {
+				Block* block = head;
+				head = head->next;
+				upstream->deallocate(block, block->size, alignof(Block));
+			}
+			cursor = limit = nullptr;
+		}
+
+		// Bytes handed out since the last reset, including alignment padding, and bytes held from upstream.
+		std::size_t used() const noexcept {
+			std::size_t total = head ? std::size_t(cursor - data(head)) : 0;
+			for (Block* block = head ? head->next : nullptr; block; block = block->next) {
+				total += block->used;
+			}
+			return total;
+		}
+		std::size_t capacity() const noexcept {
+			std::size_t total = 0;
+			for (Block* block = head; block; block = block->next) {
+				total += block->size - sizeof(Block);
+			}
+			return total;
+		}
+
+		std::pmr::memory_resource* upstreamResource() const noexcept {
+			return upstream;
+		}
+	private:
+		struct alignas(std::max_align_t) Block {
+			Block* next;
+			std::size_t size;
+			// Bytes used in the block when a newer one was started.
+			std::size_t used;
+		};
+
+		static unsigned char* data(Block* block) noexcept {
+			return reinterpret_cast<unsigned char*>(block + 1);
+		}
+
+		void grow(std::size_t bytes, std::size_t alignment) {
+			if (head) {
+				head->used = std::size_t(cursor - data(head));
+			}
+			std::size_t size = std::max(next, bytes + alignment + sizeof(Block));
+			Block* block = static_cast<Block*>(upstream->allocate(size, alignof(Block)));
+			block->next = head;
+			block->size = size;
+			block->used = 0;
+			head = block;
+			cursor = data(block);
+			limit = reinterpret_cast<unsigned char*>(block) + size;
+			next = size * 2;
+		}
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			std::uintptr_t at = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~std::uintptr_t(alignment - 1);
+			if (!cursor || at + bytes > reinterpret_cast<std::uintptr_t>(limit)) {
+				grow(bytes, alignment);
+				at = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~std::uintptr_t(alignment - 1);
+			}
+			cursor = reinterpret_cast<unsigned char*>(at + bytes);
+			return reinterpret_cast<void*>(at);
+		}
+		void do_deallocate(void*, std::size_t, std::size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+		std::pmr::memory_resource* upstream;
+		Block* head;
+		unsigned char* cursor;
+		unsigned char* limit;
+		std::size_t next;
+	};
+
+	class FixedPoolResource : public std::pmr::memory_resource {
+	public:
+		// Allocations up to blockSize bytes and blockAlign alignment come from the pool, larger ones go to the upstream resource.
+		// The pool takes chunks of blocksPerChunk blocks from upstream and only gives them back on release.
+		explicit FixedPoolResource(std::size_t blockSize, std::size_t _blockAlign = alignof(std::max_align_t), std::size_t _blocksPerChunk = 256,
+			std::pmr::memory_resource* _upstream = std::pmr::new_delete_resource()) noexcept
+			: upstream(_upstream)
+			, blockAlign(std::max(_blockAlign, alignof(Free)))
+			, stride(((std::max(blockSize, sizeof(Free)) + blockAlign - 1) / blockAlign) * blockAlign)
+			, blocksPerChunk(std::max<std::size_t>(_blocksPerChunk, 1))
+			, limit(blockSize)
+			, free(nullptr)
+			, chunks(nullptr)
+		{}
+		~FixedPoolResource() {
+			release();
+		}
+		FixedPoolResource(const FixedPoolResource&) = delete;
+		FixedPoolResource& operator=(const FixedPoolResource&) = delete;
+
+		void release() noexcept {
+			while (chunks) {
+				Chunk* chunk = chunks;
+				chunks = chunks->next;
+				upstream->deallocate(chunk, chunkSize(), chunkAlign());
+			}
+			free = nullptr;
+		}
+
+		std::size_t blockSize() const noexcept {
+			return limit;
+		}
+		std::pmr::memory_resource* upstreamResource() const noexcept {
+			return upstream;
+		}
+	private:
+		struct Free {
+			Free* next;
+		};
+		struct Chunk {
+			Chunk* next;
+		};
+
+		std::size_t chunkAlign() const noexcept {
+			return std::max(blockAlign, alignof(Chunk));
+		}
+		// The chunk header is padded to the block alignment so the first block is aligned.
+		std::size_t headerSize() const noexcept {
+			return ((sizeof(Chunk) + chunkAlign() - 1) / chunkAlign()) * chunkAlign();
+		}
+		std::size_t chunkSize() const noexcept {
+			return headerSize() + stride * blocksPerChunk;
+		}
+
+		void refill() {
+			Chunk* chunk = static_cast<Chunk*>(upstream->allocate(chunkSize(), chunkAlign()));
+			chunk->next = chunks;
+			chunks = chunk;
+			unsigned char* first = reinterpret_cast<unsigned char*>(chunk) + headerSize();
+			for (std::size_t i = blocksPerChunk; i-- > 0;) {
+				Free* block = reinterpret_cast<Free*>(first + i * stride);
+				block->next = free;
+				free = block;
+			}
+		}
+
+		bool pooled(std::size_t bytes, std::size_t alignment) const noexcept {
+			return bytes <= limit && alignment <= blockAlign;
+		}
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			if (!pooled(bytes, alignment)) {
+				return upstream->allocate(bytes, alignment);
+			}
+			if (!free) {
+				refill();
+			}
+			Free* block = free;
+			free = block->next;
+			return block;
+		}
+		void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+			if (!pooled(bytes, alignment)) {
+				upstream->deallocate(ptr, bytes, alignment);
+				return;
+			}
+			Free* block = static_cast<Free*>(ptr);
+			block->next = free;
+			free = block;
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+		std::pmr::memory_resource* upstream;
+		std::size_t blockAlign;
+		std::size_t stride;
+		std::size_t blocksPerChunk;
+		std::size_t limit;
+		Free* free;
+		Chunk* chunks;
+	};
+
+	// The arena of the calling thread.
+	inline ArenaResource& thread_arena() {
+		thread_local ArenaResource arena;
+		return arena;
+	}
+
+	// The FixedPoolResource of the calling thread for blocks of Size bytes and Align alignment, not to be confused with ThreadPool.
+	template<std::size_t Size, std::size_t Align = alignof(std::max_align_t)>
+	FixedPoolResource& thread_pool_resource() {
+		thread_local FixedPoolResource pool{ Size, Align };
+		return pool;
+	}
+
+	namespace intern {
+		// Bytes of stack buffer given to the scratch of a query before it falls back to the resource of the structure.
+		static constexpr std::size_t QueryStackBytes = 4096;
+	}
+};
@@ -0,0 +1,209 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "MMRect.hpp"
+#include "Sphere.hpp"
+#include "SoA.hpp"
+#include "Transform.hpp"
+#include "TransformBounds.hpp"
+
+/*
+Swept bounds, the world space box enclosing a local shape while its transform moves from one state to the next,
+for broadphase pairs that account for motion.
+
+The motion is the one of slerp_batch: origin and scale move linearly, the rotation turns at a constant rate along the
+shortest arc. Over such a motion a local point stays within r * (1 - cos(angle / 2)) of the straight line between its
+two end positions, where r is its distance from the origin and angle is the rotation between the two states, and cos(angle / 2)
+is simply the absolute dot product of the two quaternions. So the swept bounds are the world bounds at both ends,
+padded by that distance for the point of the shape farthest from the origin. No trigonometry and no sampling.
+
+When the scale changes the end bounds alone no longer enclose the path, the bounds then combine both rotations with
+both scales, which is still conservative but looser. The quaternions are expected to be normalized.
+*/
+
+namespace ez {
+	namespace intern {
+		// Bounds of the local box lo, hi after scaling then rotating by m, relative to the origin, merged into min, max.
+		template<typename T>
+		void rotated_box(const T m[3][3], const T s[3], const T lo[3], const T hi[3], T min[3], T max[3]) noexcept {
+			T center[3], half[3];
+			for (int k = 0; k < 3; ++k) {
+				center[k] = (lo[k] + hi[k]) * T(0.5) * s[k];
+				half[k] = std::abs((hi[k] - lo[k]) * T(0.5) * s[k]);
+			}
+			for (int r = 0; r < 3; ++r) {
+				T c = m[r][0] * center[0] + m[r][1] * center[1] + m[r][2] * center[2];
+				T e = std::abs(m[r][0]) * half[0] + std::abs(m[r][1]) * half[1] + std::abs(m[r][2]) * half[2];
+				min[r] = std::min(min[r], c - e);
+				max[r] = std::max(max[r], c + e);
+			}
+		}
+
+		// Swept bounds of the local box lo, hi between two states given as origin, rotation (x, y, z, w) and scale.
+		template<typename T>
+		void swept_box(const T lo[3], const T hi[3],
+			const T o0[3], const T q0[4], const T s0[3],
+			const T o1[3], const T q1[4], const T s1[3],
+			T min[3], T max[3]) noexcept
+		{
+			T m0[3][3], m1[3][3];
+			quat_matrix(q0[0], q0[1], q0[2], q0[3], m0);
+			quat_matrix(q1[0], q1[1], q1[2], q1[3], m1);
+
+			// Sagitta of the rotation, for the corner farthest from the origin at either scale.
+			T cosine = std::min(std::abs(q0[0] * q1[0] + q0[1] * q1[1] + q0[2] * q1[2] + q0[3] * q1[3]), T(1));
+			T radius = T(0);
+			for (int k = 0; k < 3; ++k) {
+				T s = std::max(std::abs(s0[k]), std::abs(s1[k]));
+				T r = std::max(std::abs(lo[k]), std::abs(hi[k])) * s;
+				radius += r * r;
+			}
+			T pad = std::sqrt(radius) * (T(1) - cosine);
+
+			bool same = (s0[0] == s1[0]) & (s0[1] == s1[1]) & (s0[2] == s1[2]);
+			if (same) {
+				T a[3], amax[3], b[3], bmax[3];
+				for (int k = 0; k < 3; ++k) {
+					a[k] = b[k] = std::numeric_limits<T>::max();
+					amax[k] = bmax[k] = std::numeric_limits<T>::lowest();
+				}
+				rotated_box(m0, s0, lo, hi, a, amax);
+				rotated_box(m1, s1, lo, hi, b, bmax);
+				for (int k = 0; k < 3; ++k) {
+					min[k] = std::min(o0[k] + a[k], o1[k] + b[k]) - pad;
+					max[k] = std::max(o0[k] + amax[k], o1[k] + bmax[k]) + pad;
+				}
+				return;
+			}
+
+			// The scaled and rotated point is a convex blend of the four pairings of rotation and scale, and the origin of its two ends.
+			T rmin[3], rmax[3];
+			for (int k = 0; k < 3; ++k) {
+				rmin[k] = std::numeric_limits<T>::max();
+				rmax[k] = std::numeric_limits<T>::lowest();
+			}
+			rotated_box(m0, s0, lo, hi, rmin, rmax);
+			rotated_box(m0, s1, lo, hi, rmin, rmax);
+			rotated_box(m1, s0, lo, hi, rmin, rmax);
+			rotated_box(m1, s1, lo, hi, rmin, rmax);
+			for (int k = 0; k < 3; ++k) {
+				min[k] = std::min(o0[k], o1[k]) + rmin[k] - pad;
+				max[k] = std::max(o0[k], o1[k]) + rmax[k] + pad;
+			}
+		}
+
+		template<typename T>
+		void transform_parts(const Transform<T, 3>& form, T o[3], T q[4], T s[3]) noexcept {
+			for (int k = 0; k < 3; ++k) {
+				o[k] = form.origin[k];
+				s[k] = form.size[k];
+			}
+			q[0] = form.rotation.x;
+			q[1] = form.rotation.y;
+			q[2] = form.rotation.z;
+			q[3] = form.rotation.w;
+		}
+		template<typename T>
+		void transform_parts(const TransformSoA<T>& forms, std::size_t index, T o[3], T q[4], T s[3]) noexcept {
+			for (int k = 0; k < 3; ++k) {
+				o[k] = forms.origin.data(k)[index];
+				s[k] = forms.scale.data(k)[index];
+			}
+			for (int k = 0; k < 4; ++k) {
+				q[k] = forms.rotation.data(k)[index];
+			}
+		}
+	}
+
+	// Bounds of the local box over the motion from one transform to the other.
+	template<typename T>
+	MMRect<T, 3> swept_bounds(const MMRect<T, 3>& local, const Transform<T, 3>& from, const Transform<T, 3>& to) noexcept {
+		T o0[3], q0[4], s0[3], o1[3], q1[4], s1[3];
+		intern::transform_parts(from, o0, q0, s0);
+		intern::transform_parts(to, o1, q1, s1);
+		T lo[3] = { local.min.x, local.min.y, local.min.z }, hi[3] = { local.max.x, local.max.y, local.max.z };
+
+		T min[3], max[3];
+		intern::swept_box(lo, hi, o0, q0, s0, o1, q1, s1, min, max);
+		return MMRect<T, 3>{ glm::tvec3<T>{ min[0], min[1], min[2] }, glm::tvec3<T>{ max[0], max[1], max[2] } };
+	}
+
+	// Bounds of the local sphere over the motion. Under a non uniform scale the radius is scaled by the largest component.
+	template<typename T>
+	MMRect<T, 3> swept_bounds(const Sphere<T>& local, const Transform<T, 3>& from, const Transform<T, 3>& to) noexcept {
+		// The path of the center, padded by the largest radius at either end.
+		MMRect<T, 3> center = swept_bounds(MMRect<T, 3>{ local.origin, local.origin }, from, to);
+		glm::tvec3<T> s0 = glm::abs(from.size), s1 = glm::abs(to.size);
+		T scale = std::max(std::max(std::max(s0.x, s0.y), s0.z), std::max(std::max(s1.x, s1.y), s1.z));
+		T radius = std::abs(local.radius) * scale;
+		return MMRect<T, 3>{ center.min - radius, center.max + radius };
+	}
+
+	// Swept bounds of locals[j] from from[j] to to[j], out is resized to match.
+	template<typename T>
+	void swept_bounds_batch(const MMRectSoA3<T>& locals, const TransformSoA<T>& from, const TransformSoA<T>& to, MMRectSoA3<T>& out) {
+		std::size_t count = std::min(locals.size(), std::min(from.size(), to.size()));
+		out.resize(count);
+		for (std::size_t j = 0; j < count; ++j) {
+			T lo[3], hi[3], o0[3], q0[4], s0[3], o1[3], q1[4], s1[3], min[3], max[3];
+			for (int k = 0; k < 3; ++k) {
+				lo[k] = locals.min.data(k)[j];
+				hi[k] = locals.max.data(k)[j];
+			}
+			intern::transform_parts(from, j, o0, q0, s0);
+			intern::transform_parts(to, j, o1, q1, s1);
+			intern::swept_box(lo, hi, o0, q0, s0, o1, q1, s1, min, max);
+			for (int k = 0; k < 3; ++k) {
+				out.min.data(k)[j] = min[k];
+				out.max.data(k)[j] = max[k];
+			}
+		}
+	}
+	// Same as above with one local box shared by every transform.
+	template<typename T>
+	void swept_bounds_batch(const MMRect<T, 3>& local, const TransformSoA<T>& from, const TransformSoA<T>& to, MMRectSoA3<T>& out) {
+		std::size_t count = std::min(from.size(), to.size());
+		out.resize(count);
+		const T lo[3] = { local.min.x, local.min.y, local.min.z }, hi[3] = { local.max.x, local.max.y, local.max.z };
+		for (std::size_t j = 0; j < count; ++j) {
+			T o0[3], q0[4], s0[3], o1[3], q1[4], s1[3], min[3], max[3];
+			intern::transform_parts(from, j, o0, q0, s0);
+			intern::transform_parts(to, j, o1, q1, s1);
+			intern::swept_box(lo, hi, o0, q0, s0, o1, q1, s1, min, max);
+			for (int k = 0; k < 3; ++k) {
+				out.min.data(k)[j] = min[k];
+				out.max.data(k)[j] = max[k];
+			}
+		}
+	}
+	// Swept bounds of the local spheres.
+	template<typename T>
+	void swept_bounds_batch(const BallSoA<T, 3>& locals, const TransformSoA<T>& from, const TransformSoA<T>& to, MMRectSoA3<T>& out) {
+		std::size_t count = std::min(locals.size(), std::min(from.size(), to.size()));
+		out.resize(count);
+		for (std::size_t j = 0; j < count; ++j) {
+			T c[3], o0[3], q0[4], s0[3], o1[3], q1[4], s1[3], min[3], max[3];
+			for (int k = 0; k < 3; ++k) {
+				c[k] = locals.origin.data(k)[j];
+			}
+			intern::transform_parts(from, j, o0, q0, s0);
+			intern::transform_parts(to, j, o1, q1, s1);
+			intern::swept_box(c, c, o0, q0, s0, o1, q1, s1, min, max);
+			T scale = T(0);
+			for (int k = 0; k < 3; ++k) {
+				scale = std::max(scale, std::max(std::abs(s0[k]), std::abs(s1[k])));
+			}
+			T radius = std::abs(locals.radius[j]) * scale;
+			for (int k = 0; k < 3; ++k) {
+				out.min.data(k)[j] = min[k] - radius;
+				out.max.data(k)[j] = max[k] + radius;
+			}
+		}
+	}
+};
@@ -0,0 +1,167 @@
+#pragma once
+#include <cmath>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <ez/math/constants.hpp>
+
+#include "intern/DimTraits.hpp"
+#include "MMRect.hpp"
+#include "Transform.hpp"
+
+namespace ez {
+	/*
+	Oriented bounding box, a center point, an orthonormal set of local axes and the half extent along each of those axes.
+	The axes are stored instead of the rotation so the overlap tests do not have to rebuild them every time.
+	*/
+	template<typename T, int N>
+	struct OBB {
+		static_assert(N == 2 || N == 3, "Invalid dimension parameter (N) for ez::OBB template! Must be 2 or 3.");
+
+		using trait_t = intern::DimTraits<T, N>;
+		using vec_t = typename trait_t::vec_t;
+		using rot_t = typename trait_t::rot_t;
+		using basis_t = typename trait_t::basis_t;
+		using rect_t = MMRect<T, N>;
+		using transform_t = Transform<T, N>;
+
+		OBB() noexcept
+			: origin{ T(0) }
+			, half{ T(0) }
+			, axes{ T(1) }
+		{}
+		OBB(const vec_t& _origin, const basis_t& _axes, const vec_t& _half) noexcept
+			: origin(_origin)
+			, half(_half)
+			, axes(_axes)
+		{}
+		OBB(const vec_t& _origin, const rot_t& rotation, const vec_t& _half) noexcept
+			: origin(_origin)
+			, half(_half)
+			, axes(transform_t{ _origin, rotation }.getBasis())
+		{}
+		// The box covering the local space cube from -1 to 1 on every axis.
+		explicit OBB(const transform_t& form) noexcept
+			: origin(form.origin)
+			, half(glm::abs(form.size))
+			, axes(form.getBasis())
+		{}
+		// The box covering a local space rect.
+		OBB(const transform_t& form, const rect_t& local) noexcept
+			: origin(form.toWorld(local.center()))
+			, half(glm::abs(local.size() * form.size) / T(2))
+			, axes(form.getBasis())
+		{}
+
+		~OBB() = default;
+		OBB(const OBB&) noexcept = default;
+		OBB(OBB&&) noexcept = default;
+		OBB& operator=(const OBB&) noexcept = default;
+		OBB& operator=(OBB&&) noexcept = default;
+
+		OBB& translate(const vec_t& offset) noexcept {
+			origin += offset;
+			return *this;
+		}
+		OBB& move(const vec_t& point) noexcept {
+			origin = point;
+			return *this;
+		}
+
+		vec_t size() const noexcept {
+			return half * T(2);
+		}
+
+		// Treats input as a position in world space, the result is in the unscaled box frame.
+		vec_t toLocal(const vec_t& point) const noexcept {
+			vec_t d = point - origin;
+			vec_t ret;
+			for (int i = 0; i < N; ++i) {
+				ret[i] = glm::dot(d, axes[i]);
+			}
+			return ret;
+		}
+		// Treats input as a position in the unscaled box frame.
+		vec_t toWorld(const vec_t& point) const noexcept {
+			vec_t ret = origin;
+			for (int i = 0; i < N; ++i) {
+				ret += axes[i] * point[i];
+			}
+			return ret;
+		}
+
+		bool contains(const vec_t& point) const noexcept {
+			vec_t local = glm::abs(toLocal(point));
+			return glm::all(glm::lessThanEqual(local, half));
+		}
+
+		vec_t closestPoint(const vec_t& point) const noexcept {
+			return toWorld(glm::clamp(toLocal(point), -half, half));
+		}
+
+		// The tightest world space MMRect containing the box.
+		rect_t bounds() const noexcept {
+			vec_t extent{ T(0) };
+			for (int i = 0; i < N; ++i) {
+				extent += glm::abs(axes[i]) * half[i];
+			}
+			return rect_t{ origin - extent, origin + extent };
+		}
+
+		vec_t origin, half;
+		basis_t axes;
+	};
+
+	template<typename T>
+	using OBB2 = OBB<T, 2>;
+
+	template<typename T>
+	using OBB3 = OBB<T, 3>;
+
+	namespace intern {
+		// Separating axis test for two boxes, with the second box expressed in the frame of the first.
+		// R is the rotation of b relative to a (R[i][j] = dot(a.axes[i], b.axes[j])) and t is the offset of b in the frame of a.
+		// Written without branches so it can be evaluated across a batch.
+		template<typename T, int N>
+		bool sat_overlap(const T (&R)[N][N], const T (&t)[N], const T (&ea)[N], const T (&eb)[N]) noexcept {
+			// The epsilon guards the cross product axes against nearly parallel edges.
+			T AbsR[N][N];
+			for (int i = 0; i < N; ++i) {
+				for (int j = 0; j < N; ++j) {
+					AbsR[i][j] = std::abs(R[i][j]) + ez::epsilon<T>();
+				}
+			}
+
+			bool separated = false;
+			// The axes of a
+			for (int i = 0; i < N; ++i) {
+				T rb = T(0);
+				for (int j = 0; j < N; ++j) {
+					rb += eb[j] * AbsR[i][j];
+				}
+				separated |= std::abs(t[i]) > ea[i] + rb;
+			}
+			// The axes of b
+			for (int j = 0; j < N; ++j) {
+				T ra = T(0), dist = T(0);
+				for (int i = 0; i < N; ++i) {
+					ra += ea[i] * AbsR[i][j];
+					dist += t[i] * R[i][j];
+				}
+				separated |= std::abs(dist) > ra + eb[j];
+			}
+			// The cross products of the axes of a and b
+			if constexpr (N == 3) {
+				for (int i = 0; i < 3; ++i) {
+					int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+					for (int j = 0; j < 3; ++j) {
+						int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+						T ra = ea[i1] * AbsR[i2][j] + ea[i2] * AbsR[i1][j];
+						T rb = eb[j1] * AbsR[i][j2] + eb[j2] * AbsR[i][j1];
+						separated |= std::abs(t[i2] * R[i1][j] - t[i1] * R[i2][j]) > ra + rb;
+					}
+				}
+			}
+			return !separated;
+		}
+	}
+};
\ No newline at end of file
@@ -0,0 +1,438 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+#include <glm/vec2.hpp>
+
+#include "Rect.hpp"
+#include "MMRect.hpp"
+
+/*
+Rectangle bin packers for texture and glyph atlases.
+
+MaxRectsPacker keeps the list of maximal free rectangles, it gives the tightest packing but each insertion costs time in the
+number of free rectangles, which grows with the number of rects placed. It suits bins of up to a few thousand rects.
+SkylinePacker only tracks the top edge of the packed area, it wastes the space under overhangs but inserts in time linear
+in the number of skyline segments, use it for very large batches. A batch of 100k glyph sized rects packs in a few tens of milliseconds.
+
+Both support incremental insertion, for caches that add rects as they are needed, and batch insertion, which sorts the
+rects largest first and usually packs noticeably tighter. Placed rects never overlap and never leave the bin.
+When rotation is allowed a rect may be placed turned a quarter, the placed size then has its width and height swapped.
+*/
+
+namespace ez {
+	enum class MaxRectsHeuristic {
+		// Minimize the shorter leftover side of the free rect, a good default.
+		BestShortSideFit,
+		// Minimize the longer leftover side.
+		BestLongSideFit,
+		// Pick the smallest free rect that fits.
+		BestAreaFit,
+		// Lowest top edge, then leftmost, tetris style.
+		BottomLeft
+	};
+
+	enum class SkylineHeuristic {
+		// Lowest top edge, then the narrowest segment.
+		BottomLeft,
+		// Least area lost under the placed rect, then the lowest top edge.
+		MinWaste
+	};
+
+	namespace intern {
+		// Order of the indices of the sizes for batch insertion, by decreasing key then by decreasing other side.
+		// MaxRects sorts on the longer side, the skyline on the height so rects of equal height end up side by side and the skyline stays flat.
+		template<typename T>
+		void pack_order(const glm::tvec2<T>* sizes, std::size_t count, bool byHeight, std::vector<std::uint32_t>& order) {
+			order.resize(count);
+			std::iota(order.begin(), order.end(), std::uint32_t(0));
+			auto key = [sizes, byHeight](std::uint32_t i) {
+				return byHeight ? glm::tvec2<T>{ sizes[i].y, sizes[i].x } : glm::tvec2<T>{ std::max(sizes[i].x, sizes[i].y), std::min(sizes[i].x, sizes[i].y) };
+			};
+			std::sort(order.begin(), order.end(), [&key](std::uint32_t a, std::uint32_t b) {
+				glm::tvec2<T> ka = key(a), kb = key(b);
+				if (ka.x != kb.x) {
+					return ka.x > kb.x;
+				}
+				if (ka.y != kb.y) {
+					return ka.y > kb.y;
+				}
+				return a < b;
+			});
+		}
+
+		template<typename P, typename T>
+		std::size_t pack_batch(P& packer, const glm::tvec2<T>* sizes, std::size_t count, bool byHeight, Rect2<T>* out, bool* placed, std::vector<std::uint32_t>& order) {
+			pack_order(sizes, count, byHeight, order);
+			std::size_t ret = 0;
+			for (std::uint32_t i : order) {
+				bool ok = packer.insert(sizes[i], out[i]);
+				if (!ok) {
+					out[i] = Rect2<T>{};
+				}
+				if (placed) {
+					placed[i] = ok;
+				}
+				ret += ok;
+			}
+			return ret;
+		}
+	}
+
+	template<typename T>
+	class MaxRectsPacker {
+	public:
+		using vec2_t = glm::tvec2<T>;
+		using rect_t = MMRect<T, 2>;
+
+		MaxRectsPacker(const vec2_t& _size, bool _allowRotation = false, MaxRectsHeuristic _heuristic = MaxRectsHeuristic::BestShortSideFit)
+			: allowRotation(_allowRotation)
+			, heuristic(_heuristic)
+		{
+			reset(_size);
+		}
+
+		// Empty the bin and change its size.
+		void reset(const vec2_t& _size) {
+			size = _size;
+			used = T(0);
+			freeRects.clear();
+			freeRects.push_back(rect_t{ vec2_t{ T(0) }, size });
+		}
+		void reset() {
+			reset(size);
+		}
+
+		// Place a single rect, returns false and leaves out untouched when there is no room for it.
+		bool insert(const vec2_t& rsize, Rect2<T>& out) {
+			if (rsize.x <= T(0) || rsize.y <= T(0)) {
+				return false;
+			}
+
+			Score best;
+			vec2_t bestPos{ T(0) }, bestSize{ T(0) };
+			for (const rect_t& free : freeRects) {
+				consider(free, rsize, best, bestPos, bestSize);
+				if (allowRotation && rsize.x != rsize.y) {
+					consider(free, vec2_t{ rsize.y, rsize.x }, best, bestPos, bestSize);
+				}
+			}
+			if (!best.found()) {
+				return false;
+			}
+
+			place(rect_t{ bestPos, bestPos + bestSize });
+			out = Rect2<T>{ bestPos, bestSize };
+			return true;
+		}
+
+		// Place every rect largest first, out[i] receives the placement of sizes[i].
+		// Rects that do not fit are set to an empty rect, and placed[i] is false for them when given. Returns the number placed.
+		std::size_t insert(const vec2_t* sizes, std::size_t count, Rect2<T>* out, bool* placed = nullptr) {
+			return intern::pack_batch(*this, sizes, count, false, out, placed, order);
+		}
+
+		const vec2_t& getSize() const noexcept {
+			return size;
+		}
+		// Total area of the placed rects.
+		T usedArea() const noexcept {
+			return used;
+		}
+		// Fraction of the bin covered by placed rects.
+		double occupancy() const noexcept {
+			return double(used) / (double(size.x) * double(size.y));
+		}
+		const std::vector<rect_t>& getFreeRects() const noexcept {
+			return freeRects;
+		}
+	private:
+		// Lexicographic score, lower is better.
+		struct Score {
+			bool found() const noexcept {
+				return primary != std::numeric_limits<T>::max();
+			}
+			bool operator<(const Score& other) const noexcept {
+				return primary < other.primary || (primary == other.primary && secondary < other.secondary);
+			}
+
+			T primary = std::numeric_limits<T>::max();
+			T secondary = std::numeric_limits<T>::max();
+		};
+
+		void consider(const rect_t& free, const vec2_t& rsize, Score& best, vec2_t& bestPos, vec2_t& bestSize) const noexcept {
+			T fw = free.width(), fh = free.height();
+			if (rsize.x > fw || rsize.y > fh) {
+				return;
+			}
+
+			T dw = fw - rsize.x, dh = fh - rsize.y;
+			Score score;
+			switch (heuristic) {
+			case MaxRectsHeuristic::BestShortSideFit:
+				score.primary = std::min(dw, dh);
+				score.secondary = std::max(dw, dh);
+				break;
+			case MaxRectsHeuristic::BestLongSideFit:
+				score.primary = std::max(dw, dh);
+				score.secondary = std::min(dw, dh);
+				break;
+			case MaxRectsHeuristic::BestAreaFit:
+				score.primary = fw * fh - rsize.x * rsize.y;
+				score.secondary = std::min(dw, dh);
+				break;
+			case MaxRectsHeuristic::BottomLeft:
+				score.primary = free.min.y + rsize.y;
+				score.secondary = free.min.x;
+				break;
+			}
+
+			if (score < best) {
+				best = score;
+				bestPos = free.min;
+				bestSize = rsize;
+			}
+		}
+
+		static bool overlaps(const rect_t& a, const rect_t& b) noexcept {
+			return a.min.x < b.max.x && b.min.x < a.max.x && a.min.y < b.max.y && b.min.y < a.max.y;
+		}
+
+		// Split every free rect overlapped by the placed rect into up to four maximal pieces, then drop the pieces contained in another free rect.
+		void place(const rect_t& rect) {
+			used += rect.width() * rect.height();
+
+			fresh.clear();
+			std::size_t count = freeRects.size();
+			for (std::size_t i = 0; i < count;) {
+				const rect_t free = freeRects[i];
+				if (!overlaps(free, rect)) {
+					++i;
+					continue;
+				}
+
+				if (rect.min.x > free.min.x) {
+					fresh.push_back(rect_t{ free.min, vec2_t{ rect.min.x, free.max.y } });
+				}
+				if (rect.max.x < free.max.x) {
+					fresh.push_back(rect_t{ vec2_t{ rect.max.x, free.min.y }, free.max });
+				}
+				if (rect.min.y > free.min.y) {
+					fresh.push_back(rect_t{ free.min, vec2_t{ free.max.x, rect.min.y } });
+				}
+				if (rect.max.y < free.max.y) {
+					fresh.push_back(rect_t{ vec2_t{ free.min.x, rect.max.y }, free.max });
+				}
+
+				freeRects[i] = freeRects[--count];
+			}
+			freeRects.resize(count);
+
+			// The untouched free rects were maximal before and still are, so only the new pieces need pruning,
+			// against the untouched rects and against each other.
+			for (std::size_t i = 0; i < fresh.size(); ++i) {
+				bool contained = false;
+				for (std::size_t j = 0; j < count && !contained; ++j) {
+					contained = freeRects[j].contains(fresh[i]);
+				}
+				for (std::size_t j = 0; j < fresh.size() && !contained; ++j) {
+					// Of two identical pieces keep the first.
+					contained = j != i && fresh[j].contains(fresh[i]) && (j < i || !fresh[i].contains(fresh[j]));
+				}
+				if (!contained) {
+					freeRects.push_back(fresh[i]);
+				}
+			}
+		}
+
+		vec2_t size;
+		T used;
+		bool allowRotation;
+		MaxRectsHeuristic heuristic;
+		std::vector<rect_t> freeRects, fresh;
+		std::vector<std::uint32_t> order;
+	};
+
+	template<typename T>
+	class SkylinePacker {
+	public:
+		using vec2_t = glm::tvec2<T>;
+
+		SkylinePacker(const vec2_t& _size, bool _allowRotation = false, SkylineHeuristic _heuristic = SkylineHeuristic::BottomLeft)
+			: allowRotation(_allowRotation)
+			, heuristic(_heuristic)
+		{
+			reset(_size);
+		}
+
+		// Empty the bin and change its size.
+		void reset(const vec2_t& _size) {
+			size = _size;
+			used = T(0);
+			skyline.clear();
+			skyline.push_back(Segment{ T(0), T(0), size.x });
+		}
+		void reset() {
+			reset(size);
+		}
+
+		// Place a single rect, returns false and leaves out untouched when there is no room for it.
+		bool insert(const vec2_t& rsize, Rect2<T>& out) {
+			if (rsize.x <= T(0) || rsize.y <= T(0)) {
+				return false;
+			}
+
+			Fit best;
+			for (std::size_t i = 0; i < skyline.size(); ++i) {
+				consider(i, rsize, best);
+				if (allowRotation && rsize.x != rsize.y) {
+					consider(i, vec2_t{ rsize.y, rsize.x }, best);
+				}
+			}
+			if (best.index == Fit::None) {
+				return false;
+			}
+
+			place(best.index, best.pos, best.size);
+			used += best.size.x * best.size.y;
+			out = Rect2<T>{ best.pos, best.size };
+			return true;
+		}
+
+		// Place every rect largest first, out[i] receives the placement of sizes[i].
+		// Rects that do not fit are set to an empty rect, and placed[i] is false for them when given. Returns the number placed.
+		std::size_t insert(const vec2_t* sizes, std::size_t count, Rect2<T>* out, bool* placed = nullptr) {
+			return intern::pack_batch(*this, sizes, count, !allowRotation, out, placed, order);
+		}
+
+		const vec2_t& getSize() const noexcept {
+			return size;
+		}
+		// Total area of the placed rects.
+		T usedArea() const noexcept {
+			return used;
+		}
+		// Fraction of the bin covered by placed rects.
+		double occupancy() const noexcept {
+			return double(used) / (double(size.x) * double(size.y));
+		}
+		// The number of segments in the skyline, the cost of an insertion grows with it.
+		std::size_t segments() const noexcept {
+			return skyline.size();
+		}
+	private:
+		// A horizontal run of the top edge, from x to x + width at height y.
+		struct Segment {
+			T x, y, width;
+		};
+
+		struct Fit {
+			static constexpr std::size_t None = std::numeric_limits<std::size_t>::max();
+
+			std::size_t index = None;
+			vec2_t pos{ T(0) }, size{ T(0) };
+			T primary = std::numeric_limits<T>::max();
+			T secondary = std::numeric_limits<T>::max();
+		};
+
+		// Height at which a rect of the given width rests when its left edge is on segment i, or false when it does not fit.
+		// Also gives up once the rect would rest higher than limit, no placement there can beat the best one found.
+		bool rest(std::size_t i, const vec2_t& rsize, T limit, T& y, T& waste) const noexcept {
+			T x = skyline[i].x;
+			if (x + rsize.x > size.x) {
+				return false;
+			}
+
+			limit = std::min(limit, size.y - rsize.y);
+			y = T(0);
+			for (std::size_t j = i; j < skyline.size() && skyline[j].x < x + rsize.x; ++j) {
+				y = std::max(y, skyline[j].y);
+				if (y > limit) {
+					return false;
+				}
+			}
+
+			if (heuristic == SkylineHeuristic::MinWaste) {
+				waste = T(0);
+				for (std::size_t j = i; j < skyline.size() && skyline[j].x < x + rsize.x; ++j) {
+					T right = std::min(skyline[j].x + skyline[j].width, x + rsize.x);
+					waste += (right - skyline[j].x) * (y - skyline[j].y);
+				}
+			}
+			return true;
+		}
+
+		void consider(std::size_t i, const vec2_t& rsize, Fit& best) const noexcept {
+			T limit = std::numeric_limits<T>::max();
+			if (heuristic == SkylineHeuristic::BottomLeft && best.index != Fit::None) {
+				// The rect rests at or above the segment, so a segment this high can not give a lower top edge.
+				limit = best.primary - rsize.y;
+				if (skyline[i].y > limit) {
+					return;
+				}
+			}
+
+			T y, waste = T(0);
+			if (!rest(i, rsize, limit, y, waste)) {
+				return;
+			}
+
+			T primary, secondary;
+			if (heuristic == SkylineHeuristic::BottomLeft) {
+				primary = y + rsize.y;
+				secondary = skyline[i].width;
+			}
+			else {
+				primary = waste;
+				secondary = y + rsize.y;
+			}
+
+			if (primary < best.primary || (primary == best.primary && secondary < best.secondary)) {
+				best.index = i;
+				best.pos = vec2_t{ skyline[i].x, y };
+				best.size = rsize;
+				best.primary = primary;
+				best.secondary = secondary;
+			}
+		}
+
+		// Raise the skyline under the placed rect, trim the segments it covers, then merge neighbours of equal height.
+		void place(std::size_t i, const vec2_t& pos, const vec2_t& rsize) {
+			T right = pos.x + rsize.x;
+			skyline.insert(skyline.begin() + i, Segment{ pos.x, pos.y + rsize.y, rsize.x });
+
+			std::size_t j = i + 1;
+			while (j < skyline.size() && skyline[j].x < right) {
+				T end = skyline[j].x + skyline[j].width;
+				if (end <= right) {
+					++j;
+					continue;
+				}
+				skyline[j].width = end - right;
+				skyline[j].x = right;
+				break;
+			}
+			skyline.erase(skyline.begin() + i + 1, skyline.begin() + j);
+
+			std::size_t first = i > 0 ? i - 1 : 0;
+			std::size_t last = std::min(i + 1, skyline.size() - 1);
+			for (std::size_t k = last; k > first; --k) {
+				if (skyline[k - 1].y == skyline[k].y) {
+					skyline[k - 1].width += skyline[k].width;
+					skyline.erase(skyline.begin() + k);
+				}
+			}
+		}
+
+		vec2_t size;
+		T used;
+		bool allowRotation;
+		SkylineHeuristic heuristic;
+		std::vector<Segment> skyline;
+		std::vector<std::uint32_t> order;
+	};
+};
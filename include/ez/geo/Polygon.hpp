@@ -0,0 +1,251 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+#include <limits>
+#include <type_traits>
+#include <algorithm>
+
+#include <glm/vec2.hpp>
+#include <glm/common.hpp>
+
+#include "Line.hpp"
+#include "MMRect.hpp"
+#include "SoA.hpp"
+
+/*
+Simple closed polygon in 2d, with a point in polygon query accelerated by a slab index.
+
+The vertices are stored contiguously and the last one connects back to the first. The polygon may be concave and may even
+self intersect, containment follows the even odd rule. Points exactly on the boundary may be reported either way.
+
+The bounds are split into horizontal slabs of equal height, and each slab lists the edges that cross it with the data the
+crossing test needs stored as structure of arrays. A query finds its slab with one multiply and only tests the few edges
+listed there, instead of every edge of the polygon.
+*/
+
+namespace ez {
+	template<typename T>
+	class Polygon2 {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::Polygon2 requires a floating point value type!");
+		using vec2_t = glm::tvec2<T>;
+		using rect_t = MMRect<T, 2>;
+
+		// The vertices and the index are allocated from the resource.
+		explicit Polygon2(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: verts(resource)
+			, offsets(resource)
+			, cursor(resource)
+			, lowY(resource)
+			, highY(resource)
+			, lowX(resource)
+			, slope(resource)
+		{
+			assign(nullptr, 0);
+		}
+		// Slabs is the number of slabs of the index, zero picks one from the number of vertices.
+		Polygon2(const vec2_t* points, std::size_t count, std::size_t slabs = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Polygon2(resource)
+		{
+			assign(points, count, slabs);
+		}
+		Polygon2(const std::vector<vec2_t>& points, std::size_t slabs = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Polygon2(resource)
+		{
+			assign(points.data(), points.size(), slabs);
+		}
+
+		// Replace the vertices and rebuild the bounds and the index.
+		// The buffers keep their capacity, so reassigning a polygon no larger than before does not allocate.
+		void assign(const vec2_t* points, std::size_t count, std::size_t slabs = 0) {
+			verts.assign(points, points + count);
+			bound = rect_t{ vec2_t{ std::numeric_limits<T>::max() }, vec2_t{ std::numeric_limits<T>::lowest() } };
+			for (const vec2_t& p : verts) {
+				bound.min = glm::min(bound.min, p);
+				bound.max = glm::max(bound.max, p);
+			}
+			if (verts.empty()) {
+				bound = rect_t{ vec2_t{ T(0) }, vec2_t{ T(0) } };
+			}
+			build(slabs);
+		}
+
+		std::size_t size() const noexcept {
+			return verts.size();
+		}
+		bool empty() const noexcept {
+			return verts.empty();
+		}
+		const vec2_t& operator[](std::size_t index) const noexcept {
+			return verts[index];
+		}
+		const std::pmr::vector<vec2_t>& vertices() const noexcept {
+			return verts;
+		}
+		const rect_t& bounds() const noexcept {
+			return bound;
+		}
+		std::size_t slabCount() const noexcept {
+			return offsets.empty() ? 0 : offsets.size() - 1;
+		}
+		std::pmr::memory_resource* resource() const noexcept {
+			return verts.get_allocator().resource();
+		}
+
+		// The edge from vertex index to the next one.
+		Line2<T> edge(std::size_t index) const noexcept {
+			return Line2<T>{ verts[index], verts[(index + 1) % verts.size()] };
+		}
+
+		// Shoelace area, positive when the vertices wind counter clockwise.
+		T signedArea() const noexcept {
+			T sum = T(0);
+			std::size_t count = verts.size();
+			for (std::size_t i = 0, j = count - 1; i < count; j = i++) {
+				sum += verts[j].x * verts[i].y - verts[i].x * verts[j].y;
+			}
+			return sum / T(2);
+		}
+		T area() const noexcept {
+			return std::abs(signedArea());
+		}
+
+		bool contains(const vec2_t& point) const noexcept {
+			if (!inBounds(point)) {
+				return false;
+			}
+			std::size_t s = slab(point.y);
+			return crossings(point, offsets[s], offsets[s + 1]) != 0;
+		}
+
+		// Inside flags for count points, out receives 1 for the points inside and 0 for the others.
+		void contains(const vec2_t* points, std::size_t count, std::uint8_t* out) const noexcept {
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = contains(points[i]) ? 1 : 0;
+			}
+		}
+		void contains(const PointSoA<T, 2>& points, std::uint8_t* out) const noexcept {
+			contains(points.data(0), points.data(1), points.size(), out);
+		}
+		// Same with the coordinates of the points in two arrays.
+		void contains(const T* px, const T* py, std::size_t count, std::uint8_t* out) const noexcept {
+			for (std::size_t i = 0; i < count; ++i) {
+				vec2_t p{ px[i], py[i] };
+				std::size_t s = slab(p.y);
+				// Points outside of the bounds test an empty range of edges.
+				std::size_t begin = offsets[s], end = inBounds(p) ? offsets[s + 1] : begin;
+				out[i] = crossings(p, begin, end);
+			}
+		}
+	private:
+		bool inBounds(const vec2_t& p) const noexcept {
+			return (p.x >= bound.min.x) & (p.x <= bound.max.x) & (p.y >= bound.min.y) & (p.y <= bound.max.y);
+		}
+
+		std::size_t slab(T y) const noexcept {
+			T s = (y - bound.min.y) * invSlabHeight;
+			std::size_t last = offsets.size() - 2;
+			return s <= T(0) ? 0 : std::min(static_cast<std::size_t>(s), last);
+		}
+
+		// Parity of the number of edges in the range crossed by a ray from the point toward +x.
+		// The y range of an edge is half open, so a ray through a vertex counts exactly one of the two edges meeting there.
+		std::uint8_t crossings(const vec2_t& p, std::size_t begin, std::size_t end) const noexcept {
+			std::uint8_t parity = 0;
+			const T* y0 = lowY.data(), * y1 = highY.data(), * x0 = lowX.data(), * dx = slope.data();
+			for (std::size_t e = begin; e < end; ++e) {
+				bool cross = (p.y >= y0[e]) & (p.y < y1[e]) & (p.x < x0[e] + (p.y - y0[e]) * dx[e]);
+				parity ^= static_cast<std::uint8_t>(cross);
+			}
+			return parity;
+		}
+
+		void build(std::size_t slabs) {
+			std::size_t count = verts.size();
+			if (slabs == 0) {
+				slabs = std::min<std::size_t>(std::max<std::size_t>(count / 2, 1), 1 << 14);
+			}
+			T height = bound.max.y - bound.min.y;
+			invSlabHeight = height > T(0) ? T(slabs) / height : T(0);
+
+			offsets.assign(slabs + 1, 0);
+			lowY.clear();
+			highY.clear();
+			lowX.clear();
+			slope.clear();
+			if (count < 3) {
+				return;
+			}
+
+			// Count the edges of each slab, then fill them in with a prefix sum, horizontal edges are never crossed and are left out.
+			for (int pass = 0; pass < 2; ++pass) {
+				if (pass == 1) {
+					for (std::size_t s = 0; s < slabs; ++s) {
+						offsets[s + 1] += offsets[s];
+					}
+					cursor.assign(offsets.begin(), offsets.end() - 1);
+					lowY.resize(offsets[slabs]);
+					highY.resize(offsets[slabs]);
+					lowX.resize(offsets[slabs]);
+					slope.resize(offsets[slabs]);
+				}
+
+				for (std::size_t i = 0, j = count - 1; i < count; j = i++) {
+					vec2_t a = verts[j], b = verts[i];
+					if (a.y == b.y) {
+						continue;
+					}
+					if (a.y > b.y) {
+						std::swap(a, b);
+					}
+
+					std::size_t first = slab(a.y), last = slab(b.y);
+					for (std::size_t s = first; s <= last; ++s) {
+						if (pass == 0) {
+							++offsets[s + 1];
+							continue;
+						}
+						std::size_t e = cursor[s]++;
+						lowY[e] = a.y;
+						highY[e] = b.y;
+						lowX[e] = a.x;
+						slope[e] = (b.x - a.x) / (b.y - a.y);
+					}
+				}
+			}
+		}
+
+		std::pmr::vector<vec2_t> verts;
+		rect_t bound;
+
+		// Edges of slab s are in [offsets[s], offsets[s + 1]), cursor is scratch for filling them in.
+		T invSlabHeight;
+		std::pmr::vector<std::size_t> offsets, cursor;
+		std::pmr::vector<T> lowY, highY, lowX, slope;
+	};
+
+	// Batch point in polygon test, appends the indices of the points inside the polygon. Returns the number of indices appended.
+	template<typename T>
+	std::size_t contains_batch(const Polygon2<T>& polygon, const PointSoA<T, 2>& points, std::vector<std::uint32_t>& inside) {
+		constexpr std::size_t Block = 256;
+		std::uint8_t mask[Block];
+		std::uint32_t kept[Block];
+
+		// Each block is tested with the branch free slab query and compacted on the stack, only its passing indices reach the output.
+		std::size_t count = points.size(), start = inside.size();
+		for (std::size_t i = 0; i < count; i += Block) {
+			std::size_t n = std::min(Block, count - i);
+			polygon.contains(points.data(0) + i, points.data(1) + i, n, mask);
+			std::size_t passed = 0;
+			for (std::size_t j = 0; j < n; ++j) {
+				kept[passed] = static_cast<std::uint32_t>(i + j);
+				passed += mask[j];
+			}
+			inside.insert(inside.end(), kept, kept + passed);
+		}
+		return inside.size() - start;
+	}
+};
@@ -0,0 +1,394 @@
+#pragma once
+#include <cmath>
+#include <limits>
+#include <cstddef>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+/*
+Robust geometric predicates, after Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+Each predicate is first evaluated in double precision, the result is returned directly when it is larger than the rounding error bound.
+Otherwise the determinant is evaluated again with exact expansion arithmetic, so the sign of the result is always correct.
+Inputs of any floating point type are promoted to double, which is exact for float.
+*/
+
+namespace ez {
+	namespace intern {
+		// A number stored as a sum of non overlapping doubles, ordered by increasing magnitude.
+		// The terms are kept on the stack, Capacity is the most terms the number can need. Every operation returns an expansion
+		// sized for its worst case, so the capacity of each intermediate follows from the expression and nothing is allocated.
+		template<std::size_t Capacity>
+		class Expansion {
+		public:
+			static_assert(Capacity > 0, "ez::intern::Expansion needs room for at least one term!");
+			template<std::size_t M>
+			friend class Expansion;
+
+			Expansion() noexcept
+				: count(0)
+			{}
+			Expansion(double value) noexcept
+				: count(0)
+			{
+				push(value);
+			}
+
+			static void two_sum(double a, double b, double& x, double& y) noexcept {
+				x = a + b;
+				double bv = x - a;
+				double av = x - bv;
+				y = (a - av) + (b - bv);
+			}
+			static void fast_two_sum(double a, double b, double& x, double& y) noexcept {
+				x = a + b;
+				y = b - (x - a);
+			}
+			static void two_product(double a, double b, double& x, double& y) noexcept {
+				x = a * b;
+				y = std::fma(a, b, -x);
+			}
+
+			// The exact difference a - b.
+			static Expansion<2> diff(double a, double b) noexcept {
+				Expansion<2> ret;
+				double x, y;
+				two_sum(a, -b, x, y);
+				ret.push(y);
+				ret.push(x);
+				return ret;
+			}
+			// The exact product a * b.
+			static Expansion<2> product(double a, double b) noexcept {
+				Expansion<2> ret;
+				double x, y;
+				two_product(a, b, x, y);
+				ret.push(y);
+				ret.push(x);
+				return ret;
+			}
+
+			std::size_t size() const noexcept {
+				return count;
+			}
+			double operator[](std::size_t index) const noexcept {
+				return terms[index];
+			}
+			// The sign of the number, the largest term decides it.
+			int sign() const noexcept {
+				if (count == 0) {
+					return 0;
+				}
+				return terms[count - 1] > 0.0 ? 1 : -1;
+			}
+			// An approximation of the value, with the correct sign.
+			double estimate() const noexcept {
+				double sum = 0.0;
+				for (std::size_t i = 0; i < count; ++i) {
+					sum += terms[i];
+				}
+				return sum;
+			}
+
+			// Add every term of e times sign, the sum must fit in the capacity.
+			template<std::size_t M>
+			void add(const Expansion<M>& e, double sign = 1.0) noexcept {
+				for (std::size_t i = 0; i < e.count; ++i) {
+					grow(e.terms[i] * sign);
+				}
+			}
+
+			Expansion operator-() const noexcept {
+				Expansion ret = *this;
+				for (std::size_t i = 0; i < ret.count; ++i) {
+					ret.terms[i] = -ret.terms[i];
+				}
+				return ret;
+			}
+
+			template<std::size_t M>
+			friend Expansion<Capacity + M> operator+(const Expansion& a, const Expansion<M>& b) noexcept {
+				Expansion<Capacity + M> ret;
+				ret.add(a);
+				ret.add(b);
+				return ret;
+			}
+			template<std::size_t M>
+			friend Expansion<Capacity + M> operator-(const Expansion& a, const Expansion<M>& b) noexcept {
+				Expansion<Capacity + M> ret;
+				ret.add(a);
+				ret.add(b, -1.0);
+				return ret;
+			}
+			friend Expansion<2 * Capacity> operator*(const Expansion& a, double b) noexcept {
+				return a.scaled(b);
+			}
+			template<std::size_t M>
+			friend Expansion<2 * Capacity * M> operator*(const Expansion& a, const Expansion<M>& b) noexcept {
+				Expansion<2 * Capacity * M> ret;
+				for (std::size_t i = 0; i < b.size(); ++i) {
+					ret.add(a.scaled(b[i]));
+				}
+				return ret;
+			}
+		private:
+			void push(double term) noexcept {
+				if (term != 0.0) {
+					terms[count++] = term;
+				}
+			}
+
+			// Add a single double in place, keeping the terms non overlapping and free of zeros.
+			// Each term is written at or below the index it is read from, so no copy is needed.
+			void grow(double b) noexcept {
+				double q = b;
+				std::size_t kept = 0;
+				for (std::size_t i = 0; i < count; ++i) {
+					double h;
+					two_sum(q, terms[i], q, h);
+					if (h != 0.0) {
+						terms[kept++] = h;
+					}
+				}
+				if (q != 0.0) {
+					terms[kept++] = q;
+				}
+				count = kept;
+			}
+
+			Expansion<2 * Capacity> scaled(double b) const noexcept {
+				Expansion<2 * Capacity> ret;
+				if (count == 0 || b == 0.0) {
+					return ret;
+				}
+
+				double q, h;
+				two_product(terms[0], b, q, h);
+				ret.push(h);
+				for (std::size_t i = 1; i < count; ++i) {
+					double p1, p0, sum;
+					two_product(terms[i], b, p1, p0);
+					two_sum(q, p0, sum, h);
+					ret.push(h);
+					fast_two_sum(p1, sum, q, h);
+					ret.push(h);
+				}
+				ret.push(q);
+				return ret;
+			}
+
+			double terms[Capacity];
+			std::size_t count;
+		};
+
+		using Expansion2 = Expansion<2>;
+
+		// The exact px * qy - qx * py, four terms.
+		inline Expansion<4> exact_cross(double px, double py, double qx, double qy) noexcept {
+			return Expansion2::product(px, qy) - Expansion2::product(qx, py);
+		}
+
+		static constexpr double PredicateEps = std::numeric_limits<double>::epsilon() * 0.5;
+		static constexpr double Orient2Bound = (3.0 + 16.0 * PredicateEps) * PredicateEps;
+		static constexpr double InCircleBound = (10.0 + 96.0 * PredicateEps) * PredicateEps;
+		static constexpr double Orient3Bound = (7.0 + 56.0 * PredicateEps) * PredicateEps;
+		static constexpr double InSphereBound = (16.0 + 224.0 * PredicateEps) * PredicateEps;
+
+		// Worst case sizes, 16 terms for orient2d, 384 for incircle, 192 for orient3d and 5760 for insphere.
+		inline double orient2d_exact(double ax, double ay, double bx, double by, double cx, double cy) noexcept {
+			Expansion2 acx = Expansion2::diff(ax, cx);
+			Expansion2 acy = Expansion2::diff(ay, cy);
+			Expansion2 bcx = Expansion2::diff(bx, cx);
+			Expansion2 bcy = Expansion2::diff(by, cy);
+			return (acx * bcy - acy * bcx).estimate();
+		}
+
+		// Orientation of p, q, r as pq + qr + rp on the raw coordinates, 12 terms.
+		inline Expansion<12> orient2d_terms(const double p[2], const double q[2], const double r[2]) noexcept {
+			return exact_cross(p[0], p[1], q[0], q[1]) + exact_cross(q[0], q[1], r[0], r[1]) + exact_cross(r[0], r[1], p[0], p[1]);
+		}
+		// The minor times the lift of p, the sum of its squared coordinates, multiplying by one coordinate at a time.
+		template<int Dims, std::size_t M>
+		Expansion<4 * Dims * M> lifted(const double* p, const Expansion<M>& minor) noexcept {
+			Expansion<4 * Dims * M> ret;
+			for (int k = 0; k < Dims; ++k) {
+				ret.add((minor * p[k]) * p[k]);
+			}
+			return ret;
+		}
+
+		// The 4x4 determinant of the rows (x, y, x^2 + y^2, 1) expanded along the lift, on the raw coordinates so every
+		// multiplication is by a single double, as in Shewchuk's incircleexact. Equal to the determinant on differences from d.
+		inline double incircle_exact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) noexcept {
+			const double a[2] = { ax, ay }, b[2] = { bx, by }, c[2] = { cx, cy }, d[2] = { dx, dy };
+			Expansion<384> det;
+			det.add(lifted<2>(a, orient2d_terms(b, c, d)));
+			det.add(lifted<2>(b, orient2d_terms(a, c, d)), -1.0);
+			det.add(lifted<2>(c, orient2d_terms(a, b, d)));
+			det.add(lifted<2>(d, orient2d_terms(a, b, c)), -1.0);
+			return det.estimate();
+		}
+
+		inline double orient3d_exact(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d) noexcept {
+			Expansion2 adx = Expansion2::diff(a.x, d.x), ady = Expansion2::diff(a.y, d.y), adz = Expansion2::diff(a.z, d.z);
+			Expansion2 bdx = Expansion2::diff(b.x, d.x), bdy = Expansion2::diff(b.y, d.y), bdz = Expansion2::diff(b.z, d.z);
+			Expansion2 cdx = Expansion2::diff(c.x, d.x), cdy = Expansion2::diff(c.y, d.y), cdz = Expansion2::diff(c.z, d.z);
+
+			Expansion<192> det;
+			det.add(adz * (bdx * cdy - cdx * bdy));
+			det.add(bdz * (cdx * ady - adx * cdy));
+			det.add(cdz * (adx * bdy - bdx * ady));
+			return det.estimate();
+		}
+
+		// Determinant of the rows p, q, r, 24 terms.
+		inline Expansion<24> det3_terms(const double p[3], const double q[3], const double r[3]) noexcept {
+			Expansion<8> pz = exact_cross(q[0], q[1], r[0], r[1]) * p[2];
+			Expansion<8> qz = exact_cross(p[0], p[1], r[0], r[1]) * q[2];
+			Expansion<8> rz = exact_cross(p[0], p[1], q[0], q[1]) * r[2];
+			return pz - qz + rz;
+		}
+		// The 4x4 determinant of the rows (x, y, z, 1) of p, q, r, s, 96 terms.
+		inline Expansion<96> orient3d_terms(const double p[3], const double q[3], const double r[3], const double s[3]) noexcept {
+			Expansion<96> ret;
+			ret.add(det3_terms(q, r, s), -1.0);
+			ret.add(det3_terms(p, r, s));
+			ret.add(det3_terms(p, q, s), -1.0);
+			ret.add(det3_terms(p, q, r));
+			return ret;
+		}
+
+		// The 5x5 determinant of the rows (x, y, z, x^2 + y^2 + z^2, 1) expanded along the lift, as in Shewchuk's insphereexact.
+		// Its sign is the opposite of the determinant on differences from e, so the terms are negated.
+		inline double insphere_exact(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d, const glm::dvec3& e) noexcept {
+			const double pa[3] = { a.x, a.y, a.z }, pb[3] = { b.x, b.y, b.z }, pc[3] = { c.x, c.y, c.z };
+			const double pd[3] = { d.x, d.y, d.z }, pe[3] = { e.x, e.y, e.z };
+			Expansion<5760> det;
+			det.add(lifted<3>(pa, orient3d_terms(pb, pc, pd, pe)), -1.0);
+			det.add(lifted<3>(pb, orient3d_terms(pa, pc, pd, pe)));
+			det.add(lifted<3>(pc, orient3d_terms(pa, pb, pd, pe)), -1.0);
+			det.add(lifted<3>(pd, orient3d_terms(pa, pb, pc, pe)));
+			det.add(lifted<3>(pe, orient3d_terms(pa, pb, pc, pd)), -1.0);
+			return det.estimate();
+		}
+	}
+
+	// Positive when a, b, c wind counterclockwise, negative when clockwise and zero when they are collinear.
+	// The magnitude is roughly twice the signed area of the triangle.
+	template<typename T>
+	double orient2d(const glm::vec<2, T>& a, const glm::vec<2, T>& b, const glm::vec<2, T>& c) {
+		double ax = a.x, ay = a.y, bx = b.x, by = b.y, cx = c.x, cy = c.y;
+
+		double left = (ax - cx) * (by - cy);
+		double right = (ay - cy) * (bx - cx);
+		double det = left - right;
+		double bound = intern::Orient2Bound * (std::abs(left) + std::abs(right));
+		if (det > bound || -det > bound) {
+			return det;
+		}
+		return intern::orient2d_exact(ax, ay, bx, by, cx, cy);
+	}
+
+	// Positive when d lies inside the circle through a, b, c, negative outside and zero on the circle.
+	// The points a, b, c must be in counterclockwise order, the sign flips otherwise.
+	template<typename T>
+	double incircle(const glm::vec<2, T>& a, const glm::vec<2, T>& b, const glm::vec<2, T>& c, const glm::vec<2, T>& d) {
+		double adx = double(a.x) - double(d.x), ady = double(a.y) - double(d.y);
+		double bdx = double(b.x) - double(d.x), bdy = double(b.y) - double(d.y);
+		double cdx = double(c.x) - double(d.x), cdy = double(c.y) - double(d.y);
+
+		double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		double cdxady = cdx * ady, adxcdy = adx * cdy;
+		double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+		double alift = adx * adx + ady * ady;
+		double blift = bdx * bdx + bdy * bdy;
+		double clift = cdx * cdx + cdy * cdy;
+
+		double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+		double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+			+ (std::abs(cdxady) + std::abs(adxcdy)) * blift
+			+ (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+		double bound = intern::InCircleBound * permanent;
+		if (det > bound || -det > bound) {
+			return det;
+		}
+		return intern::incircle_exact(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+	}
+
+	// Positive when d lies below the plane through a, b, c, taking below as the side from which a, b, c appear clockwise.
+	// Zero when the four points are coplanar. The magnitude is roughly six times the signed volume of the tetrahedron.
+	template<typename T>
+	double orient3d(const glm::vec<3, T>& a, const glm::vec<3, T>& b, const glm::vec<3, T>& c, const glm::vec<3, T>& d) {
+		glm::dvec3 ad = glm::dvec3(a) - glm::dvec3(d);
+		glm::dvec3 bd = glm::dvec3(b) - glm::dvec3(d);
+		glm::dvec3 cd = glm::dvec3(c) - glm::dvec3(d);
+
+		double bdxcdy = bd.x * cd.y, cdxbdy = cd.x * bd.y;
+		double cdxady = cd.x * ad.y, adxcdy = ad.x * cd.y;
+		double adxbdy = ad.x * bd.y, bdxady = bd.x * ad.y;
+
+		double det = ad.z * (bdxcdy - cdxbdy) + bd.z * (cdxady - adxcdy) + cd.z * (adxbdy - bdxady);
+		double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(ad.z)
+			+ (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bd.z)
+			+ (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cd.z);
+		double bound = intern::Orient3Bound * permanent;
+		if (det > bound || -det > bound) {
+			return det;
+		}
+		return intern::orient3d_exact(glm::dvec3(a), glm::dvec3(b), glm::dvec3(c), glm::dvec3(d));
+	}
+
+	// Positive when e lies inside the sphere through a, b, c, d, negative outside and zero on the sphere.
+	// The points a, b, c, d must have a positive orient3d, the sign flips otherwise.
+	template<typename T>
+	double insphere(const glm::vec<3, T>& a, const glm::vec<3, T>& b, const glm::vec<3, T>& c, const glm::vec<3, T>& d, const glm::vec<3, T>& e) {
+		glm::dvec3 ae = glm::dvec3(a) - glm::dvec3(e);
+		glm::dvec3 be = glm::dvec3(b) - glm::dvec3(e);
+		glm::dvec3 ce = glm::dvec3(c) - glm::dvec3(e);
+		glm::dvec3 de = glm::dvec3(d) - glm::dvec3(e);
+
+		double aexbey = ae.x * be.y, bexaey = be.x * ae.y;
+		double bexcey = be.x * ce.y, cexbey = ce.x * be.y;
+		double cexdey = ce.x * de.y, dexcey = de.x * ce.y;
+		double dexaey = de.x * ae.y, aexdey = ae.x * de.y;
+		double aexcey = ae.x * ce.y, cexaey = ce.x * ae.y;
+		double bexdey = be.x * de.y, dexbey = de.x * be.y;
+
+		double ab = aexbey - bexaey;
+		double bc = bexcey - cexbey;
+		double cd = cexdey - dexcey;
+		double da = dexaey - aexdey;
+		double ac = aexcey - cexaey;
+		double bd = bexdey - dexbey;
+
+		double abc = ae.z * bc - be.z * ac + ce.z * ab;
+		double bcd = be.z * cd - ce.z * bd + de.z * bc;
+		double cda = ce.z * da + de.z * ac + ae.z * cd;
+		double dab = de.z * ab + ae.z * bd + be.z * da;
+
+		double alift = glm::dot(ae, ae);
+		double blift = glm::dot(be, be);
+		double clift = glm::dot(ce, ce);
+		double dlift = glm::dot(de, de);
+
+		double det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+
+		double aez = std::abs(ae.z), bez = std::abs(be.z), cez = std::abs(ce.z), dez = std::abs(de.z);
+		double ab2 = std::abs(aexbey) + std::abs(bexaey);
+		double bc2 = std::abs(bexcey) + std::abs(cexbey);
+		double cd2 = std::abs(cexdey) + std::abs(dexcey);
+		double da2 = std::abs(dexaey) + std::abs(aexdey);
+		double ac2 = std::abs(aexcey) + std::abs(cexaey);
+		double bd2 = std::abs(bexdey) + std::abs(dexbey);
+		double permanent = (cd2 * bez + bd2 * cez + bc2 * dez) * alift
+			+ (da2 * cez + ac2 * dez + cd2 * aez) * blift
+			+ (ab2 * dez + bd2 * aez + da2 * bez) * clift
+			+ (bc2 * aez + ac2 * bez + ab2 * cez) * dlift;
+		double bound = intern::InSphereBound * permanent;
+		if (det > bound || -det > bound) {
+			return det;
+		}
+		return intern::insphere_exact(glm::dvec3(a), glm::dvec3(b), glm::dvec3(c), glm::dvec3(d), glm::dvec3(e));
+	}
+};
@@ -0,0 +1,335 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include <glm/common.hpp>
+
+#include "MMRect.hpp"
+#include "Stats.hpp"
+#include "Memory.hpp"
+
+/*
+Static R-tree over rects, bulk loaded with Sort-Tile-Recursive.
+
+STR sorts the rects by the center along the first axis, cuts them into slabs, sorts each slab along the next axis and so on,
+then packs runs of Fanout rects into leaves. The levels above are built the same way from the bounds of the level below.
+Every node is full except the last one of each level, which packs the tree much tighter than inserting the rects one by one.
+
+Each node stores the bounds of its children as structure of arrays, one run of Fanout values per axis and side, sized so a
+run fills a cache line, so testing all the children of a node is a short loop over contiguous memory that vectorizes.
+Node bounds are built with MMRect::merge, point queries use MMRect::contains and region queries the same strict overlap as intersect.
+
+The tree holds the indices of the rects it was built from, queries append those indices to the output and never allocate
+beyond it, except nearest which keeps a small heap.
+*/
+
+namespace ez {
+	namespace intern {
+		// Sort-Tile-Recursive ordering of [begin, end), starting at the given axis, center(element, axis) gives the sort key.
+		// Leaves is the number of runs of fanout elements the range will be packed into.
+		template<typename It, typename F>
+		void str_tile(It begin, It end, int axis, int dims, std::size_t leaves, std::size_t fanout, F&& center) {
+			using value_t = typename std::iterator_traits<It>::value_type;
+			std::sort(begin, end, [&center, axis](const value_t& l, const value_t& r) {
+				return center(l, axis) < center(r, axis);
+			});
+			if (axis + 1 == dims || leaves <= 1) {
+				return;
+			}
+
+			// Slabs of equal count along this axis, as many as the remaining axes' root of the number of leaves allows.
+			std::size_t slabs = static_cast<std::size_t>(std::ceil(std::pow(double(leaves), 1.0 / double(dims - axis))));
+			std::size_t slabSize = ((leaves + slabs - 1) / slabs) * fanout;
+			for (It slab = begin; slab != end;) {
+				std::size_t count = std::min<std::size_t>(slabSize, std::size_t(end - slab));
+				It slabEnd = slab + count;
+				str_tile(slab, slabEnd, axis + 1, dims, (count + fanout - 1) / fanout, fanout, center);
+				slab = slabEnd;
+			}
+		}
+	}
+
+	template<typename T, glm::length_t N>
+	class RTree {
+	public:
+		static_assert(N >= 2, "ez::RTree requires at least two dimensions!");
+		using rect_t = MMRect<T, N>;
+		using vec_t = glm::vec<N, T>;
+
+		// Children per node, a run of one bound per child fills a cache line.
+		static constexpr std::size_t Fanout = std::max<std::size_t>(64 / sizeof(T), 4);
+
+		// The nodes and the build scratch are allocated from the resource.
+		explicit RTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: nodes(resource)
+			, level(resource)
+			, above(resource)
+			, order(resource)
+		{}
+		RTree(const rect_t* rects, std::size_t count, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: RTree(resource)
+		{
+			build(rects, count);
+		}
+		RTree(const std::vector<rect_t>& rects, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: RTree(resource)
+		{
+			build(rects.data(), rects.size());
+		}
+
+		// Replace the content of the tree, rect i is reported by the queries as index i.
+		// The buffers keep their capacity, rebuilding with no more rects than before does not allocate.
+		void build(const rect_t* rects, std::size_t count) {
+			nodes.clear();
+			levels = 0;
+			items = count;
+			if (count == 0) {
+				return;
+			}
+
+			std::size_t total = 0;
+			for (std::size_t size = count; size > 1 || total == 0;) {
+				size = (size + Fanout - 1) / Fanout;
+				total += size;
+			}
+			nodes.reserve(total);
+			level.assign(rects, rects + count);
+			order.resize(count);
+			bool leaf = true;
+			std::uint32_t first = 0;
+
+			// One level per pass, bottom up, until a single node is left.
+			for (;;) {
+				std::size_t size = level.size();
+				for (std::size_t i = 0; i < size; ++i) {
+					order[i] = static_cast<std::uint32_t>(i);
+				}
+				intern::str_tile(order.data(), order.data() + size, 0, N, (size + Fanout - 1) / Fanout, Fanout, [this](std::uint32_t i, int axis) {
+					return level[i].min[axis] + level[i].max[axis];
+				});
+
+				std::size_t parents = (size + Fanout - 1) / Fanout;
+				std::uint32_t start = static_cast<std::uint32_t>(nodes.size());
+				nodes.resize(nodes.size() + parents);
+				above.resize(parents);
+
+				for (std::size_t p = 0; p < parents; ++p) {
+					Node& node = nodes[start + p];
+					std::size_t begin = p * Fanout, end = std::min(size, begin + Fanout);
+					node.count = static_cast<std::uint32_t>(end - begin);
+					node.leaf = leaf;
+					for (std::size_t c = 0; c < node.count; ++c) {
+						std::uint32_t index = order[begin + c];
+						const rect_t& child = level[index];
+						node.child[c] = leaf ? index : first + index;
+						for (int k = 0; k < N; ++k) {
+							node.min[k][c] = child.min[k];
+							node.max[k][c] = child.max[k];
+						}
+						if (c == 0) {
+							above[p] = child;
+						}
+						else {
+							above[p].merge(child);
+						}
+					}
+				}
+
+				++levels;
+				first = start;
+				leaf = false;
+				level.swap(above);
+				if (parents == 1) {
+					bound = level[0];
+					break;
+				}
+			}
+			// Each level swapped the buffers, put the one sized for the rects back in level so the next build finds it there.
+			if (levels % 2 == 1) {
+				level.swap(above);
+			}
+		}
+
+		// The number of rects in the tree.
+		std::size_t size() const noexcept {
+			return items;
+		}
+		bool empty() const noexcept {
+			return items == 0;
+		}
+		std::size_t nodeCount() const noexcept {
+			return nodes.size();
+		}
+		// The number of levels, a tree with a single leaf has a depth of one.
+		std::size_t depth() const noexcept {
+			return levels;
+		}
+		// Bounds of every rect of the tree, only meaningful when the tree is not empty.
+		const rect_t& bounds() const noexcept {
+			return bound;
+		}
+		std::pmr::memory_resource* resource() const noexcept {
+			return nodes.get_allocator().resource();
+		}
+
+		// Appends the indices of the rects overlapping the region, returns the number of indices appended.
+		std::size_t query(const rect_t& region, std::vector<std::uint32_t>& out) const {
+			std::size_t start = out.size();
+			walk([&](const Node& node, std::size_t c) {
+				bool overlap = true;
+				for (int k = 0; k < N; ++k) {
+					overlap &= (node.min[k][c] < region.max[k]) & (region.min[k] < node.max[k][c]);
+				}
+				return overlap;
+			}, out);
+			return out.size() - start;
+		}
+
+		// Appends the indices of the rects containing the point, returns the number of indices appended.
+		std::size_t query(const vec_t& point, std::vector<std::uint32_t>& out) const {
+			std::size_t start = out.size();
+			// Contains only moves toward true as a rect grows, so it also holds for every node on the way to a match.
+			walk([&](const Node& node, std::size_t c) {
+				return node.rect(c).contains(point);
+			}, out);
+			return out.size() - start;
+		}
+
+		// Appends the indices of the k rects nearest to the point, closest first, rects containing the point are at distance zero.
+		// When distances is given it receives the matching squared distances. Returns the number of indices appended.
+		std::size_t nearest(const vec_t& point, std::size_t k, std::vector<std::uint32_t>& out, std::vector<T>* distances = nullptr) const {
+			if (nodes.empty() || k == 0) {
+				return 0;
+			}
+			EZ_GEO_STAT_EVENT(Query);
+
+			// Best first search, a popped entry is closer than anything left in the heap, so popped rects come out in order.
+			struct Entry {
+				T dist;
+				std::uint32_t index;
+				bool item;
+			};
+			auto further = [](const Entry& l, const Entry& r) {
+				return l.dist > r.dist;
+			};
+			std::byte local[intern::QueryStackBytes];
+			std::pmr::monotonic_buffer_resource scratch{ local, sizeof(local), nodes.get_allocator().resource() };
+			std::pmr::vector<Entry> heap{ &scratch };
+			heap.reserve(intern::QueryStackBytes / sizeof(Entry) - 1);
+			heap.push_back(Entry{ T(0), static_cast<std::uint32_t>(nodes.size() - 1), false });
+
+			std::size_t found = 0;
+			while (!heap.empty() && found < k) {
+				std::pop_heap(heap.begin(), heap.end(), further);
+				Entry top = heap.back();
+				heap.pop_back();
+				if (top.item) {
+					out.push_back(top.index);
+					if (distances) {
+						distances->push_back(top.dist);
+					}
+					++found;
+					continue;
+				}
+
+				const Node& node = nodes[top.index];
+				if (node.leaf) {
+					EZ_GEO_STAT_EVENT(LeafVisit);
+				}
+				else {
+					EZ_GEO_STAT_EVENT(NodeVisit);
+				}
+				for (std::size_t c = 0; c < node.count; ++c) {
+					T dist = T(0);
+					for (int a = 0; a < N; ++a) {
+						T d = std::max(std::max(node.min[a][c] - point[a], point[a] - node.max[a][c]), T(0));
+						dist += d * d;
+					}
+					heap.push_back(Entry{ dist, node.child[c], node.leaf });
+					std::push_heap(heap.begin(), heap.end(), further);
+				}
+			}
+			return found;
+		}
+	private:
+		struct Node {
+			rect_t rect(std::size_t c) const noexcept {
+				rect_t ret;
+				for (int k = 0; k < N; ++k) {
+					ret.min[k] = min[k][c];
+					ret.max[k] = max[k][c];
+				}
+				return ret;
+			}
+
+			alignas(64) T min[N][Fanout];
+			T max[N][Fanout];
+			// Node indices in inner nodes, rect indices in leaves.
+			std::uint32_t child[Fanout];
+			std::uint32_t count;
+			bool leaf;
+		};
+
+		// Depth first descent into the children passing the test, the rects passing it in the leaves are appended to out.
+		template<typename F>
+		void walk(F&& test, std::vector<std::uint32_t>& out) const {
+			if (nodes.empty()) {
+				return;
+			}
+			EZ_GEO_STAT_EVENT(Query);
+
+			// Each level pushes at most Fanout entries and pops one, and the depth is below 32 since indices are 32 bits.
+			std::uint32_t stack[32 * Fanout];
+			std::size_t top = 0;
+			stack[top++] = static_cast<std::uint32_t>(nodes.size() - 1);
+
+			while (top != 0) {
+				const Node& node = nodes[stack[--top]];
+				bool pass[Fanout];
+				for (std::size_t c = 0; c < node.count; ++c) {
+					pass[c] = test(node, c);
+				}
+
+				if (node.leaf) {
+					EZ_GEO_STAT_EVENT(LeafVisit);
+					for (std::size_t c = 0; c < node.count; ++c) {
+						if (pass[c]) {
+							out.push_back(node.child[c]);
+						}
+					}
+					continue;
+				}
+
+				EZ_GEO_STAT_EVENT(NodeVisit);
+				for (std::size_t c = node.count; c-- > 0;) {
+					if (pass[c]) {
+						stack[top++] = node.child[c];
+					}
+					else {
+						EZ_GEO_STAT_EVENT(EarlyOut);
+					}
+				}
+			}
+		}
+
+		std::pmr::vector<Node> nodes;
+		// Build scratch, the bounds of the level being packed and of the one above it, kept to reuse the memory.
+		std::pmr::vector<rect_t> level, above;
+		std::pmr::vector<std::uint32_t> order;
+		rect_t bound;
+		std::size_t items = 0;
+		std::size_t levels = 0;
+	};
+
+	template<typename T>
+	using RTree2 = RTree<T, 2>;
+	template<typename T>
+	using RTree3 = RTree<T, 3>;
+};
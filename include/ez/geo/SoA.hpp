@@ -0,0 +1,421 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "Line.hpp"
+#include "MMRect.hpp"
+#include "Circle.hpp"
+#include "Sphere.hpp"
+#include "Capsule.hpp"
+#include "OBB.hpp"
+#include "Transform.hpp"
+
+// Structure of arrays containers for the batch kernels.
+// Each coordinate axis is stored in its own contiguous array, so a kernel working on one axis at a time streams through memory
+// and the compiler is free to vectorize the inner loops.
+
+namespace ez {
+	template<typename T, int N>
+	struct PointSoA {
+		static_assert(N > 1 && N < 5, "ez::PointSoA requires 2, 3 or 4 dimensions!");
+		using vec_t = glm::vec<N, T>;
+		static constexpr int Components = N;
+
+		std::size_t size() const noexcept {
+			return axes[0].size();
+		}
+		bool empty() const noexcept {
+			return axes[0].empty();
+		}
+
+		void reserve(std::size_t count) {
+			for (std::vector<T>& axis : axes) {
+				axis.reserve(count);
+			}
+		}
+		void resize(std::size_t count) {
+			for (std::vector<T>& axis : axes) {
+				axis.resize(count);
+			}
+		}
+		void clear() noexcept {
+			for (std::vector<T>& axis : axes) {
+				axis.clear();
+			}
+		}
+
+		void push_back(const vec_t& point) {
+			for (int i = 0; i < N; ++i) {
+				axes[i].push_back(point[i]);
+			}
+		}
+
+		vec_t get(std::size_t index) const noexcept {
+			vec_t ret;
+			for (int i = 0; i < N; ++i) {
+				ret[i] = axes[i][index];
+			}
+			return ret;
+		}
+		void set(std::size_t index, const vec_t& point) noexcept {
+			for (int i = 0; i < N; ++i) {
+				axes[i][index] = point[i];
+			}
+		}
+
+		T* data(int axis) noexcept {
+			return axes[axis].data();
+		}
+		const T* data(int axis) const noexcept {
+			return axes[axis].data();
+		}
+
+		std::array<std::vector<T>, N> axes;
+	};
+
+	template<typename T, int N>
+	struct MMRectSoA {
+		using rect_t = MMRect<T, N>;
+		using vec_t = glm::vec<N, T>;
+		static constexpr int Components = N;
+
+		std::size_t size() const noexcept {
+			return min.size();
+		}
+		bool empty() const noexcept {
+			return min.empty();
+		}
+
+		void reserve(std::size_t count) {
+			min.reserve(count);
+			max.reserve(count);
+		}
+		void resize(std::size_t count) {
+			min.resize(count);
+			max.resize(count);
+		}
+		void clear() noexcept {
+			min.clear();
+			max.clear();
+		}
+
+		void push_back(const rect_t& rect) {
+			min.push_back(rect.min);
+			max.push_back(rect.max);
+		}
+
+		rect_t get(std::size_t index) const noexcept {
+			return rect_t{ min.get(index), max.get(index) };
+		}
+		void set(std::size_t index, const rect_t& rect) noexcept {
+			min.set(index, rect.min);
+			max.set(index, rect.max);
+		}
+
+		PointSoA<T, N> min, max;
+	};
+
+	template<typename T, int N>
+	struct LineSoA {
+		using line_t = Line<T, N>;
+		using vec_t = glm::vec<N, T>;
+		static constexpr int Components = N;
+
+		std::size_t size() const noexcept {
+			return start.size();
+		}
+		bool empty() const noexcept {
+			return start.empty();
+		}
+
+		void reserve(std::size_t count) {
+			start.reserve(count);
+			end.reserve(count);
+		}
+		void resize(std::size_t count) {
+			start.resize(count);
+			end.resize(count);
+		}
+		void clear() noexcept {
+			start.clear();
+			end.clear();
+		}
+
+		void push_back(const line_t& line) {
+			start.push_back(line.start);
+			end.push_back(line.end);
+		}
+
+		line_t get(std::size_t index) const noexcept {
+			return line_t{ start.get(index), end.get(index) };
+		}
+		void set(std::size_t index, const line_t& line) noexcept {
+			start.set(index, line.start);
+			end.set(index, line.end);
+		}
+
+		PointSoA<T, N> start, end;
+	};
+
+	// Circles when N is 2, spheres when N is 3.
+	template<typename T, int N>
+	struct BallSoA {
+		static_assert(N == 2 || N == 3, "ez::BallSoA is only defined for circles and spheres!");
+		using shape_t = std::conditional_t<N == 2, Circle<T>, Sphere<T>>;
+		using vec_t = glm::vec<N, T>;
+		static constexpr int Components = N;
+
+		std::size_t size() const noexcept {
+			return radius.size();
+		}
+		bool empty() const noexcept {
+			return radius.empty();
+		}
+
+		void reserve(std::size_t count) {
+			origin.reserve(count);
+			radius.reserve(count);
+		}
+		void resize(std::size_t count) {
+			origin.resize(count);
+			radius.resize(count);
+		}
+		void clear() noexcept {
+			origin.clear();
+			radius.clear();
+		}
+
+		void push_back(const shape_t& shape) {
+			origin.push_back(shape.origin);
+			radius.push_back(shape.radius);
+		}
+
+		shape_t get(std::size_t index) const noexcept {
+			return shape_t{ radius[index], origin.get(index) };
+		}
+		void set(std::size_t index, const shape_t& shape) noexcept {
+			origin.set(index, shape.origin);
+			radius[index] = shape.radius;
+		}
+
+		PointSoA<T, N> origin;
+		std::vector<T> radius;
+	};
+
+	template<typename T>
+	struct CapsuleSoA {
+		using shape_t = Capsule<T>;
+		using vec_t = glm::tvec3<T>;
+		static constexpr int Components = 3;
+
+		std::size_t size() const noexcept {
+			return radius.size();
+		}
+		bool empty() const noexcept {
+			return radius.empty();
+		}
+
+		void reserve(std::size_t count) {
+			start.reserve(count);
+			end.reserve(count);
+			radius.reserve(count);
+		}
+		void resize(std::size_t count) {
+			start.resize(count);
+			end.resize(count);
+			radius.resize(count);
+		}
+		void clear() noexcept {
+			start.clear();
+			end.clear();
+			radius.clear();
+		}
+
+		void push_back(const shape_t& shape) {
+			start.push_back(shape.segment.start);
+			end.push_back(shape.segment.end);
+			radius.push_back(shape.radius);
+		}
+
+		shape_t get(std::size_t index) const noexcept {
+			return shape_t{ start.get(index), end.get(index), radius[index] };
+		}
+		void set(std::size_t index, const shape_t& shape) noexcept {
+			start.set(index, shape.segment.start);
+			end.set(index, shape.segment.end);
+			radius[index] = shape.radius;
+		}
+
+		PointSoA<T, 3> start, end;
+		std::vector<T> radius;
+	};
+
+	template<typename T, int N>
+	struct OBBSoA {
+		using obb_t = OBB<T, N>;
+		using vec_t = glm::vec<N, T>;
+		static constexpr int Components = N;
+
+		std::size_t size() const noexcept {
+			return origin.size();
+		}
+		bool empty() const noexcept {
+			return origin.empty();
+		}
+
+		void reserve(std::size_t count) {
+			origin.reserve(count);
+			half.reserve(count);
+			for (PointSoA<T, N>& axis : axes) {
+				axis.reserve(count);
+			}
+		}
+		void resize(std::size_t count) {
+			origin.resize(count);
+			half.resize(count);
+			for (PointSoA<T, N>& axis : axes) {
+				axis.resize(count);
+			}
+		}
+		void clear() noexcept {
+			origin.clear();
+			half.clear();
+			for (PointSoA<T, N>& axis : axes) {
+				axis.clear();
+			}
+		}
+
+		void push_back(const obb_t& box) {
+			origin.push_back(box.origin);
+			half.push_back(box.half);
+			for (int i = 0; i < N; ++i) {
+				axes[i].push_back(box.axes[i]);
+			}
+		}
+
+		obb_t get(std::size_t index) const noexcept {
+			obb_t box;
+			box.origin = origin.get(index);
+			box.half = half.get(index);
+			for (int i = 0; i < N; ++i) {
+				box.axes[i] = axes[i].get(index);
+			}
+			return box;
+		}
+		void set(std::size_t index, const obb_t& box) noexcept {
+			origin.set(index, box.origin);
+			half.set(index, box.half);
+			for (int i = 0; i < N; ++i) {
+				axes[i].set(index, box.axes[i]);
+			}
+		}
+
+		// The tight world space bounds of every box, written to out.
+		void bounds(MMRectSoA<T, N>& out) const {
+			std::size_t count = size();
+			out.resize(count);
+			for (int k = 0; k < N; ++k) {
+				const T* o = origin.data(k);
+				T* lo = out.min.data(k);
+				T* hi = out.max.data(k);
+				for (std::size_t j = 0; j < count; ++j) {
+					T extent = T(0);
+					for (int i = 0; i < N; ++i) {
+						extent += std::abs(axes[i].data(k)[j]) * half.data(i)[j];
+					}
+					lo[j] = o[j] - extent;
+					hi[j] = o[j] + extent;
+				}
+			}
+		}
+
+		PointSoA<T, N> origin, half;
+		std::array<PointSoA<T, N>, N> axes;
+	};
+
+	// 3d transforms, the rotation quaternions are stored as x, y, z, w.
+	template<typename T>
+	struct TransformSoA {
+		using transform_t = Transform<T, 3>;
+		using quat_t = glm::tquat<T>;
+
+		std::size_t size() const noexcept {
+			return origin.size();
+		}
+		bool empty() const noexcept {
+			return origin.empty();
+		}
+
+		void reserve(std::size_t count) {
+			origin.reserve(count);
+			scale.reserve(count);
+			rotation.reserve(count);
+		}
+		void resize(std::size_t count) {
+			origin.resize(count);
+			scale.resize(count);
+			rotation.resize(count);
+		}
+		void clear() noexcept {
+			origin.clear();
+			scale.clear();
+			rotation.clear();
+		}
+
+		void push_back(const transform_t& form) {
+			origin.push_back(form.origin);
+			scale.push_back(form.size);
+			rotation.push_back(glm::tvec4<T>{ form.rotation.x, form.rotation.y, form.rotation.z, form.rotation.w });
+		}
+
+		transform_t get(std::size_t index) const noexcept {
+			glm::tvec4<T> q = rotation.get(index);
+			return transform_t{ origin.get(index), quat_t{ q.w, q.x, q.y, q.z }, scale.get(index) };
+		}
+		void set(std::size_t index, const transform_t& form) noexcept {
+			origin.set(index, form.origin);
+			scale.set(index, form.size);
+			rotation.set(index, glm::tvec4<T>{ form.rotation.x, form.rotation.y, form.rotation.z, form.rotation.w });
+		}
+
+		PointSoA<T, 3> origin, scale;
+		PointSoA<T, 4> rotation;
+	};
+
+	template<typename T>
+	using PointSoA2 = PointSoA<T, 2>;
+
+	template<typename T>
+	using PointSoA3 = PointSoA<T, 3>;
+
+	template<typename T>
+	using MMRectSoA2 = MMRectSoA<T, 2>;
+
+	template<typename T>
+	using MMRectSoA3 = MMRectSoA<T, 3>;
+
+	template<typename T>
+	using LineSoA2 = LineSoA<T, 2>;
+
+	template<typename T>
+	using LineSoA3 = LineSoA<T, 3>;
+
+	template<typename T>
+	using CircleSoA = BallSoA<T, 2>;
+
+	template<typename T>
+	using SphereSoA = BallSoA<T, 3>;
+
+	template<typename T>
+	using OBBSoA2 = OBBSoA<T, 2>;
+
+	template<typename T>
+	using OBBSoA3 = OBBSoA<T, 3>;
+};
\ No newline at end of file
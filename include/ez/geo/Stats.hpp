@@ -0,0 +1,233 @@
+#pragma once
+#include <array>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Opt in instrumentation of the query paths.
+Define EZ_GEO_INSTRUMENT before including any ez-geo header (or configure cmake with EZ_GEO_INSTRUMENT=ON) to enable it.
+When it is not defined the counting macros expand to nothing, so there is no cost at all.
+
+Counters are kept per thread with no synchronization. A thread calls flush_stats to add its counters to the process wide totals,
+and global_stats returns a copy of those totals. StatScope measures the work done by a single query on the current thread.
+The instrumentation must be enabled or disabled the same way in every translation unit of a program.
+*/
+
+namespace ez {
+	// The kinds of primitive tests counted, one per family of intersect overloads.
+	enum class StatTest : int {
+		LineLine,
+		RayAABB,
+		RayPlane,
+		RaySphere,
+		RayOBB,
+		RectRect,
+		SphereSphere,
+		CircleCircle,
+		SphereRect,
+		CircleRect,
+		OBBOBB,
+		RayCapsule,
+		CapsuleCapsule,
+		CapsuleSphere,
+		CapsuleRect,
+		Count
+	};
+
+	// Other events counted by the query paths.
+	enum class StatEvent : int {
+		Query,
+		NodeVisit,
+		LeafVisit,
+		EarlyOut,
+		RectContains,
+		RectMerge,
+		Count
+	};
+
+	struct QueryStats {
+		static constexpr std::size_t TestCount = static_cast<std::size_t>(StatTest::Count);
+		static constexpr std::size_t EventCount = static_cast<std::size_t>(StatEvent::Count);
+
+		static const char* name(StatTest test) noexcept {
+			static constexpr const char* names[TestCount] = {
+				"line_line",
+				"ray_aabb",
+				"ray_plane",
+				"ray_sphere",
+				"ray_obb",
+				"rect_rect",
+				"sphere_sphere",
+				"circle_circle",
+				"sphere_rect",
+				"circle_rect",
+				"obb_obb",
+				"ray_capsule",
+				"capsule_capsule",
+				"capsule_sphere",
+				"capsule_rect"
+			};
+			return names[static_cast<std::size_t>(test)];
+		}
+		static const char* name(StatEvent event) noexcept {
+			static constexpr const char* names[EventCount] = {
+				"queries",
+				"node_visits",
+				"leaf_visits",
+				"early_outs",
+				"rect_contains",
+				"rect_merges"
+			};
+			return names[static_cast<std::size_t>(event)];
+		}
+
+		std::uint64_t& operator[](StatTest test) noexcept {
+			return tests[static_cast<std::size_t>(test)];
+		}
+		std::uint64_t operator[](StatTest test) const noexcept {
+			return tests[static_cast<std::size_t>(test)];
+		}
+		std::uint64_t& operator[](StatEvent event) noexcept {
+			return events[static_cast<std::size_t>(event)];
+		}
+		std::uint64_t operator[](StatEvent event) const noexcept {
+			return events[static_cast<std::size_t>(event)];
+		}
+
+		// The total number of primitive tests of every kind.
+		std::uint64_t totalTests() const noexcept {
+			std::uint64_t sum = 0;
+			for (std::uint64_t count : tests) {
+				sum += count;
+			}
+			return sum;
+		}
+
+		QueryStats& merge(const QueryStats& other) noexcept {
+			for (std::size_t i = 0; i < TestCount; ++i) {
+				tests[i] += other.tests[i];
+			}
+			for (std::size_t i = 0; i < EventCount; ++i) {
+				events[i] += other.events[i];
+			}
+			return *this;
+		}
+		// The counts accumulated since the earlier snapshot was taken.
+		QueryStats since(const QueryStats& earlier) const noexcept {
+			QueryStats ret;
+			for (std::size_t i = 0; i < TestCount; ++i) {
+				ret.tests[i] = tests[i] - earlier.tests[i];
+			}
+			for (std::size_t i = 0; i < EventCount; ++i) {
+				ret.events[i] = events[i] - earlier.events[i];
+			}
+			return ret;
+		}
+		void reset() noexcept {
+			tests.fill(0);
+			events.fill(0);
+		}
+
+		// A single line JSON object, the events at the top level and the tests in a nested "tests" object.
+		std::string json() const {
+			std::string ret = "{";
+			for (std::size_t i = 0; i < EventCount; ++i) {
+				ret += '"';
+				ret += name(static_cast<StatEvent>(i));
+				ret += "\":";
+				ret += std::to_string(events[i]);
+				ret += ',';
+			}
+			ret += "\"tests\":{";
+			for (std::size_t i = 0; i < TestCount; ++i) {
+				if (i != 0) {
+					ret += ',';
+				}
+				ret += '"';
+				ret += name(static_cast<StatTest>(i));
+				ret += "\":";
+				ret += std::to_string(tests[i]);
+			}
+			ret += "}}";
+			return ret;
+		}
+
+		std::array<std::uint64_t, TestCount> tests{};
+		std::array<std::uint64_t, EventCount> events{};
+	};
+
+#ifdef EZ_GEO_INSTRUMENT
+	static constexpr bool StatsEnabled = true;
+#else
+	static constexpr bool StatsEnabled = false;
+#endif
+
+	namespace intern {
+		struct StatTotals {
+			std::mutex lock;
+			QueryStats stats;
+		};
+
+		inline StatTotals& stat_totals() noexcept {
+			static StatTotals totals;
+			return totals;
+		}
+	}
+
+	// The live counters of the calling thread.
+	inline QueryStats& thread_stats() noexcept {
+		thread_local QueryStats stats;
+		return stats;
+	}
+
+	// Add the counters of the calling thread to the process wide totals, then reset them.
+	inline void flush_stats() {
+		intern::StatTotals& totals = intern::stat_totals();
+		std::lock_guard<std::mutex> guard{ totals.lock };
+		totals.stats.merge(thread_stats());
+		thread_stats().reset();
+	}
+
+	// A copy of the process wide totals, only includes the threads that have flushed.
+	inline QueryStats global_stats() {
+		intern::StatTotals& totals = intern::stat_totals();
+		std::lock_guard<std::mutex> guard{ totals.lock };
+		return totals.stats;
+	}
+
+	// Clear the process wide totals and the counters of the calling thread.
+	inline void reset_stats() {
+		intern::StatTotals& totals = intern::stat_totals();
+		std::lock_guard<std::mutex> guard{ totals.lock };
+		totals.stats.reset();
+		thread_stats().reset();
+	}
+
+	// Measures the work done on the current thread while it is alive, and counts as one query.
+	class StatScope {
+	public:
+		StatScope() noexcept
+			: start(thread_stats())
+		{
+			if constexpr (StatsEnabled) {
+				++thread_stats()[StatEvent::Query];
+			}
+		}
+
+		QueryStats delta() const noexcept {
+			return thread_stats().since(start);
+		}
+	private:
+		QueryStats start;
+	};
+};
+
+#ifdef EZ_GEO_INSTRUMENT
+	#define EZ_GEO_STAT_TEST(kind) (++::ez::thread_stats()[::ez::StatTest::kind])
+	#define EZ_GEO_STAT_EVENT(kind) (++::ez::thread_stats()[::ez::StatEvent::kind])
+#else
+	#define EZ_GEO_STAT_TEST(kind) ((void)0)
+	#define EZ_GEO_STAT_EVENT(kind) ((void)0)
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <glm/geometric.hpp>
+
+#include "MMRect.hpp"
+#include "Sphere.hpp"
+#include "Line.hpp"
+#include "Capsule.hpp"
+#include "OBB.hpp"
+#include "Transform.hpp"
+
+/*
+Support functions for convex shapes.
+A convex shape is any type for which support(shape, dir) returns the point of the shape farthest along dir.
+The function is found through argument dependent lookup, so user types can take part by defining their own overload in their namespace.
+The direction does not need to be normalized, but will never be the zero vector.
+*/
+
+namespace ez {
+	template<typename T>
+	glm::tvec3<T> support(const glm::tvec3<T>& point, const glm::tvec3<T>&) noexcept {
+		return point;
+	}
+
+	template<typename T>
+	glm::tvec3<T> support(const Sphere<T>& sphere, const glm::tvec3<T>& dir) noexcept {
+		return sphere.origin + dir * (sphere.radius / glm::length(dir));
+	}
+
+	template<typename T>
+	glm::tvec3<T> support(const MMRect<T, 3>& box, const glm::tvec3<T>& dir) noexcept {
+		return glm::tvec3<T>{
+			dir.x < T(0) ? box.min.x : box.max.x,
+			dir.y < T(0) ? box.min.y : box.max.y,
+			dir.z < T(0) ? box.min.z : box.max.z
+		};
+	}
+
+	template<typename T>
+	glm::tvec3<T> support(const OBB<T, 3>& box, const glm::tvec3<T>& dir) noexcept {
+		glm::tvec3<T> ret = box.origin;
+		for (int i = 0; i < 3; ++i) {
+			T h = glm::dot(dir, box.axes[i]) < T(0) ? -box.half[i] : box.half[i];
+			ret += box.axes[i] * h;
+		}
+		return ret;
+	}
+
+	template<typename T>
+	glm::tvec3<T> support(const Line3<T>& line, const glm::tvec3<T>& dir) noexcept {
+		return glm::dot(line.end - line.start, dir) > T(0) ? line.end : line.start;
+	}
+
+	template<typename T>
+	glm::tvec3<T> support(const Capsule<T>& capsule, const glm::tvec3<T>& dir) noexcept {
+		return support(capsule.segment, dir) + dir * (capsule.radius / glm::length(dir));
+	}
+
+	// Non-owning view of a point cloud, the shape is the convex hull of the points.
+	template<typename T>
+	struct ConvexHull {
+		using vec3_t = glm::tvec3<T>;
+
+		ConvexHull(const vec3_t* _points, std::size_t _count) noexcept
+			: points(_points)
+			, count(_count)
+		{}
+
+		const vec3_t* points;
+		std::size_t count;
+	};
+
+	template<typename T>
+	glm::tvec3<T> support(const ConvexHull<T>& hull, const glm::tvec3<T>& dir) noexcept {
+		std::size_t best = 0;
+		T dist = std::numeric_limits<T>::lowest();
+		for (std::size_t i = 0; i < hull.count; ++i) {
+			T d = glm::dot(hull.points[i], dir);
+			if (d > dist) {
+				dist = d;
+				best = i;
+			}
+		}
+		return hull.points[best];
+	}
+
+	// A shape swept by a sphere, the minkowski sum of the shape and a ball. A capsule is an inflated Line3.
+	template<typename S, typename T>
+	struct Inflated {
+		Inflated(const S& _shape, T _radius) noexcept
+			: shape(_shape)
+			, radius(_radius)
+		{}
+
+		const S& shape;
+		T radius;
+	};
+
+	template<typename S, typename T>
+	glm::tvec3<T> support(const Inflated<S, T>& shape, const glm::tvec3<T>& dir) noexcept {
+		return support(shape.shape, dir) + dir * (shape.radius / glm::length(dir));
+	}
+
+	// A shape defined in the local space of a transform.
+	template<typename S, typename T>
+	struct Transformed {
+		Transformed(const S& _shape, const Transform<T, 3>& _form) noexcept
+			: shape(_shape)
+			, form(_form)
+		{}
+
+		const S& shape;
+		Transform<T, 3> form;
+	};
+
+	// The transform is M = R * S, the support of M(shape) along d is M applied to the support of the shape along transpose(M) * d.
+	template<typename S, typename T>
+	glm::tvec3<T> support(const Transformed<S, T>& shape, const glm::tvec3<T>& dir) noexcept {
+		glm::tvec3<T> local = glm::rotate(glm::conjugate(shape.form.rotation), dir) * shape.form.size;
+		return shape.form.toWorld(support(shape.shape, local));
+	}
+};
\ No newline at end of file
@@ -0,0 +1,345 @@
+#pragma once
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <glm/geometric.hpp>
+
+#include "Intersect.hpp"
+#include "BatchIntersect.hpp"
+
+/*
+Continuous collision detection.
+Each sweep moves the first shape by motion over the interval t in [0, 1] and reports the earliest time of impact with the second shape.
+The tests reduce the moving shape to a point through the minkowski sum, then reuse the ray tests from Intersect.hpp with the motion as the ray axis.
+The reported normal is the surface normal of the obstacle at the contact, pointing toward the moving shape.
+Shapes that already overlap at t = 0 report a hit at t = 0.
+*/
+
+namespace ez {
+	template<typename T>
+	struct SweepHit {
+		std::uint32_t index;
+		T t;
+		glm::tvec3<T> normal;
+	};
+
+	namespace intern {
+		template<typename T>
+		glm::tvec3<T> box_corner(const AABB3<T>& box, int n) noexcept {
+			return glm::tvec3<T>{
+				(n & 1) ? box.max.x : box.min.x,
+				(n & 2) ? box.max.y : box.min.y,
+				(n & 4) ? box.max.z : box.min.z
+			};
+		}
+
+		// Direction from the closest point of the box toward the point, falls back to the given direction inside the box.
+		template<typename T>
+		glm::tvec3<T> box_normal(const AABB3<T>& box, const glm::tvec3<T>& point, const glm::tvec3<T>& fallback) noexcept {
+			glm::tvec3<T> d = point - glm::clamp(point, box.min, box.max);
+			T len = glm::length(d);
+			return len > T(0) ? d / len : fallback;
+		}
+
+		template<typename T>
+		glm::tvec3<T> fallback_normal(const glm::tvec3<T>& motion) noexcept {
+			T len = glm::length(motion);
+			return len > T(0) ? -motion / len : glm::tvec3<T>{ T(0), T(1), T(0) };
+		}
+	}
+
+	// Moving sphere against a box, from Ericson, Real-Time Collision Detection 5.5.7.
+	// The box expanded by the radius catches the face regions with a single ray test, edge and corner regions fall back to the rounded edges.
+	template<typename T>
+	bool sweep(const Sphere<T>& sphere, const glm::tvec3<T>& motion, const AABB3<T>& box, T& t, glm::tvec3<T>& normal) noexcept {
+		using vec3_t = glm::tvec3<T>;
+
+		if (intersect(sphere, box)) {
+			t = T(0);
+			normal = intern::box_normal(box, sphere.origin, intern::fallback_normal(motion));
+			return true;
+		}
+
+		T tmin, tmax;
+		intern::ray_slabs(sphere.origin, T(1) / motion, box.min - sphere.radius, box.max + sphere.radius, tmin, tmax);
+		if (tmax < tmin || tmin > T(1) || tmax < T(0)) {
+			return false;
+		}
+		tmin = std::max(tmin, T(0));
+
+		// Which sides of the box the hit point lies outside of, u for below the min and v for above the max.
+		vec3_t p = sphere.origin + motion * tmin;
+		int u = 0, v = 0;
+		for (int i = 0; i < 3; ++i) {
+			if (p[i] < box.min[i]) {
+				u |= 1 << i;
+			}
+			if (p[i] > box.max[i]) {
+				v |= 1 << i;
+			}
+		}
+		int mask = u + v;
+
+		T hit = tmin;
+		if (mask == 7) {
+			// Corner region, any of the three edges meeting at the corner.
+			hit = std::numeric_limits<T>::max();
+			for (int bit = 1; bit < 8; bit <<= 1) {
+				T edge;
+				if (intern::ray_capsule(sphere.origin, motion, intern::box_corner(box, v), intern::box_corner(box, v ^ bit), sphere.radius, edge)) {
+					hit = std::min(hit, edge);
+				}
+			}
+			if (hit == std::numeric_limits<T>::max()) {
+				return false;
+			}
+		}
+		else if ((mask & (mask - 1)) != 0) {
+			// Edge region
+			if (!intern::ray_capsule(sphere.origin, motion, intern::box_corner(box, u ^ 7), intern::box_corner(box, v), sphere.radius, hit)) {
+				return false;
+			}
+		}
+
+		if (hit > T(1)) {
+			return false;
+		}
+		t = hit;
+		normal = intern::box_normal(box, sphere.origin + motion * hit, intern::fallback_normal(motion));
+		return true;
+	}
+
+	// Moving sphere against a plane, the plane is offset by the radius toward the sphere and hit with a ray.
+	template<typename T>
+	bool sweep(const Sphere<T>& sphere, const glm::tvec3<T>& motion, const Plane3<T>& plane, T& t, glm::tvec3<T>& normal) noexcept {
+		T dist = plane.distanceFrom(sphere.origin);
+		T side = dist < T(0) ? T(-1) : T(1);
+
+		if (std::abs(dist) <= sphere.radius) {
+			t = T(0);
+			normal = plane.normal * side;
+			return true;
+		}
+
+		Plane3<T> offset{ plane.normal, plane.origin + plane.normal * (sphere.radius * side) };
+		T hit;
+		if (!intersect(Ray3<T>{ motion, sphere.origin }, offset, hit) || hit > T(1)) {
+			return false;
+		}
+		t = hit;
+		normal = plane.normal * side;
+		return true;
+	}
+
+	// Moving sphere against the triangle a b c, the face first, then the rounded edges.
+	template<typename T>
+	bool sweep(const Sphere<T>& sphere, const glm::tvec3<T>& motion, const glm::tvec3<T>& a, const glm::tvec3<T>& b, const glm::tvec3<T>& c, T& t, glm::tvec3<T>& normal) noexcept {
+		using vec3_t = glm::tvec3<T>;
+
+		vec3_t n = glm::cross(b - a, c - a);
+		T len = glm::length(n);
+
+		auto insideTriangle = [&](const vec3_t& p) {
+			return
+				glm::dot(glm::cross(b - a, p - a), n) >= T(0) &&
+				glm::dot(glm::cross(c - b, p - b), n) >= T(0) &&
+				glm::dot(glm::cross(a - c, p - c), n) >= T(0);
+		};
+
+		if (len > T(0)) {
+			n /= len;
+
+			T face;
+			vec3_t faceNormal;
+			if (sweep(sphere, motion, Plane3<T>{ n, a }, face, faceNormal)) {
+				// The point of the plane touched first, inside the triangle means the face is the first contact.
+				vec3_t center = sphere.origin + motion * face;
+				vec3_t contact = center - n * glm::dot(n, center - a);
+				if (insideTriangle(contact)) {
+					t = face;
+					normal = faceNormal;
+					return true;
+				}
+			}
+		}
+
+		T hit = std::numeric_limits<T>::max();
+		const vec3_t* verts[3] = { &a, &b, &c };
+		for (int i = 0; i < 3; ++i) {
+			T edge;
+			if (intern::ray_capsule(sphere.origin, motion, *verts[i], *verts[(i + 1) % 3], sphere.radius, edge)) {
+				hit = std::min(hit, edge);
+			}
+		}
+		if (hit > T(1)) {
+			return false;
+		}
+
+		// Normal from the closest point of the touched edge.
+		vec3_t center = sphere.origin + motion * hit;
+		T bestDist = std::numeric_limits<T>::max();
+		normal = len > T(0) ? n : intern::fallback_normal(motion);
+		for (int i = 0; i < 3; ++i) {
+			vec3_t e0 = *verts[i], e1 = *verts[(i + 1) % 3];
+			vec3_t ed = e1 - e0;
+			T dd = glm::dot(ed, ed);
+			T s = dd > T(0) ? std::min(std::max(glm::dot(center - e0, ed) / dd, T(0)), T(1)) : T(0);
+			vec3_t d = center - (e0 + ed * s);
+			T dist = glm::dot(d, d);
+			if (dist < bestDist && dist > T(0)) {
+				bestDist = dist;
+				normal = d / std::sqrt(dist);
+			}
+		}
+		t = hit;
+		return true;
+	}
+
+	// Moving box against a box, a ray from the center of the moving box against the other expanded by its half size.
+	template<typename T>
+	bool sweep(const AABB3<T>& moving, const glm::tvec3<T>& motion, const AABB3<T>& box, T& t, glm::tvec3<T>& normal) noexcept {
+		using vec3_t = glm::tvec3<T>;
+
+		vec3_t half = moving.size() / T(2);
+		vec3_t origin = moving.center();
+		vec3_t lo = box.min - half, hi = box.max + half;
+
+		if (intersect(moving, box)) {
+			t = T(0);
+			normal = intern::fallback_normal(motion);
+			return true;
+		}
+
+		vec3_t inverseAxis = T(1) / motion;
+		T tmin, tmax;
+		intern::ray_slabs(origin, inverseAxis, lo, hi, tmin, tmax);
+		if (tmax < tmin || tmin > T(1) || tmin < T(0)) {
+			return false;
+		}
+
+		// The entering slab is the one that set tmin.
+		normal = vec3_t{ T(0) };
+		for (int i = 0; i < 3; ++i) {
+			T t1 = (lo[i] - origin[i]) * inverseAxis[i];
+			T t2 = (hi[i] - origin[i]) * inverseAxis[i];
+			if (std::min(t1, t2) == tmin) {
+				normal[i] = motion[i] > T(0) ? T(-1) : T(1);
+				break;
+			}
+		}
+		t = tmin;
+		return true;
+	}
+
+	namespace intern {
+		// Conservative filter for the batch sweeps, the swept segment against each box expanded by a margin.
+		template<typename T>
+		struct SweepKernel {
+			bool operator()(std::size_t j) const noexcept {
+				T tmin = T(0), tmax = T(1);
+				for (int k = 0; k < 3; ++k) {
+					T t1 = (min[k][j] - margin[k] - origin[k]) * inverseAxis[k];
+					T t2 = (max[k][j] + margin[k] - origin[k]) * inverseAxis[k];
+					tmin = std::max(tmin, std::min(t1, t2));
+					tmax = std::min(tmax, std::max(t1, t2));
+				}
+				return tmin <= tmax;
+			}
+
+			T origin[3], inverseAxis[3], margin[3];
+			const T* min[3];
+			const T* max[3];
+		};
+
+		template<typename T>
+		SweepKernel<T> sweep_kernel(const glm::tvec3<T>& origin, const glm::tvec3<T>& motion, const glm::tvec3<T>& margin, const MMRectSoA3<T>& set) noexcept {
+			SweepKernel<T> k;
+			for (int i = 0; i < 3; ++i) {
+				k.origin[i] = origin[i];
+				k.inverseAxis[i] = T(1) / motion[i];
+				k.margin[i] = margin[i];
+				k.min[i] = set.min.data(i);
+				k.max[i] = set.max.data(i);
+			}
+			return k;
+		}
+	}
+
+	/*
+	Sweep one shape through a whole set, appending a hit for every element touched during the motion. Returns the number appended.
+	A vectorized slab pass over the structure of arrays rejects most of the set before the exact test runs on the survivors.
+	*/
+	template<typename T>
+	std::size_t sweep_batch(const Sphere<T>& sphere, const glm::tvec3<T>& motion, const MMRectSoA3<T>& set, std::vector<SweepHit<T>>& hits) {
+		std::vector<std::uint32_t> candidates;
+		intern::compact_indices(intern::sweep_kernel(sphere.origin, motion, glm::tvec3<T>{ sphere.radius }, set), 0, set.size(), candidates);
+
+		std::size_t start = hits.size();
+		for (std::uint32_t index : candidates) {
+			SweepHit<T> hit;
+			if (sweep(sphere, motion, set.get(index), hit.t, hit.normal)) {
+				hit.index = index;
+				hits.push_back(hit);
+			}
+		}
+		return hits.size() - start;
+	}
+
+	template<typename T>
+	std::size_t sweep_batch(const AABB3<T>& moving, const glm::tvec3<T>& motion, const MMRectSoA3<T>& set, std::vector<SweepHit<T>>& hits) {
+		std::vector<std::uint32_t> candidates;
+		intern::compact_indices(intern::sweep_kernel(moving.center(), motion, moving.size() / T(2), set), 0, set.size(), candidates);
+
+		std::size_t start = hits.size();
+		for (std::uint32_t index : candidates) {
+			SweepHit<T> hit;
+			if (sweep(moving, motion, set.get(index), hit.t, hit.normal)) {
+				hit.index = index;
+				hits.push_back(hit);
+			}
+		}
+		return hits.size() - start;
+	}
+
+	// Moving sphere against a set of spheres, each test is a ray against a sphere with the summed radius.
+	template<typename T>
+	std::size_t sweep_batch(const Sphere<T>& sphere, const glm::tvec3<T>& motion, const SphereSoA<T>& set, std::vector<SweepHit<T>>& hits) {
+		std::size_t start = hits.size();
+		Ray3<T> ray{ motion, sphere.origin };
+		for (std::size_t i = 0; i < set.size(); ++i) {
+			Sphere<T> other = set.get(i);
+			other.radius += sphere.radius;
+
+			SweepHit<T> hit;
+			glm::tvec3<T> d = sphere.origin - other.origin;
+			if (glm::dot(d, d) <= other.radius * other.radius) {
+				hit.t = T(0);
+			}
+			else if (!intersect(ray, other, hit.t) || hit.t > T(1)) {
+				continue;
+			}
+
+			d = ray.eval(hit.t) - other.origin;
+			T len = glm::length(d);
+			hit.normal = len > T(0) ? d / len : intern::fallback_normal(motion);
+			hit.index = static_cast<std::uint32_t>(i);
+			hits.push_back(hit);
+		}
+		return hits.size() - start;
+	}
+
+	// The earliest hit of a batch sweep, false when nothing is touched.
+	template<typename T, typename S, typename Set>
+	bool sweep_first(const S& shape, const glm::tvec3<T>& motion, const Set& set, SweepHit<T>& first) {
+		std::vector<SweepHit<T>> hits;
+		if (sweep_batch(shape, motion, set, hits) == 0) {
+			return false;
+		}
+		first = *std::min_element(hits.begin(), hits.end(), [](const SweepHit<T>& a, const SweepHit<T>& b) {
+			return a.t < b.t;
+		});
+		return true;
+	}
+};
\ No newline at end of file
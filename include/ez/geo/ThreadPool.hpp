@@ -0,0 +1,242 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/*
+A small persistent work stealing pool for the parallel batch paths.
+
+An executor is any object that can be called as exec(tasks, func), which must call func(task) exactly once for every task in [0, tasks)
+and return once all of them are done. ThreadPool and SerialExecutor both fit, and so does any adapter over an existing job system.
+
+The tasks of a job are split into one contiguous range per worker. A worker takes tasks from the front of its own range,
+and once it runs dry steals from the back of the other ranges. The calling thread works as the first worker, so a pool of size one
+runs everything inline. Tasks must not throw, and a pool must not be used from inside one of its own tasks.
+*/
+
+namespace ez {
+	// Runs every task on the calling thread, in order.
+	struct SerialExecutor {
+		template<typename F>
+		void operator()(std::size_t tasks, F&& func) const {
+			for (std::size_t i = 0; i < tasks; ++i) {
+				func(i);
+			}
+		}
+	};
+
+	class ThreadPool {
+	public:
+		// The number of workers including the calling thread, zero uses the hardware concurrency.
+		explicit ThreadPool(std::size_t threads = 0)
+			: ranges(std::max<std::size_t>(threads == 0 ? std::thread::hardware_concurrency() : threads, 1))
+		{
+			workers.reserve(ranges.size() - 1);
+			for (std::size_t w = 1; w < ranges.size(); ++w) {
+				workers.emplace_back([this, w]() {
+					work(w);
+				});
+			}
+		}
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> guard{ lock };
+				stop = true;
+			}
+			wake.notify_all();
+			for (std::thread& t : workers) {
+				t.join();
+			}
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		std::size_t size() const noexcept {
+			return ranges.size();
+		}
+
+		// Run func(task) for every task in [0, tasks), returns once they are all done.
+		template<typename F>
+		void operator()(std::size_t tasks, F&& func) {
+			if (tasks == 0) {
+				return;
+			}
+			if (ranges.size() == 1 || tasks == 1) {
+				SerialExecutor{}(tasks, func);
+				return;
+			}
+
+			using func_t = std::remove_reference_t<F>;
+			Job job;
+			job.context = static_cast<void*>(std::addressof(func));
+			job.invoke = [](void* context, std::size_t task) {
+				(*static_cast<func_t*>(context))(task);
+			};
+
+			std::lock_guard<std::mutex> submit{ submitLock };
+			remaining.store(tasks, std::memory_order_relaxed);
+
+			// Even split, the first ranges take the remainder.
+			std::size_t count = ranges.size();
+			std::size_t share = tasks / count, extra = tasks % count, begin = 0;
+			for (std::size_t w = 0; w < count; ++w) {
+				std::size_t end = begin + share + (w < extra ? 1 : 0);
+				ranges[w].bounds.store(pack(begin, end), std::memory_order_relaxed);
+				begin = end;
+			}
+
+			{
+				std::lock_guard<std::mutex> guard{ lock };
+				current = &job;
+				++generation;
+			}
+			wake.notify_all();
+
+			run(job, 0);
+
+			std::unique_lock<std::mutex> guard{ lock };
+			done.wait(guard, [this]() {
+				return remaining.load(std::memory_order_acquire) == 0 && active == 0;
+			});
+			current = nullptr;
+		}
+	private:
+		struct Job {
+			void* context;
+			void (*invoke)(void*, std::size_t);
+		};
+
+		// Packed [begin, end) so a single compare exchange moves either end.
+		struct alignas(64) Range {
+			std::atomic<std::uint64_t> bounds{ 0 };
+		};
+
+		static std::uint64_t pack(std::size_t begin, std::size_t end) noexcept {
+			return static_cast<std::uint64_t>(begin) | (static_cast<std::uint64_t>(end) << 32);
+		}
+
+		bool pop_front(std::size_t w, std::size_t& task) noexcept {
+			std::uint64_t cur = ranges[w].bounds.load(std::memory_order_relaxed);
+			for (;;) {
+				std::uint64_t begin = cur & 0xFFFFFFFFu, end = cur >> 32;
+				if (begin >= end) {
+					return false;
+				}
+				if (ranges[w].bounds.compare_exchange_weak(cur, pack(begin + 1, end), std::memory_order_acquire, std::memory_order_relaxed)) {
+					task = static_cast<std::size_t>(begin);
+					return true;
+				}
+			}
+		}
+		bool pop_back(std::size_t w, std::size_t& task) noexcept {
+			std::uint64_t cur = ranges[w].bounds.load(std::memory_order_relaxed);
+			for (;;) {
+				std::uint64_t begin = cur & 0xFFFFFFFFu, end = cur >> 32;
+				if (begin >= end) {
+					return false;
+				}
+				if (ranges[w].bounds.compare_exchange_weak(cur, pack(begin, end - 1), std::memory_order_acquire, std::memory_order_relaxed)) {
+					task = static_cast<std::size_t>(end - 1);
+					return true;
+				}
+			}
+		}
+
+		void finish(std::size_t finished) {
+			if (remaining.fetch_sub(finished, std::memory_order_acq_rel) == finished) {
+				std::lock_guard<std::mutex> guard{ lock };
+				done.notify_all();
+			}
+		}
+
+		void run(const Job& job, std::size_t w) {
+			std::size_t task, finished = 0;
+			while (pop_front(w, task)) {
+				job.invoke(job.context, task);
+				++finished;
+			}
+
+			// Steal from the other workers, starting with the next one so the thieves spread out.
+			std::size_t count = ranges.size();
+			for (std::size_t i = 1; i < count; ++i) {
+				std::size_t victim = (w + i) % count;
+				while (pop_back(victim, task)) {
+					job.invoke(job.context, task);
+					++finished;
+				}
+			}
+
+			if (finished != 0) {
+				finish(finished);
+			}
+		}
+
+		void work(std::size_t w) {
+			std::uint64_t seen = 0;
+			for (;;) {
+				const Job* job;
+				{
+					std::unique_lock<std::mutex> guard{ lock };
+					wake.wait(guard, [&]() {
+						return stop || generation != seen;
+					});
+					if (stop) {
+						return;
+					}
+					seen = generation;
+					// The job may already be over, its tasks were all taken by the other workers.
+					job = current;
+					if (job == nullptr) {
+						continue;
+					}
+					++active;
+				}
+
+				run(*job, w);
+
+				std::lock_guard<std::mutex> guard{ lock };
+				--active;
+				if (active == 0) {
+					done.notify_all();
+				}
+			}
+		}
+
+		std::vector<Range> ranges;
+		std::vector<std::thread> workers;
+
+		std::mutex submitLock;
+		std::mutex lock;
+		std::condition_variable wake, done;
+		const Job* current = nullptr;
+		std::uint64_t generation = 0;
+		std::size_t active = 0;
+		bool stop = false;
+		std::atomic<std::size_t> remaining{ 0 };
+	};
+
+	// Process wide pool shared by the batch functions that are not given an executor.
+	inline ThreadPool& default_pool() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+	// Split count items into chunks of at most chunk items, and run func(begin, end) for each chunk on the executor.
+	template<typename Exec, typename F>
+	void parallel_for(Exec&& exec, std::size_t count, std::size_t chunk, F&& func) {
+		chunk = std::max<std::size_t>(chunk, 1);
+		std::size_t chunks = (count + chunk - 1) / chunk;
+		exec(chunks, [&](std::size_t c) {
+			std::size_t begin = c * chunk;
+			func(begin, std::min(count, begin + chunk));
+		});
+	}
+};
@@ -354,13 +354,13 @@ namespace ez {
 			Transform to;
 			to.origin = toLocal(form.origin);
 			to.rotation = toLocal(form.rotation);
-			to.size = to.size / size;
+			to.size = form.size / size;
 			return to;
 		}
 		// Note that this does not skew.
 		Transform toWorld(const Transform& form) const noexcept {
 			Transform to;
-			to.size = to.size * size;
+			to.size = form.size * size;
 			to.origin = toWorld(form.origin);
 			to.rotation = toWorld(form.rotation);
 			return to;
@@ -0,0 +1,196 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+#include <glm/common.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "MMRect.hpp"
+#include "SoA.hpp"
+#include "Transform.hpp"
+
+/*
+World bounds of local space rects, with Arvo's method: the center of the rect goes through the transform and the half extent
+through the absolute value of its linear part, world half[r] = sum over c of |M[r][c]| * half[c].
+That is exact for the bounds of the transformed rect and costs a single matrix product instead of transforming the 2^N corners.
+
+The batch forms take their rects as MMRectSoA3, see SoA.hpp. A shared transform or matrix is reduced to a 3x3 map and a translation
+once for the whole batch, a TransformSoA builds the rotation of each element from its quaternion and scales the local rect instead.
+The output may alias the input rects.
+*/
+
+namespace ez {
+	namespace intern {
+		// Rotation matrix of the quaternion (x, y, z, w), m[row][col].
+		template<typename T>
+		void quat_matrix(T x, T y, T z, T w, T m[3][3]) noexcept {
+			T xx = x * x, yy = y * y, zz = z * z;
+			T xy = x * y, xz = x * z, yz = y * z;
+			T wx = w * x, wy = w * y, wz = w * z;
+			m[0][0] = T(1) - T(2) * (yy + zz);
+			m[0][1] = T(2) * (xy - wz);
+			m[0][2] = T(2) * (xz + wy);
+			m[1][0] = T(2) * (xy + wz);
+			m[1][1] = T(1) - T(2) * (xx + zz);
+			m[1][2] = T(2) * (yz - wx);
+			m[2][0] = T(2) * (xz - wy);
+			m[2][1] = T(2) * (yz + wx);
+			m[2][2] = T(1) - T(2) * (xx + yy);
+		}
+
+		// Rect after the linear map m (glm column major, m[col][row]) and the translation t.
+		template<typename T, int N, typename M>
+		MMRect<T, N> affine_bounds(const MMRect<T, N>& local, const M& m, const glm::vec<N, T>& t) noexcept {
+			glm::vec<N, T> center = (local.min + local.max) * T(0.5);
+			glm::vec<N, T> half = glm::abs(local.max - local.min) * T(0.5);
+			glm::vec<N, T> c = t, e{ T(0) };
+			for (int col = 0; col < N; ++col) {
+				for (int row = 0; row < N; ++row) {
+					c[row] += m[col][row] * center[col];
+					e[row] += std::abs(m[col][row]) * half[col];
+				}
+			}
+			return MMRect<T, N>{ c - e, c + e };
+		}
+
+		// Batch of the above with a single map, m[row][col].
+		template<typename T>
+		void affine_bounds_batch(const MMRectSoA3<T>& locals, const T m[3][3], const T t[3], MMRectSoA3<T>& out) {
+			std::size_t count = locals.size();
+			out.resize(count);
+
+			const T* lx = locals.min.data(0), * ly = locals.min.data(1), * lz = locals.min.data(2);
+			const T* hx = locals.max.data(0), * hy = locals.max.data(1), * hz = locals.max.data(2);
+			T* ox = out.min.data(0), * oy = out.min.data(1), * oz = out.min.data(2);
+			T* px = out.max.data(0), * py = out.max.data(1), * pz = out.max.data(2);
+
+			const T a[3][3] = {
+				{ std::abs(m[0][0]), std::abs(m[0][1]), std::abs(m[0][2]) },
+				{ std::abs(m[1][0]), std::abs(m[1][1]), std::abs(m[1][2]) },
+				{ std::abs(m[2][0]), std::abs(m[2][1]), std::abs(m[2][2]) },
+			};
+
+			for (std::size_t j = 0; j < count; ++j) {
+				T cx = (lx[j] + hx[j]) * T(0.5), cy = (ly[j] + hy[j]) * T(0.5), cz = (lz[j] + hz[j]) * T(0.5);
+				T ex = std::abs(hx[j] - lx[j]) * T(0.5), ey = std::abs(hy[j] - ly[j]) * T(0.5), ez = std::abs(hz[j] - lz[j]) * T(0.5);
+
+				T wx = t[0] + m[0][0] * cx + m[0][1] * cy + m[0][2] * cz;
+				T wy = t[1] + m[1][0] * cx + m[1][1] * cy + m[1][2] * cz;
+				T wz = t[2] + m[2][0] * cx + m[2][1] * cy + m[2][2] * cz;
+				T fx = a[0][0] * ex + a[0][1] * ey + a[0][2] * ez;
+				T fy = a[1][0] * ex + a[1][1] * ey + a[1][2] * ez;
+				T fz = a[2][0] * ex + a[2][1] * ey + a[2][2] * ez;
+
+				ox[j] = wx - fx;
+				oy[j] = wy - fy;
+				oz[j] = wz - fz;
+				px[j] = wx + fx;
+				py[j] = wy + fy;
+				pz[j] = wz + fz;
+			}
+		}
+	}
+
+	// World bounds of a rect in the local space of the transform, same as bounding form.toWorld of its corners.
+	template<typename T, int N>
+	MMRect<T, N> world_bounds(const MMRect<T, N>& local, const Transform<T, N>& form) noexcept {
+		typename Transform<T, N>::basis_t basis;
+		if constexpr (N == 3) {
+			basis = glm::mat3_cast(form.rotation);
+		}
+		else {
+			basis = form.getBasis();
+		}
+		for (int k = 0; k < N; ++k) {
+			basis[k] *= form.size[k];
+		}
+		return intern::affine_bounds(local, basis, form.origin);
+	}
+
+	// World bounds of a rect through an affine matrix, the projective row of a square matrix is ignored.
+	template<typename T, int N>
+	MMRect<T, N> world_bounds(const MMRect<T, N>& local, const glm::mat<N + 1, N + 1, T>& matrix) noexcept {
+		glm::vec<N, T> t;
+		for (int k = 0; k < N; ++k) {
+			t[k] = matrix[N][k];
+		}
+		return intern::affine_bounds(local, matrix, t);
+	}
+	template<typename T, int N>
+	MMRect<T, N> world_bounds(const MMRect<T, N>& local, const glm::mat<N + 1, N, T>& matrix) noexcept {
+		return intern::affine_bounds(local, matrix, matrix[N]);
+	}
+	// Through a linear map only.
+	template<typename T, int N>
+	MMRect<T, N> world_bounds(const MMRect<T, N>& local, const glm::mat<N, N, T>& matrix) noexcept {
+		return intern::affine_bounds(local, matrix, glm::vec<N, T>{ T(0) });
+	}
+
+	// Batch form of world_bounds(locals[j], forms[j]).
+	template<typename T>
+	void world_bounds_batch(const MMRectSoA3<T>& locals, const TransformSoA<T>& forms, MMRectSoA3<T>& out) {
+		std::size_t count = std::min(locals.size(), forms.size());
+		out.resize(count);
+
+		const T* lx = locals.min.data(0), * ly = locals.min.data(1), * lz = locals.min.data(2);
+		const T* hx = locals.max.data(0), * hy = locals.max.data(1), * hz = locals.max.data(2);
+		const T* tx = forms.origin.data(0), * ty = forms.origin.data(1), * tz = forms.origin.data(2);
+		const T* sx = forms.scale.data(0), * sy = forms.scale.data(1), * sz = forms.scale.data(2);
+		const T* qx = forms.rotation.data(0), * qy = forms.rotation.data(1), * qz = forms.rotation.data(2), * qw = forms.rotation.data(3);
+		T* ox = out.min.data(0), * oy = out.min.data(1), * oz = out.min.data(2);
+		T* px = out.max.data(0), * py = out.max.data(1), * pz = out.max.data(2);
+
+		for (std::size_t j = 0; j < count; ++j) {
+			T m[3][3];
+			intern::quat_matrix(qx[j], qy[j], qz[j], qw[j], m);
+
+			// The scale is applied to the local rect instead of the matrix.
+			T cx = (lx[j] + hx[j]) * T(0.5) * sx[j], cy = (ly[j] + hy[j]) * T(0.5) * sy[j], cz = (lz[j] + hz[j]) * T(0.5) * sz[j];
+			T ex = std::abs((hx[j] - lx[j]) * T(0.5) * sx[j]), ey = std::abs((hy[j] - ly[j]) * T(0.5) * sy[j]), ez = std::abs((hz[j] - lz[j]) * T(0.5) * sz[j]);
+
+			T wx = tx[j] + m[0][0] * cx + m[0][1] * cy + m[0][2] * cz;
+			T wy = ty[j] + m[1][0] * cx + m[1][1] * cy + m[1][2] * cz;
+			T wz = tz[j] + m[2][0] * cx + m[2][1] * cy + m[2][2] * cz;
+			T fx = std::abs(m[0][0]) * ex + std::abs(m[0][1]) * ey + std::abs(m[0][2]) * ez;
+			T fy = std::abs(m[1][0]) * ex + std::abs(m[1][1]) * ey + std::abs(m[1][2]) * ez;
+			T fz = std::abs(m[2][0]) * ex + std::abs(m[2][1]) * ey + std::abs(m[2][2]) * ez;
+
+			ox[j] = wx - fx;
+			oy[j] = wy - fy;
+			oz[j] = wz - fz;
+			px[j] = wx + fx;
+			py[j] = wy + fy;
+			pz[j] = wz + fz;
+		}
+	}
+
+	// Batch form of world_bounds(locals[j], form), with a single transform for every rect.
+	template<typename T>
+	void world_bounds_batch(const MMRectSoA3<T>& locals, const Transform<T, 3>& form, MMRectSoA3<T>& out) {
+		T m[3][3];
+		intern::quat_matrix(form.rotation.x, form.rotation.y, form.rotation.z, form.rotation.w, m);
+		for (int row = 0; row < 3; ++row) {
+			for (int col = 0; col < 3; ++col) {
+				m[row][col] *= form.size[col];
+			}
+		}
+		const T t[3] = { form.origin.x, form.origin.y, form.origin.z };
+		intern::affine_bounds_batch(locals, m, t, out);
+	}
+
+	// Batch form of world_bounds(locals[j], matrix).
+	template<typename T>
+	void world_bounds_batch(const MMRectSoA3<T>& locals, const glm::tmat4x4<T>& matrix, MMRectSoA3<T>& out) {
+		T m[3][3];
+		for (int row = 0; row < 3; ++row) {
+			for (int col = 0; col < 3; ++col) {
+				m[row][col] = matrix[col][row];
+			}
+		}
+		const T t[3] = { matrix[3][0], matrix[3][1], matrix[3][2] };
+		intern::affine_bounds_batch(locals, m, t, out);
+	}
+};
@@ -0,0 +1,237 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "MMRect.hpp"
+#include "Transform.hpp"
+#include "SoA.hpp"
+
+/*
+Compact lossy encoding for 3d transforms, 12 bytes instead of the 40 of a Transform3<float>.
+The origin is quantized to 16 bits per axis relative to a fixed domain, origins outside of the domain are clamped to it.
+The rotation uses the smallest three packing: the largest quaternion component is dropped and rebuilt from the unit length,
+its index takes 2 bits and the other three are stored with 10 bits each.
+The scale is assumed to be uniform, only size.x is stored, quantized to 16 bits over a fixed range.
+
+Error bounds, before floating point rounding:
+	origin, half of (domain.max - domain.min) / 65535 on each axis
+	rotation, each stored component is within sqrt(2) / 2046 of the original, which bounds the rotation angle error by 14 times that, about 0.55 degrees.
+	The measured worst case is under half of the bound.
+	scale, half of (maxScale - minScale) / 65535
+*/
+
+namespace ez {
+	struct PackedTransform {
+		std::uint16_t origin[3];
+		std::uint16_t scale;
+		std::uint32_t rotation;
+	};
+	static_assert(sizeof(PackedTransform) == 12, "ez::PackedTransform is expected to be tightly packed!");
+
+	namespace intern {
+		static constexpr std::uint32_t QuatBits = 10;
+		static constexpr std::uint32_t QuatMax = (1u << QuatBits) - 1;
+
+		template<typename T>
+		constexpr T sqrt2() noexcept {
+			return T(1.41421356237309504880);
+		}
+
+		template<typename T>
+		std::uint16_t quantize16(T value, T offset, T scale) noexcept {
+			T q = (value - offset) * scale;
+			q = std::min(std::max(q, T(0)), T(65535));
+			return static_cast<std::uint16_t>(q + T(0.5));
+		}
+
+		// Quaternion components in x, y, z, w order.
+		template<typename T>
+		std::uint32_t pack_rotation(T x, T y, T z, T w) noexcept {
+			T c[4] = { x, y, z, w };
+
+			std::uint32_t largest = 0;
+			for (std::uint32_t i = 1; i < 4; ++i) {
+				if (std::abs(c[i]) > std::abs(c[largest])) {
+					largest = i;
+				}
+			}
+
+			// q and -q are the same rotation, flip so the dropped component is positive.
+			T sign = c[largest] < T(0) ? T(-1) : T(1);
+
+			std::uint32_t bits = largest;
+			std::uint32_t shift = 2;
+			for (std::uint32_t i = 0; i < 4; ++i) {
+				if (i == largest) {
+					continue;
+				}
+				// The smaller components lie in [-1 / sqrt(2), 1 / sqrt(2)]
+				T v = (c[i] * sign * sqrt2<T>() + T(1)) * T(0.5);
+				T q = std::min(std::max(v * T(QuatMax), T(0)), T(QuatMax));
+				bits |= static_cast<std::uint32_t>(q + T(0.5)) << shift;
+				shift += QuatBits;
+			}
+			return bits;
+		}
+
+		template<typename T>
+		void unpack_rotation(std::uint32_t bits, T* c) noexcept {
+			std::uint32_t largest = bits & 3u;
+			std::uint32_t shift = 2;
+			T sum = T(0);
+			for (std::uint32_t i = 0; i < 4; ++i) {
+				if (i == largest) {
+					continue;
+				}
+				T v = T((bits >> shift) & QuatMax) / T(QuatMax);
+				c[i] = (v * T(2) - T(1)) / sqrt2<T>();
+				sum += c[i] * c[i];
+				shift += QuatBits;
+			}
+			c[largest] = std::sqrt(std::max(T(1) - sum, T(0)));
+
+			// Renormalize, the quantized components can push the length away from one.
+			T inv = T(1) / std::sqrt(sum + c[largest] * c[largest]);
+			for (int i = 0; i < 4; ++i) {
+				c[i] *= inv;
+			}
+		}
+	}
+
+	template<typename T>
+	class TransformCodec {
+	public:
+		using vec3_t = glm::tvec3<T>;
+		using rect_t = MMRect<T, 3>;
+		using transform_t = Transform<T, 3>;
+
+		// The domain bounds every origin, the scale range bounds the uniform scale. An empty scale range stores no scale.
+		TransformCodec(const rect_t& _domain, T _minScale = T(1), T _maxScale = T(1)) noexcept
+			: domain(_domain)
+			, minScale(_minScale)
+			, maxScale(std::max(_minScale, _maxScale))
+		{
+			vec3_t extent = domain.max - domain.min;
+			for (int i = 0; i < 3; ++i) {
+				step[i] = extent[i] / T(65535);
+				invStep[i] = extent[i] > T(0) ? T(65535) / extent[i] : T(0);
+			}
+			scaleStep = (maxScale - minScale) / T(65535);
+			invScaleStep = maxScale > minScale ? T(65535) / (maxScale - minScale) : T(0);
+		}
+
+		PackedTransform encode(const transform_t& form) const noexcept {
+			PackedTransform ret;
+			for (int i = 0; i < 3; ++i) {
+				ret.origin[i] = intern::quantize16(form.origin[i], domain.min[i], invStep[i]);
+			}
+			ret.scale = intern::quantize16(form.size.x, minScale, invScaleStep);
+			ret.rotation = intern::pack_rotation(form.rotation.x, form.rotation.y, form.rotation.z, form.rotation.w);
+			return ret;
+		}
+
+		transform_t decode(const PackedTransform& packed) const noexcept {
+			transform_t ret;
+			for (int i = 0; i < 3; ++i) {
+				ret.origin[i] = domain.min[i] + T(packed.origin[i]) * step[i];
+			}
+			ret.size = vec3_t{ minScale + T(packed.scale) * scaleStep };
+
+			T c[4];
+			intern::unpack_rotation(packed.rotation, c);
+			ret.rotation = glm::tquat<T>{ c[3], c[0], c[1], c[2] };
+			return ret;
+		}
+
+		// Encode every transform in the array, out is resized to match.
+		void encode(const TransformSoA<T>& forms, std::vector<PackedTransform>& out) const {
+			std::size_t count = forms.size();
+			out.resize(count);
+			PackedTransform* po = out.data();
+
+			// The quantization of each axis is an independent loop over one array, so it vectorizes.
+			for (int i = 0; i < 3; ++i) {
+				const T* src = forms.origin.data(i);
+				const T offset = domain.min[i], scale = invStep[i];
+				for (std::size_t j = 0; j < count; ++j) {
+					po[j].origin[i] = intern::quantize16(src[j], offset, scale);
+				}
+			}
+
+			const T* sx = forms.scale.data(0);
+			for (std::size_t j = 0; j < count; ++j) {
+				po[j].scale = intern::quantize16(sx[j], minScale, invScaleStep);
+			}
+
+			const T* qx = forms.rotation.data(0), * qy = forms.rotation.data(1), * qz = forms.rotation.data(2), * qw = forms.rotation.data(3);
+			for (std::size_t j = 0; j < count; ++j) {
+				po[j].rotation = intern::pack_rotation(qx[j], qy[j], qz[j], qw[j]);
+			}
+		}
+		void encode(const transform_t* forms, std::size_t count, std::vector<PackedTransform>& out) const {
+			out.resize(count);
+			for (std::size_t j = 0; j < count; ++j) {
+				out[j] = encode(forms[j]);
+			}
+		}
+
+		// Decode count transforms into the array, which is resized to match.
+		void decode(const PackedTransform* packed, std::size_t count, TransformSoA<T>& out) const {
+			out.resize(count);
+
+			for (int i = 0; i < 3; ++i) {
+				T* dst = out.origin.data(i);
+				const T offset = domain.min[i], scale = step[i];
+				for (std::size_t j = 0; j < count; ++j) {
+					dst[j] = offset + T(packed[j].origin[i]) * scale;
+				}
+			}
+
+			T* sx = out.scale.data(0), * sy = out.scale.data(1), * sz = out.scale.data(2);
+			for (std::size_t j = 0; j < count; ++j) {
+				T s = minScale + T(packed[j].scale) * scaleStep;
+				sx[j] = s;
+				sy[j] = s;
+				sz[j] = s;
+			}
+
+			T* qx = out.rotation.data(0), * qy = out.rotation.data(1), * qz = out.rotation.data(2), * qw = out.rotation.data(3);
+			for (std::size_t j = 0; j < count; ++j) {
+				T c[4];
+				intern::unpack_rotation(packed[j].rotation, c);
+				qx[j] = c[0];
+				qy[j] = c[1];
+				qz[j] = c[2];
+				qw[j] = c[3];
+			}
+		}
+		void decode(const std::vector<PackedTransform>& packed, TransformSoA<T>& out) const {
+			decode(packed.data(), packed.size(), out);
+		}
+
+		// The largest difference between an origin inside the domain and its decoded value, per axis.
+		vec3_t originError() const noexcept {
+			return step * T(0.5);
+		}
+		// The largest difference between a scale inside the range and its decoded value.
+		T scaleError() const noexcept {
+			return scaleStep * T(0.5);
+		}
+		// The largest angle in radians between a rotation and its decoded value.
+		static constexpr T rotationError() noexcept {
+			return T(14) * intern::sqrt2<T>() / T(2 * intern::QuatMax);
+		}
+
+		const rect_t& getDomain() const noexcept {
+			return domain;
+		}
+	private:
+		rect_t domain;
+		T minScale, maxScale;
+		vec3_t step, invStep;
+		T scaleStep, invScaleStep;
+	};
+};
@@ -0,0 +1,303 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include <glm/vec3.hpp>
+
+#include "MMRect.hpp"
+#include "SoA.hpp"
+#include "ThreadPool.hpp"
+#include "BatchQuery.hpp"
+
+/*
+Voxel grid downsampling of point clouds, every occupied voxel is reduced to the centroid and the count of its points.
+
+The voxels tile a fixed domain, a point is placed by quantizing its offset from the min corner of the domain, and points
+outside the domain are skipped. Voxels are identified by the 63 bit Morton key of their coordinates (intern::morton3),
+so there may be at most 2^21 voxels along each axis, larger grids are clamped to that, which stretches the voxels.
+
+The input is streamed in chunks of bounded size. Each chunk is keyed and sorted by key with a parallel LSD radix sort that
+only runs the passes the grid needs, its runs of equal keys are reduced, then merged into the running cells, which are
+kept sorted by key. The memory used is a chunk plus one cell per occupied voxel, whatever the size of the input.
+Sums are accumulated in double, so the centroids of large voxels stay accurate with float input.
+*/
+
+namespace ez {
+	namespace intern {
+		// Elements per task of the radix sort, one histogram per task.
+		static constexpr std::size_t RadixBlock = std::size_t(1) << 16;
+
+		struct KeyIndex {
+			std::uint64_t key;
+			std::uint32_t index;
+		};
+
+		// Stable LSD radix sort of the low bits of the keys, 8 bits per pass. Scratch is resized to the size of items,
+		// histograms to the number of blocks times 256.
+		template<typename Exec>
+		void radix_sort(std::vector<KeyIndex>& items, std::vector<KeyIndex>& scratch, std::vector<std::size_t>& histograms, int bits, Exec&& exec) {
+			std::size_t count = items.size();
+			std::size_t blocks = (count + RadixBlock - 1) / RadixBlock;
+			scratch.resize(count);
+			histograms.resize(blocks * 256);
+
+			for (int shift = 0; shift < bits; shift += 8) {
+				exec(blocks, [&](std::size_t b) {
+					std::size_t* hist = histograms.data() + b * 256;
+					std::fill(hist, hist + 256, std::size_t(0));
+					std::size_t begin = b * RadixBlock, end = std::min(count, begin + RadixBlock);
+					for (std::size_t i = begin; i < end; ++i) {
+						++hist[(items[i].key >> shift) & 0xFF];
+					}
+				});
+
+				// Exclusive prefix over digits first then blocks, so each block scatters after the blocks before it.
+				std::size_t sum = 0;
+				bool single = false;
+				for (std::size_t d = 0; d < 256; ++d) {
+					std::size_t digit = 0;
+					for (std::size_t b = 0; b < blocks; ++b) {
+						std::size_t n = histograms[b * 256 + d];
+						histograms[b * 256 + d] = sum;
+						sum += n;
+						digit += n;
+					}
+					single |= digit == count;
+				}
+				// Every key has the same digit, the pass would not move anything.
+				if (single) {
+					continue;
+				}
+
+				exec(blocks, [&](std::size_t b) {
+					std::size_t* cursor = histograms.data() + b * 256;
+					std::size_t begin = b * RadixBlock, end = std::min(count, begin + RadixBlock);
+					for (std::size_t i = begin; i < end; ++i) {
+						scratch[cursor[(items[i].key >> shift) & 0xFF]++] = items[i];
+					}
+				});
+				items.swap(scratch);
+			}
+		}
+	}
+
+	template<typename T>
+	class VoxelDownsampler {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::VoxelDownsampler requires a floating point value type!");
+		using vec3_t = glm::tvec3<T>;
+		using rect_t = MMRect<T, 3>;
+
+		// Voxels with an edge of voxel units tile the domain. Chunk is the number of points sorted at once.
+		VoxelDownsampler(const rect_t& _domain, T voxel, std::size_t _chunk = std::size_t(1) << 20)
+			: domain(_domain)
+			, chunk(std::max<std::size_t>(_chunk, 1))
+		{
+			int bits = 0;
+			for (int k = 0; k < 3; ++k) {
+				T extent = domain.max[k] - domain.min[k];
+				T cells = std::ceil(extent / voxel);
+				dims[k] = static_cast<std::uint32_t>(std::min(std::max(cells, T(1)), T(MaxDims)));
+				scale[k] = extent > T(0) ? T(dims[k]) / extent : T(0);
+
+				int axisBits = 0;
+				while ((std::uint64_t(1) << axisBits) < dims[k]) {
+					++axisBits;
+				}
+				bits = std::max(bits, axisBits);
+			}
+			keyBits = 3 * bits;
+			reset();
+		}
+
+		// Drop every point added so far.
+		void reset() {
+			cells.clear();
+			accepted = 0;
+			outside = 0;
+		}
+
+		// Number of voxels along each axis.
+		glm::tvec3<std::uint32_t> resolution() const noexcept {
+			return glm::tvec3<std::uint32_t>{ dims[0], dims[1], dims[2] };
+		}
+		// Number of occupied voxels.
+		std::size_t cellCount() const noexcept {
+			return cells.size();
+		}
+		// Number of points added inside and outside of the domain.
+		std::size_t pointCount() const noexcept {
+			return accepted;
+		}
+		std::size_t skipped() const noexcept {
+			return outside;
+		}
+
+		template<typename Exec>
+		void add(const PointSoA<T, 3>& points, Exec&& exec) {
+			const T* axes[3] = { points.data(0), points.data(1), points.data(2) };
+			std::size_t count = points.size();
+			for (std::size_t begin = 0; begin < count; begin += chunk) {
+				std::size_t n = std::min(chunk, count - begin);
+				process(n, exec, [&](std::size_t i) {
+					return vec3_t{ axes[0][begin + i], axes[1][begin + i], axes[2][begin + i] };
+				});
+			}
+		}
+		template<typename Exec>
+		void add(const vec3_t* points, std::size_t count, Exec&& exec) {
+			for (std::size_t begin = 0; begin < count; begin += chunk) {
+				std::size_t n = std::min(chunk, count - begin);
+				process(n, exec, [&](std::size_t i) {
+					return points[begin + i];
+				});
+			}
+		}
+		void add(const PointSoA<T, 3>& points) {
+			add(points, SerialExecutor{});
+		}
+		void add(const vec3_t* points, std::size_t count) {
+			add(points, count, SerialExecutor{});
+		}
+
+		// The centroid of every occupied voxel, ordered by key. Counts and keys receive the matching number of points and Morton keys.
+		void result(PointSoA<T, 3>& centroids, std::vector<std::uint32_t>* counts = nullptr, std::vector<std::uint64_t>* keys = nullptr) const {
+			std::size_t size = cells.size();
+			centroids.resize(size);
+			if (counts) {
+				counts->resize(size);
+			}
+			if (keys) {
+				keys->resize(size);
+			}
+			for (std::size_t i = 0; i < size; ++i) {
+				const Cell& cell = cells[i];
+				double inv = 1.0 / double(cell.count);
+				for (int k = 0; k < 3; ++k) {
+					centroids.data(k)[i] = static_cast<T>(cell.sum[k] * inv);
+				}
+				if (counts) {
+					(*counts)[i] = cell.count;
+				}
+				if (keys) {
+					(*keys)[i] = cell.key;
+				}
+			}
+		}
+
+		// Bounds of the voxel with the given coordinates.
+		rect_t voxelBounds(const glm::tvec3<std::uint32_t>& voxel) const noexcept {
+			rect_t ret;
+			for (int k = 0; k < 3; ++k) {
+				T size = scale[k] > T(0) ? T(1) / scale[k] : T(0);
+				ret.min[k] = domain.min[k] + T(voxel[k]) * size;
+				ret.max[k] = domain.min[k] + T(voxel[k] + 1) * size;
+			}
+			return ret;
+		}
+	private:
+		static constexpr std::uint32_t MaxDims = std::uint32_t(1) << 21;
+		static constexpr std::uint64_t Outside = std::numeric_limits<std::uint64_t>::max();
+
+		struct Cell {
+			std::uint64_t key;
+			double sum[3];
+			std::uint32_t count;
+		};
+
+		template<typename Exec, typename F>
+		void process(std::size_t count, Exec& exec, F&& point) {
+			items.resize(count);
+			parallel_for(exec, count, intern::RadixBlock, [&](std::size_t begin, std::size_t end) {
+				for (std::size_t i = begin; i < end; ++i) {
+					vec3_t p = point(i);
+					bool inside = true;
+					std::uint32_t q[3];
+					for (int k = 0; k < 3; ++k) {
+						inside &= (p[k] >= domain.min[k]) & (p[k] <= domain.max[k]);
+						q[k] = intern::quantize(p[k], domain.min[k], scale[k], dims[k] - 1);
+					}
+					items[i] = intern::KeyIndex{ inside ? intern::morton3(q[0], q[1], q[2]) : Outside, static_cast<std::uint32_t>(i) };
+				}
+			});
+
+			// Points outside of the domain are skipped before sorting.
+			std::size_t kept = 0;
+			for (std::size_t i = 0; i < count; ++i) {
+				items[kept] = items[i];
+				kept += items[i].key != Outside;
+			}
+			items.resize(kept);
+			accepted += kept;
+			outside += count - kept;
+			intern::radix_sort(items, scratch, histograms, keyBits, exec);
+
+			// Reduce the runs of equal keys, then merge them with the cells so far.
+			fresh.clear();
+			for (std::size_t i = 0; i < kept; ++i) {
+				vec3_t p = point(items[i].index);
+				if (fresh.empty() || fresh.back().key != items[i].key) {
+					fresh.push_back(Cell{ items[i].key, { 0.0, 0.0, 0.0 }, 0 });
+				}
+				Cell& cell = fresh.back();
+				for (int k = 0; k < 3; ++k) {
+					cell.sum[k] += double(p[k]);
+				}
+				++cell.count;
+			}
+
+			merged.clear();
+			merged.reserve(cells.size() + fresh.size());
+			std::size_t a = 0, b = 0;
+			while (a < cells.size() || b < fresh.size()) {
+				if (b == fresh.size() || (a < cells.size() && cells[a].key < fresh[b].key)) {
+					merged.push_back(cells[a++]);
+				}
+				else if (a == cells.size() || fresh[b].key < cells[a].key) {
+					merged.push_back(fresh[b++]);
+				}
+				else {
+					Cell cell = cells[a++];
+					for (int k = 0; k < 3; ++k) {
+						cell.sum[k] += fresh[b].sum[k];
+					}
+					cell.count += fresh[b++].count;
+					merged.push_back(cell);
+				}
+			}
+			cells.swap(merged);
+		}
+
+		rect_t domain;
+		std::size_t chunk;
+		std::uint32_t dims[3];
+		T scale[3];
+		int keyBits;
+
+		std::vector<Cell> cells;
+		std::size_t accepted, outside;
+
+		// Per chunk scratch, kept to reuse the memory.
+		std::vector<intern::KeyIndex> items, scratch;
+		std::vector<std::size_t> histograms;
+		std::vector<Cell> fresh, merged;
+	};
+
+	// Downsample a point cloud in one call, see VoxelDownsampler. Returns the number of occupied voxels.
+	template<typename T, typename Exec>
+	std::size_t voxel_downsample(const PointSoA<T, 3>& points, const MMRect<T, 3>& domain, T voxel, PointSoA<T, 3>& centroids, std::vector<std::uint32_t>* counts, Exec&& exec) {
+		VoxelDownsampler<T> sampler{ domain, voxel };
+		sampler.add(points, exec);
+		sampler.result(centroids, counts);
+		return sampler.cellCount();
+	}
+	template<typename T>
+	std::size_t voxel_downsample(const PointSoA<T, 3>& points, const MMRect<T, 3>& domain, T voxel, PointSoA<T, 3>& centroids, std::vector<std::uint32_t>* counts = nullptr) {
+		return voxel_downsample(points, domain, voxel, centroids, counts, SerialExecutor{});
+	}
+};
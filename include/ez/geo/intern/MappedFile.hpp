@@ -0,0 +1,170 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace ez::intern {
+	// Read only mapping of a whole file, with paging hints.
+	class MappedFile {
+	public:
+		MappedFile() noexcept = default;
+		~MappedFile() {
+			close();
+		}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept {
+			swap(other);
+		}
+		MappedFile& operator=(MappedFile&& other) noexcept {
+			if (this != &other) {
+				close();
+				swap(other);
+			}
+			return *this;
+		}
+
+		// Map the file, returns false when it can't be opened or is empty.
+		// Random access is advised, so the kernel does not read ahead of the pages actually touched.
+		bool open(const std::string& path) {
+			close();
+#ifdef _WIN32
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+				close();
+				return false;
+			}
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping) {
+				close();
+				return false;
+			}
+			void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (!view) {
+				close();
+				return false;
+			}
+			bytes = static_cast<const unsigned char*>(view);
+			length = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+			fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				return false;
+			}
+			struct stat info;
+			if (fstat(fd, &info) != 0 || info.st_size == 0) {
+				close();
+				return false;
+			}
+			void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+			if (view == MAP_FAILED) {
+				close();
+				return false;
+			}
+			bytes = static_cast<const unsigned char*>(view);
+			length = static_cast<std::size_t>(info.st_size);
+			madvise(view, length, MADV_RANDOM);
+			page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+			return true;
+		}
+
+		void close() noexcept {
+#ifdef _WIN32
+			if (bytes) {
+				UnmapViewOfFile(bytes);
+			}
+			if (mapping) {
+				CloseHandle(mapping);
+			}
+			if (file != INVALID_HANDLE_VALUE) {
+				CloseHandle(file);
+			}
+			mapping = nullptr;
+			file = INVALID_HANDLE_VALUE;
+#else
+			if (bytes) {
+				munmap(const_cast<unsigned char*>(bytes), length);
+			}
+			if (fd >= 0) {
+				::close(fd);
+			}
+			fd = -1;
+#endif
+			bytes = nullptr;
+			length = 0;
+		}
+
+		bool isOpen() const noexcept {
+			return bytes != nullptr;
+		}
+		const unsigned char* data() const noexcept {
+			return bytes;
+		}
+		std::size_t size() const noexcept {
+			return length;
+		}
+
+		// Hint that the range will be read soon, so the kernel can start paging it in. Only a hint, it never fails.
+		void willNeed(std::size_t offset, std::size_t count) const noexcept {
+			if (!bytes || offset >= length) {
+				return;
+			}
+			count = count < length - offset ? count : length - offset;
+#ifdef _WIN32
+	#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+			WIN32_MEMORY_RANGE_ENTRY range;
+			range.VirtualAddress = const_cast<unsigned char*>(bytes + offset);
+			range.NumberOfBytes = count;
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	#endif
+#else
+			// The advised range must start on a page boundary.
+			std::size_t start = offset - offset % page;
+			madvise(const_cast<unsigned char*>(bytes + start), count + (offset - start), MADV_WILLNEED);
+#endif
+		}
+	private:
+		void swap(MappedFile& other) noexcept {
+			std::swap(bytes, other.bytes);
+			std::swap(length, other.length);
+#ifdef _WIN32
+			std::swap(file, other.file);
+			std::swap(mapping, other.mapping);
+#else
+			std::swap(fd, other.fd);
+			std::swap(page, other.page);
+#endif
+		}
+
+		const unsigned char* bytes = nullptr;
+		std::size_t length = 0;
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#else
+		int fd = -1;
+		std::size_t page = 4096;
+#endif
+	};
+};
@@ -3,13 +3,41 @@
 // This will check for superficial compile errors like syntax and such.
 
 #include <ez/geo/AABB.hpp>
+#include <ez/geo/BatchIntersect.hpp>
+#include <ez/geo/BatchPlane.hpp>
+#include <ez/geo/BatchQuery.hpp>
+#include <ez/geo/BatchTransform.hpp>
+#include <ez/geo/Bezier.hpp>
+#include <ez/geo/Bounds.hpp>
+#include <ez/geo/Capsule.hpp>
 #include <ez/geo/Circle.hpp>
+#include <ez/geo/Clip.hpp>
+#include <ez/geo/Delaunay.hpp>
+#include <ez/geo/GJK.hpp>
+#include <ez/geo/GridTraversal.hpp>
 #include <ez/geo/Intersect.hpp>
+#include <ez/geo/Join.hpp>
 #include <ez/geo/Line.hpp>
+#include <ez/geo/MappedRTree.hpp>
+#include <ez/geo/Memory.hpp>
+#include <ez/geo/Motion.hpp>
 #include <ez/geo/MMRect.hpp>
 #include <ez/geo/MPRect.hpp>
+#include <ez/geo/OBB.hpp>
+#include <ez/geo/Packer.hpp>
 #include <ez/geo/Plane.hpp>
+#include <ez/geo/Polygon.hpp>
+#include <ez/geo/Predicates.hpp>
+#include <ez/geo/RTree.hpp>
 #include <ez/geo/Ray.hpp>
 #include <ez/geo/Rect.hpp>
+#include <ez/geo/SoA.hpp>
 #include <ez/geo/Sphere.hpp>
-#include <ez/geo/Transform.hpp>
\ No newline at end of file
+#include <ez/geo/Stats.hpp>
+#include <ez/geo/Support.hpp>
+#include <ez/geo/Sweep.hpp>
+#include <ez/geo/ThreadPool.hpp>
+#include <ez/geo/Transform.hpp>
+#include <ez/geo/TransformBounds.hpp>
+#include <ez/geo/TransformCodec.hpp>
+#include <ez/geo/Voxel.hpp>
@@ -0,0 +1,145 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <ez/geo/Bezier.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("bezier evaluation") {
+	using namespace ez;
+
+	CubicBezier2<double> cubic{ glm::dvec2{ 0, 0 }, glm::dvec2{ 1, 2 }, glm::dvec2{ 3, 2 }, glm::dvec2{ 4, 0 } };
+	REQUIRE(approxEq(cubic.eval(0.0), cubic[0]));
+	REQUIRE(approxEq(cubic.eval(1.0), cubic[3]));
+	REQUIRE(approxEq(cubic.eval(0.5), glm::dvec2{ 2, 1.5 }));
+	REQUIRE(approxEq(cubic.derivative(0.0), (cubic[1] - cubic[0]) * 3.0));
+
+	// Both halves of a split meet at the evaluated point and follow the curve.
+	CubicBezier2<double> left, right;
+	cubic.split(0.3, left, right);
+	REQUIRE(approxEq(left[3], cubic.eval(0.3)));
+	REQUIRE(approxEq(right[0], cubic.eval(0.3)));
+	REQUIRE(approxEq(left.eval(0.5), cubic.eval(0.15)));
+	REQUIRE(approxEq(right.eval(0.5), cubic.eval(0.65)));
+
+	QuadraticBezier3<float> quad{ glm::vec3{ 0 }, glm::vec3{ 1, 2, 3 }, glm::vec3{ 2, 0, 0 } };
+	std::vector<float> ts;
+	for (int i = 0; i <= 100; ++i) {
+		ts.push_back(float(i) / 100.f);
+	}
+	PointSoA3<float> out;
+	eval_batch(quad, ts.data(), ts.size(), out);
+	bool match = out.size() == ts.size();
+	for (std::size_t i = 0; i < ts.size(); ++i) {
+		match &= approxEq(out.get(i), quad.eval(ts[i]));
+	}
+	REQUIRE(match);
+}
+
+TEST_CASE("bezier bounds") {
+	using namespace ez;
+
+	std::mt19937 gen{ 51 };
+	std::uniform_real_distribution<double> dist{ -10.0, 10.0 };
+
+	bool match = true;
+	for (int i = 0; i < 200; ++i) {
+		CubicBezier3<double> curve{
+			glm::dvec3{ dist(gen), dist(gen), dist(gen) }, glm::dvec3{ dist(gen), dist(gen), dist(gen) },
+			glm::dvec3{ dist(gen), dist(gen), dist(gen) }, glm::dvec3{ dist(gen), dist(gen), dist(gen) } };
+		MMRect3<double> box = curve.bounds();
+
+		MMRect3<double> sampled{ curve[0], curve[0] };
+		for (int s = 0; s <= 2000; ++s) {
+			glm::dvec3 p = curve.eval(double(s) / 2000.0);
+			sampled.min = glm::min(sampled.min, p);
+			sampled.max = glm::max(sampled.max, p);
+		}
+		// Tight, the sampled bounds are inside and close to the computed ones.
+		for (int k = 0; k < 3; ++k) {
+			match &= box.min[k] <= sampled.min[k] + 1e-9 && box.max[k] >= sampled.max[k] - 1e-9;
+			match &= sampled.min[k] - box.min[k] < 1e-3 && box.max[k] - sampled.max[k] < 1e-3;
+		}
+		match &= curve.hull().contains(box);
+	}
+	REQUIRE(match);
+
+	QuadraticBezier2<double> arch{ glm::dvec2{ 0, 0 }, glm::dvec2{ 1, 2 }, glm::dvec2{ 2, 0 } };
+	REQUIRE(approxEq(arch.bounds().max, glm::dvec2{ 2, 1 }));
+}
+
+TEST_CASE("bezier flattening") {
+	using namespace ez;
+
+	std::mt19937 gen{ 52 };
+	std::uniform_real_distribution<double> dist{ -50.0, 50.0 };
+
+	std::vector<CubicBezier2<double>> curves;
+	for (int i = 0; i < 100; ++i) {
+		curves.emplace_back(glm::dvec2{ dist(gen), dist(gen) }, glm::dvec2{ dist(gen), dist(gen) }, glm::dvec2{ dist(gen), dist(gen) }, glm::dvec2{ dist(gen), dist(gen) });
+	}
+
+	const double tolerance = 0.05;
+	std::vector<glm::dvec2> points, batch;
+	std::vector<std::size_t> offsets;
+	flatten_batch(curves.data(), curves.size(), tolerance, batch, offsets);
+
+	bool match = true;
+	for (std::size_t c = 0; c < curves.size(); ++c) {
+		const CubicBezier2<double>& curve = curves[c];
+		points.clear();
+		flatten(curve, tolerance, points);
+		std::size_t n = points.size() - 1;
+		match &= n == curve.segments(tolerance);
+		match &= offsets[c + 1] - offsets[c] == points.size();
+
+		// Within tolerance of the curve at the matching parameter inside every segment.
+		for (std::size_t i = 0; i < n; ++i) {
+			match &= approxEq(points[i], batch[offsets[c] + i]);
+			for (int s = 1; s < 8; ++s) {
+				double f = double(s) / 8.0;
+				glm::dvec2 chord = points[i] + (points[i + 1] - points[i]) * f;
+				match &= glm::length(curve.eval((double(i) + f) / double(n)) - chord) <= tolerance;
+			}
+		}
+
+		std::vector<Line2<double>> lines;
+		flatten(curve, tolerance, lines);
+		match &= lines.size() == n && approxEq(lines.front().start, curve[0]) && approxEq(lines.back().end, curve[3]);
+	}
+	REQUIRE(match);
+}
+
+TEST_CASE("bezier intersection") {
+	using namespace ez;
+
+	double ct[3], lt[3];
+	QuadraticBezier2<double> arch{ glm::dvec2{ 0, 0 }, glm::dvec2{ 1, 2 }, glm::dvec2{ 2, 0 } };
+	Ray2<double> ray{ glm::dvec2{ 1, 0 }, glm::dvec2{ -1, 0.5 } };
+	REQUIRE(intersect(ray, arch, ct, lt) == 2);
+	REQUIRE(lt[0] < lt[1]);
+	REQUIRE(approxEq(ct[0], (1.0 - std::sqrt(0.5)) / 2.0));
+	REQUIRE(approxEq(arch.eval(ct[1]), ray.eval(lt[1])));
+
+	// Above the arch nothing is hit, and a ray starting between the crossings only sees the second.
+	REQUIRE(intersect(Ray2<double>{ glm::dvec2{ 1, 0 }, glm::dvec2{ -1, 1.5 } }, arch, ct, lt) == 0);
+	REQUIRE(intersect(Ray2<double>{ glm::dvec2{ 1, 0 }, glm::dvec2{ 1, 0.5 } }, arch, ct, lt) == 1);
+
+	CubicBezier2<double> wave{ glm::dvec2{ 0, -1 }, glm::dvec2{ 1, 3 }, glm::dvec2{ 2, -3 }, glm::dvec2{ 3, 1 } };
+	Line2<double> axis{ glm::dvec2{ -1, 0 }, glm::dvec2{ 4, 0 } };
+	int count = intersect(axis, wave, ct, lt);
+	REQUIRE(count == 3);
+	bool match = true;
+	for (int i = 0; i < count; ++i) {
+		glm::dvec2 p = wave.eval(ct[i]);
+		match &= approxEq(p.y, 0.0) && approxEq(p, axis.start + (axis.end - axis.start) * lt[i]);
+	}
+	REQUIRE(match);
+
+	// A segment that stops before the last crossing.
+	Line2<double> shorter{ glm::dvec2{ -1, 0 }, glm::dvec2{ 2, 0 } };
+	REQUIRE(intersect(shorter, wave, ct, lt) == 2);
+}
@@ -0,0 +1,70 @@
+#include <random>
+
+#include <ez/geo/Bounds.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("circumcircle") {
+	using namespace ez;
+
+	Circle<double> circle = Circle<double>::fromOuterTriangle(glm::dvec2{ 0, 0 }, glm::dvec2{ 2, 0 }, glm::dvec2{ 0, 2 });
+	REQUIRE(approxEq(circle.origin, glm::dvec2{ 1, 1 }));
+	REQUIRE(approxEq(circle.radius, std::sqrt(2.0)));
+}
+
+TEST_CASE("bulk bounds") {
+	using namespace ez;
+
+	std::mt19937 gen{ 7 };
+	std::uniform_real_distribution<float> dist{ -100.f, 100.f };
+
+	std::vector<glm::vec3> points(200001);
+	for (glm::vec3& p : points) {
+		p = glm::vec3{ dist(gen), dist(gen), dist(gen) };
+	}
+
+	PointSoA3<float> soa;
+	MMRect3<float> expected{ points[0], points[0] };
+	for (const glm::vec3& p : points) {
+		expected.merge(p);
+		soa.push_back(p);
+	}
+
+	REQUIRE(bounds(points) == expected);
+	REQUIRE(bounds(soa) == expected);
+	REQUIRE(bounds_parallel(points, 4) == expected);
+	REQUIRE(bounds_parallel(soa, 4) == expected);
+
+	Sphere<float> ritter = ritter_sphere(points);
+	Sphere<float> epos = bounding_sphere(points);
+	bool enclosed = true;
+	for (const glm::vec3& p : points) {
+		enclosed &= glm::length(p - ritter.origin) <= ritter.radius * 1.0001f;
+		enclosed &= glm::length(p - epos.origin) <= epos.radius * 1.0001f;
+	}
+	REQUIRE(enclosed);
+}
+
+TEST_CASE("minimum enclosing circle") {
+	using namespace ez;
+
+	std::mt19937 gen{ 11 };
+	std::uniform_real_distribution<double> angle{ 0.0, ez::tau<double>() };
+	std::uniform_real_distribution<double> radius{ 0.0, 1.0 };
+
+	// Points inside the unit circle, with three of them on the boundary.
+	std::vector<glm::dvec2> points;
+	for (int i = 0; i < 1000; ++i) {
+		double a = angle(gen), r = radius(gen);
+		points.push_back(glm::dvec2{ std::cos(a), std::sin(a) } * r + glm::dvec2{ 5, -3 });
+	}
+	points.push_back(glm::dvec2{ 6, -3 });
+	points.push_back(glm::dvec2{ 4.5, -3 + std::sqrt(0.75) });
+	points.push_back(glm::dvec2{ 4.5, -3 - std::sqrt(0.75) });
+
+	Circle<double> circle = enclosing_circle(points);
+	REQUIRE(approxEq(circle.origin, glm::dvec2{ 5, -3 }));
+	REQUIRE(approxEq(circle.radius, 1.0));
+}
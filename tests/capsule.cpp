@@ -0,0 +1,232 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <ez/geo/Intersect.hpp>
+#include <ez/geo/BatchIntersect.hpp>
+#include <ez/geo/Support.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	using vec3_t = glm::dvec3;
+
+	// Smallest distance between the segments, sampling the first one and solving exactly against the second.
+	double sampled_distance(const ez::Line3<double>& a, const ez::Line3<double>& b) {
+		double best = std::numeric_limits<double>::max();
+		for (int i = 0; i <= 2000; ++i) {
+			vec3_t p = a.start + (a.end - a.start) * (double(i) / 2000.0);
+			vec3_t on;
+			best = std::min(best, std::sqrt(ez::closest_point(b, p, on)));
+		}
+		return best;
+	}
+
+	double sampled_box_distance(const ez::Line3<double>& a, const ez::MMRect3<double>& box) {
+		double best = std::numeric_limits<double>::max();
+		for (int i = 0; i <= 2000; ++i) {
+			vec3_t p = a.start + (a.end - a.start) * (double(i) / 2000.0);
+			best = std::min(best, glm::length(p - glm::clamp(p, box.min, box.max)));
+		}
+		return best;
+	}
+}
+
+TEST_CASE("segment closest points") {
+	using namespace ez;
+
+	std::mt19937 gen{ 50 };
+	std::uniform_real_distribution<double> pos{ -5.0, 5.0 };
+
+	bool match = true;
+	for (int n = 0; n < 300; ++n) {
+		Line3<double> a{ vec3_t{ pos(gen), pos(gen), pos(gen) }, vec3_t{ pos(gen), pos(gen), pos(gen) } };
+		Line3<double> b{ vec3_t{ pos(gen), pos(gen), pos(gen) }, vec3_t{ pos(gen), pos(gen), pos(gen) } };
+		if (n % 5 == 1) {
+			// Parallel
+			b.end = b.start + (a.end - a.start) * 0.7;
+		}
+		else if (n % 5 == 2) {
+			// Degenerate
+			b.end = b.start;
+		}
+
+		vec3_t onA, onB;
+		double dist = std::sqrt(closest_points(a, b, onA, onB));
+		double step = glm::length(a.end - a.start) / 2000.0;
+		match &= dist <= sampled_distance(a, b) + step;
+		match &= approxEq(glm::length(onA - onB), dist);
+		// The points are on the segments.
+		vec3_t on;
+		match &= closest_point(a, onA, on) <= 1e-12 && closest_point(b, onB, on) <= 1e-12;
+	}
+	REQUIRE(match);
+
+	// Parallel segments with an overlap, any pair along the overlap is closest.
+	vec3_t onA, onB;
+	REQUIRE(approxEq(closest_points(Line3<double>{ vec3_t{ 0.0 }, vec3_t{ 4.0, 0.0, 0.0 } }, Line3<double>{ vec3_t{ 1.0, 2.0, 0.0 }, vec3_t{ 6.0, 2.0, 0.0 } }, onA, onB), 4.0));
+	REQUIRE(approxEq(onB - onA, vec3_t{ 0.0, 2.0, 0.0 }));
+	// Crossing
+	REQUIRE(approxEq(closest_points(Line3<double>{ vec3_t{ -1.0, 0.0, 0.0 }, vec3_t{ 1.0, 0.0, 0.0 } }, Line3<double>{ vec3_t{ 0.0, -1.0, 0.0 }, vec3_t{ 0.0, 1.0, 0.0 } }, onA, onB), 0.0));
+	REQUIRE(approxEq(onA, vec3_t{ 0.0 }));
+	// Both degenerate
+	REQUIRE(approxEq(closest_points(Line3<double>{ vec3_t{ 1.0 }, vec3_t{ 1.0 } }, Line3<double>{ vec3_t{ 1.0, 1.0, 4.0 }, vec3_t{ 1.0, 1.0, 4.0 } }, onA, onB), 9.0));
+}
+
+TEST_CASE("capsule overlap") {
+	using namespace ez;
+
+	std::mt19937 gen{ 500 };
+	std::uniform_real_distribution<double> pos{ -5.0, 5.0 };
+	std::uniform_real_distribution<double> rad{ 0.1, 2.0 };
+
+	bool match = true;
+	int hits = 0;
+	for (int n = 0; n < 300; ++n) {
+		Capsule<double> a{ vec3_t{ pos(gen), pos(gen), pos(gen) }, vec3_t{ pos(gen), pos(gen), pos(gen) }, rad(gen) };
+		Capsule<double> b{ vec3_t{ pos(gen), pos(gen), pos(gen) }, vec3_t{ pos(gen), pos(gen), pos(gen) }, rad(gen) };
+		Sphere<double> s{ rad(gen), vec3_t{ pos(gen), pos(gen), pos(gen) } };
+		vec3_t c{ pos(gen), pos(gen), pos(gen) };
+		MMRect3<double> box{ c, c + vec3_t{ rad(gen), rad(gen), rad(gen) } };
+		double step = glm::length(a.axis()) / 2000.0;
+
+		// Skip the pairs too close to touching to be decided by sampling.
+		double dist = sampled_distance(a.segment, b.segment) - a.radius - b.radius;
+		if (std::abs(dist) > step) {
+			match &= intersect(a, b) == (dist < 0.0);
+			hits += dist < 0.0;
+		}
+
+		vec3_t on;
+		dist = std::sqrt(closest_point(a.segment, s.origin, on)) - a.radius - s.radius;
+		match &= intersect(a, s) == (dist <= 0.0) && intersect(s, a) == intersect(a, s);
+
+		dist = sampled_box_distance(a.segment, box) - a.radius;
+		if (std::abs(dist) > step) {
+			match &= intersect(a, box) == (dist < 0.0);
+			hits += dist < 0.0;
+		}
+		match &= intersect(box, a) == intersect(a, box);
+	}
+	REQUIRE(match);
+	REQUIRE(hits > 20);
+
+	// A box just past the end cap, and just touching it.
+	Capsule<double> cap{ vec3_t{ 0.0 }, vec3_t{ 0.0, 2.0, 0.0 }, 0.5 };
+	REQUIRE(!intersect(cap, MMRect3<double>{ vec3_t{ 0.4, 2.4, -1.0 }, vec3_t{ 1.0, 3.0, 1.0 } }));
+	REQUIRE(intersect(cap, MMRect3<double>{ vec3_t{ 0.3, 2.3, -1.0 }, vec3_t{ 1.0, 3.0, 1.0 } }));
+}
+
+TEST_CASE("ray capsule") {
+	using namespace ez;
+
+	Capsule<double> cap{ vec3_t{ 0.0, -1.0, 0.0 }, vec3_t{ 0.0, 1.0, 0.0 }, 0.5 };
+	double t;
+	REQUIRE(intersect(Ray3<double>{ vec3_t{ 1.0, 0.0, 0.0 }, vec3_t{ -3.0, 0.0, 0.0 } }, cap, t));
+	REQUIRE(approxEq(t, 2.5));
+	// Through the cap
+	vec3_t hit;
+	REQUIRE(intersect(Ray3<double>{ vec3_t{ 0.0, -1.0, 0.0 }, vec3_t{ 0.0, 5.0, 0.0 } }, cap, hit));
+	REQUIRE(approxEq(hit, vec3_t{ 0.0, 1.5, 0.0 }));
+	REQUIRE(!intersect(Ray3<double>{ vec3_t{ 1.0, 0.0, 0.0 }, vec3_t{ -3.0, 0.0, 0.6 } }, cap));
+	// Starting inside
+	REQUIRE(intersect(Ray3<double>{ vec3_t{ 1.0, 0.0, 0.0 }, vec3_t{ 0.0, 0.5, 0.1 } }, cap, t));
+	REQUIRE(t == 0.0);
+
+	std::mt19937 gen{ 5000 };
+	std::normal_distribution<double> normal{ 0.0, 1.0 };
+	std::uniform_real_distribution<double> pos{ -5.0, 5.0 };
+	bool match = true;
+	for (int n = 0; n < 200; ++n) {
+		Capsule<double> c{ vec3_t{ pos(gen), pos(gen), pos(gen) } * 0.3, vec3_t{ pos(gen), pos(gen), pos(gen) } * 0.3, 1.0 };
+		Ray3<double> ray{ glm::normalize(vec3_t{ normal(gen), normal(gen), normal(gen) }), vec3_t{ pos(gen), pos(gen), pos(gen) } * 2.0 };
+		vec3_t on;
+		if (closest_point(c.segment, ray.origin, on) <= 1.0) {
+			continue;
+		}
+		if (intersect(ray, c, hit)) {
+			// On the surface
+			match &= approxEq(std::sqrt(closest_point(c.segment, hit, on)), c.radius);
+		}
+		else {
+			// Never within the radius along the ray.
+			for (int i = 0; i <= 400; ++i) {
+				match &= closest_point(c.segment, ray.eval(double(i) * 0.05), on) > c.radius * c.radius;
+			}
+		}
+	}
+	REQUIRE(match);
+}
+
+TEST_CASE("capsule support") {
+	using namespace ez;
+
+	Capsule<double> cap{ vec3_t{ 1.0, 0.0, 0.0 }, vec3_t{ 1.0, 3.0, 0.0 }, 0.5 };
+	REQUIRE(approxEq(support(cap, vec3_t{ 0.0, 2.0, 0.0 }), vec3_t{ 1.0, 3.5, 0.0 }));
+	REQUIRE(approxEq(support(cap, vec3_t{ -1.0, 0.0, 0.0 }), vec3_t{ 0.5, 0.0, 0.0 }));
+	vec3_t dir = glm::normalize(vec3_t{ 1.0, -1.0, 1.0 });
+	REQUIRE(approxEq(support(cap, dir * 3.0), vec3_t{ 1.0, 0.0, 0.0 } + dir * 0.5));
+}
+
+TEST_CASE("capsule batch") {
+	using namespace ez;
+
+	std::mt19937 gen{ 50000 };
+	std::uniform_real_distribution<float> pos{ -20.f, 20.f };
+	std::uniform_real_distribution<float> rad{ 0.2f, 3.f };
+
+	CapsuleSoA<float> capsules;
+	SphereSoA<float> spheres;
+	MMRectSoA3<float> boxes;
+	for (int i = 0; i < 2000; ++i) {
+		glm::vec3 a{ pos(gen), pos(gen), pos(gen) };
+		capsules.push_back(Capsule<float>{ a, a + glm::vec3{ pos(gen), pos(gen), pos(gen) } * 0.2f, rad(gen) });
+		spheres.push_back(Sphere<float>{ rad(gen), glm::vec3{ pos(gen), pos(gen), pos(gen) } });
+		glm::vec3 c{ pos(gen), pos(gen), pos(gen) };
+		boxes.push_back(MMRect3<float>{ c, c + glm::vec3{ rad(gen), rad(gen), rad(gen) } });
+	}
+	REQUIRE(capsules.size() == 2000);
+	REQUIRE(capsules.get(5).radius == capsules.radius[5]);
+
+	Capsule<float> query{ glm::vec3{ -8.f, 0.f, 1.f }, glm::vec3{ 9.f, 2.f, -3.f }, 2.5f };
+	Sphere<float> sphere{ 6.f, glm::vec3{ 2.f, -3.f, 1.f } };
+	Ray3<float> ray{ glm::normalize(glm::vec3{ 1.f, 0.2f, -0.1f }), glm::vec3{ -25.f, 0.f, 0.f } };
+
+	auto reference = [](auto&& test, std::size_t count) {
+		std::vector<std::uint32_t> ret;
+		for (std::size_t i = 0; i < count; ++i) {
+			if (test(i)) {
+				ret.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+		return ret;
+	};
+
+	std::vector<std::uint32_t> hits;
+	intersect_batch(query, capsules, hits);
+	REQUIRE(!hits.empty());
+	REQUIRE(hits == reference([&](std::size_t i) { return intersect(query, capsules.get(i)); }, capsules.size()));
+
+	hits.clear();
+	intersect_batch(query, spheres, hits);
+	REQUIRE(!hits.empty());
+	REQUIRE(hits == reference([&](std::size_t i) { return intersect(query, spheres.get(i)); }, spheres.size()));
+
+	hits.clear();
+	intersect_batch(sphere, capsules, hits);
+	REQUIRE(!hits.empty());
+	REQUIRE(hits == reference([&](std::size_t i) { return intersect(sphere, capsules.get(i)); }, capsules.size()));
+
+	hits.clear();
+	intersect_batch(query, boxes, hits);
+	REQUIRE(!hits.empty());
+	REQUIRE(hits == reference([&](std::size_t i) { return intersect(query, boxes.get(i)); }, boxes.size()));
+
+	hits.clear();
+	intersect_batch(ray, capsules, hits);
+	REQUIRE(!hits.empty());
+	REQUIRE(hits == reference([&](std::size_t i) { return intersect(ray, capsules.get(i)); }, capsules.size()));
+}
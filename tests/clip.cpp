@@ -0,0 +1,139 @@
+#include <random>
+#include <vector>
+
+#include <ez/geo/Clip.hpp>
+#include <ez/geo/Polygon.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("segment clipping") {
+	using namespace ez;
+	MMRect2<double> rect{ glm::dvec2{ 0 }, glm::dvec2{ 4, 2 } };
+
+	Line2<double> inside{ glm::dvec2{ 1, 1 }, glm::dvec2{ 3, 1.5 } };
+	REQUIRE(clip(inside, rect));
+	REQUIRE(approxEq(inside.start, glm::dvec2{ 1, 1 }));
+	REQUIRE(approxEq(inside.end, glm::dvec2{ 3, 1.5 }));
+
+	Line2<double> across{ glm::dvec2{ -2, 1 }, glm::dvec2{ 6, 1 } };
+	REQUIRE(clip(across, rect));
+	REQUIRE(approxEq(across.start, glm::dvec2{ 0, 1 }));
+	REQUIRE(approxEq(across.end, glm::dvec2{ 4, 1 }));
+
+	Line2<double> diagonal{ glm::dvec2{ -1, -1 }, glm::dvec2{ 3, 3 } };
+	REQUIRE(clip(diagonal, rect));
+	REQUIRE(approxEq(diagonal.start, glm::dvec2{ 0, 0 }));
+	REQUIRE(approxEq(diagonal.end, glm::dvec2{ 2, 2 }));
+
+	// Beyond one side, and crossing two outside regions without touching the rect.
+	Line2<double> above{ glm::dvec2{ 1, 3 }, glm::dvec2{ 3, 5 } };
+	REQUIRE_FALSE(clip(above, rect));
+	Line2<double> corner{ glm::dvec2{ -1, 1.5 }, glm::dvec2{ 1, 4 } };
+	REQUIRE_FALSE(clip(corner, rect));
+
+	// The batch forms match the scalar one.
+	std::mt19937 gen{ 41 };
+	std::uniform_real_distribution<double> dist{ -3.0, 7.0 };
+	LineSoA2<double> lines;
+	for (int i = 0; i < 2000; ++i) {
+		lines.push_back(Line2<double>{ glm::dvec2{ dist(gen), dist(gen) }, glm::dvec2{ dist(gen), dist(gen) } });
+	}
+
+	LineSoA2<double> clipped, compact;
+	std::vector<std::uint8_t> visible(lines.size());
+	std::vector<std::uint32_t> source(lines.size());
+	clip_batch(lines, rect, clipped, visible.data());
+	std::size_t kept = clip_compact(lines, rect, compact, source.data());
+	REQUIRE(compact.size() == kept);
+
+	bool match = true;
+	std::size_t next = 0;
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		Line2<double> line = lines.get(i);
+		bool expected = clip(line, rect);
+		match &= (visible[i] != 0) == expected;
+		if (expected) {
+			match &= approxEq(clipped.get(i).start, line.start) && approxEq(clipped.get(i).end, line.end);
+			match &= next < kept && source[next] == i;
+			match &= approxEq(compact.get(next).start, line.start) && approxEq(compact.get(next).end, line.end);
+			++next;
+		}
+	}
+	match &= next == kept;
+	REQUIRE(match);
+}
+
+TEST_CASE("polygon clipping") {
+	using namespace ez;
+	MMRect2<double> rect{ glm::dvec2{ 0 }, glm::dvec2{ 4 } };
+
+	std::vector<glm::dvec2> out(16), scratch(16);
+
+	// Fully inside passes through, fully beyond a side is dropped.
+	std::vector<glm::dvec2> small{ { 1, 1 }, { 2, 1 }, { 2, 2 } };
+	REQUIRE(clip(small.data(), small.size(), rect, out.data(), scratch.data()) == 3);
+	std::vector<glm::dvec2> right{ { 5, 1 }, { 6, 1 }, { 6, 2 } };
+	REQUIRE(clip(right.data(), right.size(), rect, out.data(), scratch.data()) == 0);
+
+	// A larger square covering the rect clips to the rect itself.
+	std::vector<glm::dvec2> big{ { -1, -1 }, { 5, -1 }, { 5, 5 }, { -1, 5 } };
+	std::size_t count = clip(big.data(), big.size(), rect, out.data(), scratch.data());
+	REQUIRE(count == 4);
+	REQUIRE(approxEq(Polygon2<double>{ out.data(), count }.area(), 16.0));
+
+	// A diamond through every side becomes an octagon.
+	std::vector<glm::dvec2> diamond{ { 2, -1 }, { 5, 2 }, { 2, 5 }, { -1, 2 } };
+	count = clip(diamond.data(), diamond.size(), rect, out.data(), scratch.data());
+	REQUIRE(count == 8);
+	REQUIRE(approxEq(Polygon2<double>{ out.data(), count }.area(), 16.0 - 4 * 0.5));
+	bool bounded = true;
+	for (std::size_t i = 0; i < count; ++i) {
+		bounded &= rect.contains(out[i]) || approxEq(out[i].x, 4.0) || approxEq(out[i].y, 4.0);
+	}
+	REQUIRE(bounded);
+
+	// Batch of polygons, indices of the results match the inputs.
+	std::vector<glm::dvec2> verts;
+	std::vector<std::size_t> offsets{ 0 };
+	for (const std::vector<glm::dvec2>* poly : { &small, &right, &big, &diamond }) {
+		verts.insert(verts.end(), poly->begin(), poly->end());
+		offsets.push_back(verts.size());
+	}
+	std::vector<glm::dvec2> outVerts, work;
+	std::vector<std::size_t> outOffsets;
+	clip_batch(verts.data(), offsets.data(), 4, rect, outVerts, outOffsets, work);
+	REQUIRE(outOffsets == std::vector<std::size_t>{ 0, 3, 3, 7, 15 });
+	REQUIRE(outVerts.size() == 15);
+
+	// A comb with its teeth across x = 0 grows past count + 4, every tooth tip is replaced by two crossings.
+	std::vector<glm::dvec2> comb;
+	for (int i = 0; i <= 12; ++i) {
+		comb.push_back(glm::dvec2{ i % 2 == 0 ? 1.0 : -1.0, 0.5 + 0.25 * i });
+	}
+	comb.push_back(glm::dvec2{ 3, 3.5 });
+	comb.push_back(glm::dvec2{ 3, 0.5 });
+	REQUIRE(comb.size() == 15);
+
+	std::vector<glm::dvec2> combOut(clip_capacity(comb.size())), combScratch(clip_capacity(comb.size()));
+	count = clip(comb.data(), comb.size(), rect, combOut.data(), combScratch.data());
+	REQUIRE(count == 21);
+	bounded = true;
+	for (std::size_t i = 0; i < count; ++i) {
+		bounded &= rect.contains(combOut[i]);
+	}
+	REQUIRE(bounded);
+
+	// The batch grows its buffers for concave polygons and matches the scalar clip.
+	verts = comb;
+	verts.insert(verts.end(), comb.begin(), comb.end());
+	offsets = { 0, comb.size(), 2 * comb.size() };
+	clip_batch(verts.data(), offsets.data(), 2, rect, outVerts, outOffsets, work);
+	REQUIRE(outOffsets == std::vector<std::size_t>{ 0, 21, 42 });
+	bool match = true;
+	for (std::size_t i = 0; i < count; ++i) {
+		match &= approxEq(outVerts[i], combOut[i]) && approxEq(outVerts[count + i], combOut[i]);
+	}
+	REQUIRE(match);
+}
@@ -0,0 +1,146 @@
+#include <ez/geo/Delaunay.hpp>
+
+#include <random>
+#include <vector>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	// Checks the half edge links, the winding and the empty circumcircle property, returns the number of hull edges.
+	template<typename T>
+	bool valid_delaunay(const ez::Delaunay2<T>& tri, const std::vector<glm::tvec2<T>>& points, std::size_t& hull) {
+		using D = ez::Delaunay2<T>;
+		const std::pmr::vector<std::uint32_t>& tris = tri.triangles();
+		const std::pmr::vector<std::uint32_t>& twins = tri.halfedges();
+
+		bool valid = tris.size() == twins.size();
+		hull = 0;
+		for (std::uint32_t e = 0; e < tris.size(); ++e) {
+			if (e % 3 == 0) {
+				valid = valid && ez::orient2d(points[tris[e]], points[tris[e + 1]], points[tris[e + 2]]) > 0.0;
+			}
+
+			std::uint32_t o = twins[e];
+			if (o == D::Invalid) {
+				++hull;
+				continue;
+			}
+			valid = valid && twins[o] == e;
+			valid = valid && tris[o] == tris[D::next(e)] && tris[D::next(o)] == tris[e];
+
+			// The vertex across the edge can not be inside the circumcircle.
+			std::uint32_t t = e - e % 3;
+			std::uint32_t across = tris[D::prev(o)];
+			valid = valid && ez::incircle(points[tris[t]], points[tris[t + 1]], points[tris[t + 2]], points[across]) <= 0.0;
+		}
+		return valid;
+	}
+}
+
+TEST_CASE("robust predicates") {
+	using namespace ez;
+
+	REQUIRE(orient2d(glm::dvec2{ 0, 0 }, glm::dvec2{ 1, 0 }, glm::dvec2{ 0, 1 }) > 0.0);
+	REQUIRE(orient2d(glm::dvec2{ 0, 0 }, glm::dvec2{ 0, 1 }, glm::dvec2{ 1, 0 }) < 0.0);
+	REQUIRE(orient2d(glm::dvec2{ 0, 0 }, glm::dvec2{ 1, 1 }, glm::dvec2{ 3, 3 }) == 0.0);
+
+	// Nearly collinear points where the plain floating point determinant gets the sign wrong.
+	glm::dvec2 a{ 0.5, 0.5 }, b{ 12, 12 }, c{ 24, 24 };
+	int wrong = 0;
+	for (int i = 0; i < 64; ++i) {
+		for (int j = 0; j < 64; ++j) {
+			glm::dvec2 p{ std::nextafter(a.x, 1.0), a.y };
+			for (int k = 0; k < i; ++k) {
+				p.x = std::nextafter(p.x, 1.0);
+			}
+			for (int k = 0; k < j; ++k) {
+				p.y = std::nextafter(p.y, 1.0);
+			}
+
+			// p lies below the line y = x exactly when p.y < p.x.
+			double o = orient2d(p, b, c);
+			int expected = p.y > p.x ? 1 : (p.y < p.x ? -1 : 0);
+			int got = o > 0.0 ? 1 : (o < 0.0 ? -1 : 0);
+			wrong += got != expected;
+		}
+	}
+	REQUIRE(wrong == 0);
+
+	REQUIRE(incircle(glm::dvec2{ 1, 0 }, glm::dvec2{ 0, 1 }, glm::dvec2{ -1, 0 }, glm::dvec2{ 0, 0 }) > 0.0);
+	REQUIRE(incircle(glm::dvec2{ 1, 0 }, glm::dvec2{ 0, 1 }, glm::dvec2{ -1, 0 }, glm::dvec2{ 0, -1 }) == 0.0);
+	REQUIRE(incircle(glm::dvec2{ 1, 0 }, glm::dvec2{ 0, 1 }, glm::dvec2{ -1, 0 }, glm::dvec2{ 0, -1.0000000001 }) < 0.0);
+
+	// d below the counterclockwise triangle
+	glm::dvec3 p0{ 0, 0, 0 }, p1{ 1, 0, 0 }, p2{ 0, 1, 0 };
+	REQUIRE(orient3d(p0, p1, p2, glm::dvec3{ 0.2, 0.2, -1 }) > 0.0);
+	REQUIRE(orient3d(p0, p1, p2, glm::dvec3{ 0.2, 0.2, 1 }) < 0.0);
+	REQUIRE(orient3d(p0, p1, p2, glm::dvec3{ 7, -3, 0 }) == 0.0);
+
+	// Points a single ulp off of a tilted plane
+	std::mt19937 gen{ 19 };
+	std::uniform_real_distribution<double> dist{ -10.0, 10.0 };
+	glm::dvec3 q0{ 0.1, 0.2, 0.3 }, q1{ 1.1, 0.2, 1.3 }, q2{ 0.1, 1.2, 0.3 };
+	wrong = 0;
+	for (int i = 0; i < 1000; ++i) {
+		// The plane through q0, q1, q2 is z = x + 0.2.
+		double x = dist(gen), y = dist(gen);
+		glm::dvec3 on{ x, y, x + 0.2 };
+		double exact = intern::orient3d_exact(q0, q1, q2, on);
+		wrong += (orient3d(q0, q1, q2, on) > 0.0) != (exact > 0.0);
+		wrong += (orient3d(q0, q1, q2, on) < 0.0) != (exact < 0.0);
+
+		glm::dvec3 off = on;
+		off.z = std::nextafter(on.z, 100.0);
+		exact = intern::orient3d_exact(q0, q1, q2, off);
+		wrong += (orient3d(q0, q1, q2, off) > 0.0) != (exact > 0.0);
+		wrong += exact == 0.0;
+	}
+	REQUIRE(wrong == 0);
+
+	glm::dvec3 s0{ 1, 0, 0 }, s1{ 0, 1, 0 }, s2{ 0, 0, 1 }, s3{ -1, 0, 0 };
+	REQUIRE(orient3d(s0, s1, s2, s3) > 0.0);
+	REQUIRE(insphere(s0, s1, s2, s3, glm::dvec3{ 0, 0, 0 }) > 0.0);
+	REQUIRE(insphere(s0, s1, s2, s3, glm::dvec3{ 0, -1, 0 }) == 0.0);
+	REQUIRE(insphere(s0, s1, s2, s3, glm::dvec3{ 0, 0, -1.0000000001 }) < 0.0);
+}
+
+TEST_CASE("delaunay triangulation") {
+	using namespace ez;
+
+	std::mt19937 gen{ 3 };
+	std::uniform_real_distribution<float> dist{ -100.f, 100.f };
+
+	std::vector<glm::vec2> points;
+	for (int i = 0; i < 5000; ++i) {
+		points.push_back(glm::vec2{ dist(gen), dist(gen) });
+	}
+
+	Delaunay2<float> tri{ points };
+	std::size_t hull;
+	REQUIRE(valid_delaunay(tri, points, hull));
+	// Euler, a triangulation of n points with h on the hull has 2n - h - 2 triangles.
+	REQUIRE(tri.size() == 2 * points.size() - hull - 2);
+
+	// A regular grid, every cell has four cocircular corners and the hull is full of collinear points.
+	points.clear();
+	for (int y = 0; y < 40; ++y) {
+		for (int x = 0; x < 40; ++x) {
+			points.push_back(glm::vec2{ x, y });
+		}
+	}
+	// Duplicates are skipped
+	points.push_back(glm::vec2{ 3, 4 });
+	points.push_back(glm::vec2{ 0, 0 });
+
+	REQUIRE(tri.build(points.data(), points.size()));
+	REQUIRE(valid_delaunay(tri, points, hull));
+	REQUIRE(tri.size() == 2 * 39 * 39);
+	REQUIRE(hull == 4 * 39);
+
+	// Degenerate input
+	points = { glm::vec2{ 0, 0 }, glm::vec2{ 1, 1 }, glm::vec2{ 2, 2 }, glm::vec2{ 1, 1 } };
+	REQUIRE_FALSE(tri.build(points.data(), points.size()));
+	REQUIRE(tri.empty());
+}
@@ -0,0 +1,109 @@
+#include <ez/geo/GJK.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("gjk distance") {
+	using namespace ez;
+
+	Sphere<float> a{ 1.f, glm::vec3{ 0 } };
+	Sphere<float> b{ 1.f, glm::vec3{ 4, 0, 0 } };
+
+	GJKResult<float> result = gjk(a, b);
+	REQUIRE_FALSE(result.overlap);
+	REQUIRE(approxEq(result.distance, 2.f));
+	REQUIRE(approxEq(result.pointA, glm::vec3{ 1, 0, 0 }));
+	REQUIRE(approxEq(result.pointB, glm::vec3{ 3, 0, 0 }));
+
+	MMRect3<float> box{ glm::vec3{ 2, -1, -1 }, glm::vec3{ 3, 1, 1 } };
+	result = gjk(a, box);
+	REQUIRE_FALSE(result.overlap);
+	REQUIRE(approxEq(result.distance, 1.f));
+
+	// Capsule against a box, edge to face.
+	Line3<float> segment;
+	segment.start = glm::vec3{ 0, 3, 0 };
+	segment.end = glm::vec3{ 0, 5, 0 };
+	result = gjk(Inflated<Line3<float>, float>{ segment, 0.5f }, box);
+	REQUIRE_FALSE(result.overlap);
+	REQUIRE(approxEq(result.distance, std::sqrt(8.f) - 0.5f));
+
+	b.move(glm::vec3{ 1.5f, 0, 0 });
+	REQUIRE(gjk_overlap(a, b));
+
+	// The value type follows the shapes.
+	Sphere<double> c{ 1.0, glm::dvec3{ 0 } };
+	MMRect3<double> far{ glm::dvec3{ 3, -1, -1 }, glm::dvec3{ 4, 1, 1 } };
+	GJKResult<double> precise = gjk(c, far);
+	REQUIRE(approxEq(precise.distance, 2.0));
+	REQUIRE(approxEq(gjk_distance(c, far), 2.0));
+}
+
+TEST_CASE("gjk warm start") {
+	using namespace ez;
+
+	Transform3<float> form;
+	form.rotate(0.3f, glm::normalize(glm::vec3{ 1, 1, 0 }));
+	MMRect3<float> unit{ glm::vec3{ -1 }, glm::vec3{ 1 } };
+	Transformed<MMRect3<float>, float> a{ unit, form };
+
+	OBB3<float> b{ glm::vec3{ 4, 0.5f, 0 }, glm::quat{ 1, 0, 0, 0 }, glm::vec3{ 1 } };
+
+	GJKSimplex<float> simplex;
+	GJKResult<float> cold = gjk(a, b, simplex);
+	REQUIRE_FALSE(cold.overlap);
+
+	// Small motion, the cached directions are still nearly optimal.
+	b.translate(glm::vec3{ -0.01f, 0, 0 });
+	GJKResult<float> warm = gjk(a, b, simplex);
+	GJKResult<float> reference = gjk(a, b);
+
+	REQUIRE(warm.iterations <= 2);
+	REQUIRE(warm.iterations <= reference.iterations);
+	REQUIRE(approxEq(warm.distance, reference.distance));
+}
+
+TEST_CASE("epa penetration") {
+	using namespace ez;
+
+	Sphere<double> a{ 1.0, glm::dvec3{ 0 } };
+	Sphere<double> b{ 1.0, glm::dvec3{ 1.5, 0, 0 } };
+
+	GJKSimplex<double> simplex;
+	REQUIRE(gjk(a, b, simplex).overlap);
+
+	Penetration<double> pen;
+	EPAScratch<double> scratch;
+	epa(a, b, simplex, pen, scratch, 128);
+	REQUIRE(std::abs(pen.depth - 0.5) < 1e-3);
+	REQUIRE(pen.normal.x > 0.99);
+
+	MMRect3<double> boxA{ glm::dvec3{ 0 }, glm::dvec3{ 2 } };
+	MMRect3<double> boxB{ glm::dvec3{ 1.75, 0.5, 0.5 }, glm::dvec3{ 3 } };
+
+	simplex.clear();
+	REQUIRE(gjk(boxA, boxB, simplex).overlap);
+	REQUIRE(epa(boxA, boxB, simplex, pen));
+	REQUIRE(approxEq(pen.depth, 0.25));
+	REQUIRE(approxEq(pen.normal, glm::dvec3{ 1, 0, 0 }));
+
+	// A reused scratch gives the same result.
+	REQUIRE(epa(boxA, boxB, simplex, pen, scratch));
+	REQUIRE(approxEq(pen.depth, 0.25));
+	REQUIRE(approxEq(pen.normal, glm::dvec3{ 1, 0, 0 }));
+
+	// Boxes produce coplanar support points, whatever the iteration count the estimate stays finite.
+	MMRect3<double> boxC{ glm::dvec3{ 0.5 }, glm::dvec3{ 1.5 } };
+	bool finite = true;
+	for (int iterations = 0; iterations < 8; ++iterations) {
+		simplex.clear();
+		REQUIRE(gjk(boxA, boxC, simplex).overlap);
+		pen = Penetration<double>{};
+		epa(boxA, boxC, simplex, pen, scratch, iterations);
+		finite &= std::isfinite(pen.depth) && std::isfinite(glm::length(pen.normal));
+		finite &= std::isfinite(glm::length(pen.pointA)) && std::isfinite(glm::length(pen.pointB));
+		finite &= approxEq(glm::length(pen.normal), 1.0);
+	}
+	REQUIRE(finite);
+}
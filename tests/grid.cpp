@@ -0,0 +1,153 @@
+#include <ez/geo/GridTraversal.hpp>
+#include <ez/geo/AABB.hpp>
+
+#include <random>
+#include <vector>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	struct Visit {
+		glm::ivec3 cell;
+		float entry, exit;
+	};
+
+	// The cells the ray passes through for a non zero length, tested one box at a time.
+	std::vector<glm::ivec3> brute_cells(const ez::Ray3<float>& ray, const ez::AABB3<float>& domain, const glm::ivec3& dims) {
+		std::vector<glm::ivec3> ret;
+		glm::vec3 size = (domain.max - domain.min) / glm::vec3(dims);
+		for (int z = 0; z < dims.z; ++z) {
+			for (int y = 0; y < dims.y; ++y) {
+				for (int x = 0; x < dims.x; ++x) {
+					glm::vec3 lo = domain.min + size * glm::vec3(x, y, z);
+					float tmin, tmax;
+					ez::intern::ray_slabs(ray.origin, 1.f / ray.axis, lo, lo + size, tmin, tmax);
+					if (tmax - std::max(tmin, 0.f) > 1e-3f) {
+						ret.push_back(glm::ivec3(x, y, z));
+					}
+				}
+			}
+		}
+		return ret;
+	}
+
+	bool has_cell(const std::vector<Visit>& visits, const glm::ivec3& cell) {
+		for (const Visit& visit : visits) {
+			if (visit.cell == cell) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+TEST_CASE("grid traversal") {
+	using namespace ez;
+
+	AABB3<float> domain{ glm::vec3{ 0 }, glm::vec3{ 8, 4, 4 } };
+	glm::ivec3 dims{ 8, 4, 4 };
+
+	// Straight down the x axis
+	std::vector<Visit> visits;
+	traverse(Ray3<float>{ glm::vec3{ 1, 0, 0 }, glm::vec3{ -1, 0.5f, 0.5f } }, domain, dims, [&](const glm::ivec3& cell, float t0, float t1) {
+		visits.push_back(Visit{ cell, t0, t1 });
+		return true;
+	});
+	REQUIRE(visits.size() == 8);
+	for (int i = 0; i < 8; ++i) {
+		REQUIRE(visits[i].cell == glm::ivec3(i, 0, 0));
+		REQUIRE(approxEq(visits[i].entry, float(i + 1)));
+		REQUIRE(approxEq(visits[i].exit, float(i + 2)));
+	}
+
+	// Stopping early
+	int count = 0;
+	bool stopped = traverse(Ray3<float>{ glm::vec3{ 1, 0, 0 }, glm::vec3{ -1, 0.5f, 0.5f } }, domain, dims, [&](const glm::ivec3&, float, float) {
+		return ++count < 3;
+	});
+	REQUIRE(stopped);
+	REQUIRE(count == 3);
+
+	// Missing the domain
+	REQUIRE_FALSE(GridTraversal<float>{ Ray3<float>{ glm::vec3{ 1, 0, 0 }, glm::vec3{ 0, 5, 0 } }, domain, dims }.valid());
+
+	// Random rays against the brute force result
+	std::mt19937 gen{ 17 };
+	std::uniform_real_distribution<float> dist{ -1.f, 1.f };
+	bool match = true;
+	for (int i = 0; i < 200; ++i) {
+		glm::vec3 origin = glm::vec3{ 4, 2, 2 } + glm::vec3{ dist(gen), dist(gen), dist(gen) } * 6.f;
+		glm::vec3 axis = glm::normalize(glm::vec3{ dist(gen), dist(gen), dist(gen) });
+		Ray3<float> ray{ axis, origin };
+
+		visits.clear();
+		traverse(ray, domain, dims, [&](const glm::ivec3& cell, float t0, float t1) {
+			visits.push_back(Visit{ cell, t0, t1 });
+			return true;
+		});
+
+		// Each cell starts where the last one ended, and neighbours share a face.
+		for (std::size_t k = 1; k < visits.size(); ++k) {
+			glm::ivec3 diff = visits[k].cell - visits[k - 1].cell;
+			match = match && approxEq(visits[k].entry, visits[k - 1].exit);
+			match = match && (std::abs(diff.x) + std::abs(diff.y) + std::abs(diff.z)) == 1;
+		}
+
+		for (const glm::ivec3& cell : brute_cells(ray, domain, dims)) {
+			match = match && has_cell(visits, cell);
+		}
+	}
+	REQUIRE(match);
+}
+
+TEST_CASE("hierarchical grid traversal") {
+	using namespace ez;
+
+	AABB3<float> domain{ glm::vec3{ 0 }, glm::vec3{ 10 } };
+	glm::ivec3 dims{ 10 };
+
+	// Block size does not divide the grid, the last blocks are partial.
+	GridOccupancy occupancy{ dims, 4 };
+	REQUIRE(occupancy.blockCount() == glm::ivec3(3));
+
+	std::vector<glm::ivec3> solid{ { 1, 1, 1 }, { 5, 6, 5 }, { 9, 9, 9 }, { 9, 0, 4 } };
+	for (const glm::ivec3& cell : solid) {
+		occupancy.mark(cell);
+	}
+
+	std::mt19937 gen{ 5 };
+	std::uniform_real_distribution<float> dist{ -1.f, 1.f };
+	bool match = true;
+	for (int i = 0; i < 300; ++i) {
+		glm::vec3 origin = glm::vec3{ 5 } + glm::vec3{ dist(gen), dist(gen), dist(gen) } * 8.f;
+		glm::vec3 target{ solid[i % solid.size()] };
+		glm::vec3 axis = glm::normalize(target + glm::vec3{ dist(gen), dist(gen), dist(gen) } * 0.4f + glm::vec3{ 0.5f } - origin);
+		Ray3<float> ray{ axis, origin };
+
+		std::vector<Visit> all, sparse;
+		traverse(ray, domain, dims, [&](const glm::ivec3& cell, float t0, float t1) {
+			all.push_back(Visit{ cell, t0, t1 });
+			return true;
+		});
+		traverse_hierarchical(ray, domain, occupancy, [&](const glm::ivec3& cell, float t0, float t1) {
+			sparse.push_back(Visit{ cell, t0, t1 });
+			return true;
+		});
+
+		// Every visited cell lies in an occupied block, and the solid cells on the ray are all found.
+		for (const Visit& visit : sparse) {
+			match = match && occupancy.occupied(visit.cell / 4);
+		}
+		for (std::size_t k = 1; k < sparse.size(); ++k) {
+			match = match && sparse[k].entry >= sparse[k - 1].entry;
+		}
+		for (const glm::ivec3& cell : solid) {
+			if (has_cell(all, cell)) {
+				match = match && has_cell(sparse, cell);
+			}
+		}
+	}
+	REQUIRE(match);
+}
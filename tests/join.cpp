@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <ez/geo/Join.hpp>
+#include <ez/geo/ThreadPool.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	bool pair_less(const ez::IndexPair& l, const ez::IndexPair& r) {
+		return l.first != r.first ? l.first < r.first : l.second < r.second;
+	}
+	bool pair_equal(const ez::IndexPair& l, const ez::IndexPair& r) {
+		return l.first == r.first && l.second == r.second;
+	}
+}
+
+TEST_CASE("spatial join") {
+	using namespace ez;
+
+	std::mt19937 gen{ 5 };
+	std::uniform_real_distribution<double> pos{ -100.0, 100.0 };
+	std::uniform_real_distribution<double> ext{ 0.1, 6.0 };
+
+	MMRectSoA2<double> a, b;
+	for (int i = 0; i < 2000; ++i) {
+		glm::dvec2 p{ pos(gen), pos(gen) };
+		a.push_back(MMRect<double, 2>{ p, p + glm::dvec2{ ext(gen), ext(gen) } });
+	}
+	for (int i = 0; i < 1500; ++i) {
+		glm::dvec2 p{ pos(gen), pos(gen) };
+		// A few large rects span many cells and must still be reported once per pair.
+		double scale = i % 100 == 0 ? 20.0 : 1.0;
+		b.push_back(MMRect<double, 2>{ p, p + glm::dvec2{ ext(gen), ext(gen) } * scale });
+	}
+	// Rects sharing edges with cells and with each other.
+	a.push_back(MMRect<double, 2>{ glm::dvec2{ 0.0 }, glm::dvec2{ 1.0 } });
+	b.push_back(MMRect<double, 2>{ glm::dvec2{ 1.0, 0.0 }, glm::dvec2{ 2.0, 1.0 } });
+	b.push_back(MMRect<double, 2>{ glm::dvec2{ 0.0 }, glm::dvec2{ 1.0 } });
+
+	std::vector<IndexPair> expected;
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		for (std::size_t j = 0; j < b.size(); ++j) {
+			bool overlap =
+				(a.min.data(0)[i] < b.max.data(0)[j]) && (b.min.data(0)[j] < a.max.data(0)[i]) &&
+				(a.min.data(1)[i] < b.max.data(1)[j]) && (b.min.data(1)[j] < a.max.data(1)[i]);
+			if (overlap) {
+				expected.push_back(IndexPair{ std::uint32_t(i), std::uint32_t(j) });
+			}
+		}
+	}
+	REQUIRE(!expected.empty());
+
+	ThreadPool pool{ 4 };
+	std::vector<IndexPair> parallel, serial, coarse;
+	REQUIRE(spatial_join(a, b, parallel, pool) == expected.size());
+	REQUIRE(spatial_join(a, b, serial, SerialExecutor{}) == expected.size());
+	spatial_join(a, b, coarse, pool, 1);
+
+	// A reused scratch gives the same pairs as a fresh one.
+	JoinScratch scratch;
+	std::vector<IndexPair> reused;
+	spatial_join(a, b, reused, pool, scratch, 3);
+	reused.clear();
+	REQUIRE(spatial_join(a, b, reused, pool, scratch) == expected.size());
+	bool same = reused.size() == serial.size();
+	for (std::size_t i = 0; same && i < reused.size(); ++i) {
+		same &= pair_equal(reused[i], serial[i]);
+	}
+	REQUIRE(same);
+
+	// The output does not depend on the executor.
+	bool match = parallel.size() == serial.size();
+	for (std::size_t i = 0; match && i < parallel.size(); ++i) {
+		match &= pair_equal(parallel[i], serial[i]);
+	}
+	REQUIRE(match);
+
+	// Nor, once sorted, on the grid.
+	std::sort(parallel.begin(), parallel.end(), pair_less);
+	std::sort(coarse.begin(), coarse.end(), pair_less);
+	match = parallel.size() == expected.size() && coarse.size() == expected.size();
+	for (std::size_t i = 0; match && i < expected.size(); ++i) {
+		match &= pair_equal(parallel[i], expected[i]) && pair_equal(coarse[i], expected[i]);
+	}
+	REQUIRE(match);
+
+	// Appends to the output, empty and disjoint sets give nothing.
+	MMRectSoA2<double> empty, far;
+	far.push_back(MMRect<double, 2>{ glm::dvec2{ 500.0 }, glm::dvec2{ 501.0 } });
+	std::size_t before = serial.size();
+	REQUIRE(spatial_join(a, empty, serial, pool) == 0);
+	REQUIRE(spatial_join(far, b, serial, pool) == 0);
+	REQUIRE(serial.size() == before);
+
+	// Rects outside the common bounds are not listed in any cell.
+	MMRectSoA2<double> spread = b;
+	for (int i = 0; i < 100; ++i) {
+		spread.push_back(MMRect<double, 2>{ glm::dvec2{ 300.0 + i }, glm::dvec2{ 301.0 + i } });
+	}
+	std::vector<IndexPair> spreadPairs;
+	REQUIRE(spatial_join(a, spread, spreadPairs, pool, scratch) == expected.size());
+	bool listed = false;
+	for (std::uint32_t item : scratch.b.items) {
+		listed |= item >= b.size();
+	}
+	REQUIRE(!listed);
+}
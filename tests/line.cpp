@@ -0,0 +1,59 @@
+#include <ez/geo/Intersect.hpp>
+
+#include <random>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("segment intersection") {
+	using namespace ez;
+	using Line2f = Line2<float>;
+
+	Line2f a{ glm::vec2{ 0, 0 }, glm::vec2{ 2, 2 } };
+	REQUIRE(a.end == glm::vec2{ 2, 2 });
+
+	// Crossing
+	glm::vec2 point;
+	float t1, t2;
+	REQUIRE(intersect(a, Line2f{ glm::vec2{ 0, 2 }, glm::vec2{ 2, 0 } }, point));
+	REQUIRE(approxEq(point, glm::vec2{ 1, 1 }));
+	REQUIRE(intersect(a, Line2f{ glm::vec2{ 0, 1 }, glm::vec2{ 4, 1 } }, t1, t2));
+	REQUIRE(approxEq(t1, 0.5f));
+	REQUIRE(approxEq(t2, 0.25f));
+
+	// Disjoint, parallel and past the end
+	REQUIRE_FALSE(intersect(a, Line2f{ glm::vec2{ 1, 0 }, glm::vec2{ 3, 2 } }));
+	REQUIRE_FALSE(intersect(a, Line2f{ glm::vec2{ 3, 0 }, glm::vec2{ 3, 5 } }));
+
+	// Touching at an endpoint
+	REQUIRE(intersect(a, Line2f{ glm::vec2{ 2, 2 }, glm::vec2{ 5, 0 } }, t1));
+	REQUIRE(t1 == 1.f);
+
+	// Collinear, overlapping and disjoint
+	REQUIRE(intersect(a, Line2f{ glm::vec2{ 3, 3 }, glm::vec2{ 1, 1 } }, t1, t2));
+	REQUIRE(approxEq(t1, 0.5f));
+	REQUIRE(approxEq(t2, 1.f));
+	REQUIRE_FALSE(intersect(a, Line2f{ glm::vec2{ 3, 3 }, glm::vec2{ 4, 4 } }));
+
+	// A point on the segment, then a point just off of it.
+	REQUIRE(intersect(a, Line2f{ glm::vec2{ 0.5f, 0.5f }, glm::vec2{ 0.5f, 0.5f } }));
+	REQUIRE_FALSE(intersect(a, Line2f{ glm::vec2{ 0.5f, std::nextafter(0.5f, 1.f) }, glm::vec2{ 0.5f, std::nextafter(0.5f, 1.f) } }));
+
+	// Segments ending exactly on a long, nearly horizontal segment. The plain determinant test fails on a large part of these.
+	std::mt19937 gen{ 7 };
+	std::uniform_real_distribution<double> dist{ 0.0, 1.0 };
+	Line2<double> base{ glm::dvec2{ 0.1, 0.1 }, glm::dvec2{ 1e3 + 0.3, 1e3 + 0.3 } };
+	int misses = 0;
+	for (int i = 0; i < 1000; ++i) {
+		// A point on the line y = x, approached from above and from exactly on it.
+		double x = 1.0 + dist(gen) * 900.0;
+		glm::dvec2 on{ x, x };
+		glm::dvec2 above{ x, std::nextafter(x, 1e4) };
+		glm::dvec2 far{ x + 1.0, x + 5.0 };
+
+		misses += !intersect(base, Line2<double>{ far, on });
+		misses += intersect(base, Line2<double>{ far, above });
+	}
+	REQUIRE(misses == 0);
+}
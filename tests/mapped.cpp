@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ez/geo/MappedRTree.hpp>
+#include <ez/geo/Intersect.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("mapped rtree") {
+	using namespace ez;
+
+	std::mt19937 gen{ 23 };
+	std::uniform_real_distribution<double> pos{ -1000.0, 1000.0 };
+	std::uniform_real_distribution<double> ext{ 0.5, 20.0 };
+
+	std::vector<MMRect2<double>> rects;
+	for (int i = 0; i < 20000; ++i) {
+		glm::dvec2 p{ pos(gen), pos(gen) };
+		rects.push_back(MMRect2<double>{ p, p + glm::dvec2{ ext(gen), ext(gen) } });
+	}
+
+	std::string path = "ez_geo_mapped_test.bin";
+	{
+		// A small run size forces the external merge of several runs.
+		MappedRTreeBuilder2<double> builder{ path, 3000 };
+		for (std::size_t i = 0; i < rects.size(); ++i) {
+			REQUIRE(builder.add(rects[i], i * 2 + 1));
+		}
+		REQUIRE(builder.finish());
+	}
+	REQUIRE(!std::fopen((path + ".run0").c_str(), "rb"));
+
+	MappedRTree2<double> tree;
+	REQUIRE(tree.open(path));
+	REQUIRE(tree.size() == rects.size());
+	REQUIRE(tree.depth() == 3);
+	REQUIRE(tree.bounds().contains(rects[7]));
+
+	bool match = true;
+	std::vector<std::uint64_t> out, expected;
+	for (int q = 0; q < 100; ++q) {
+		glm::dvec2 p{ pos(gen), pos(gen) };
+		MMRect2<double> region{ p, p + glm::dvec2{ ext(gen), ext(gen) } * 4.0 };
+		tree.setPrefetch(q % 2 == 0);
+
+		out.clear();
+		expected.clear();
+		tree.query(region, out);
+		for (std::size_t i = 0; i < rects.size(); ++i) {
+			if (intersect(region, rects[i])) {
+				expected.push_back(i * 2 + 1);
+			}
+		}
+		std::sort(out.begin(), out.end());
+		match &= out == expected;
+
+		out.clear();
+		expected.clear();
+		tree.query(p, out);
+		for (std::size_t i = 0; i < rects.size(); ++i) {
+			if (rects[i].contains(p)) {
+				expected.push_back(i * 2 + 1);
+			}
+		}
+		std::sort(out.begin(), out.end());
+		match &= out == expected;
+	}
+	REQUIRE(match);
+
+	// A tree of another type must not open the file.
+	MappedRTree2<float> other;
+	REQUIRE(!other.open(path));
+	std::size_t nodes = tree.nodeCount();
+	tree.close();
+
+	// Damaged nodes, an oversized count in the root and children pointing out of the file or back up the tree,
+	// give incomplete results instead of reading or writing out of bounds.
+	{
+		using node_t = MappedRTree2<double>::node_t;
+		std::FILE* file = std::fopen(path.c_str(), "r+b");
+		REQUIRE(file);
+		node_t root;
+		long offset = long(nodes * intern::MappedPageSize);
+		std::fseek(file, offset, SEEK_SET);
+		REQUIRE(std::fread(&root, sizeof(root), 1, file) == 1);
+		root.count = ~std::uint32_t(0);
+		root.child[0] = nodes * 4;
+		root.child[1] = nodes - 1;
+		std::fseek(file, offset, SEEK_SET);
+		REQUIRE(std::fwrite(&root, sizeof(root), 1, file) == 1);
+		std::fclose(file);
+	}
+	REQUIRE(tree.open(path));
+	out.clear();
+	MMRect2<double> everything{ glm::dvec2{ -2000.0 }, glm::dvec2{ 2000.0 } };
+	tree.query(everything, out);
+	REQUIRE(out.size() < rects.size());
+	tree.close();
+	std::remove(path.c_str());
+	REQUIRE(!tree.open(path));
+
+	// Building a tree in memory in a single run, and an empty tree.
+	{
+		MappedRTreeBuilder3<float> builder{ path };
+		builder.add(MMRect3<float>{ glm::vec3{ 0.f }, glm::vec3{ 1.f } });
+		builder.add(MMRect3<float>{ glm::vec3{ 2.f }, glm::vec3{ 3.f } });
+		REQUIRE(builder.finish());
+	}
+	MappedRTree3<float> small;
+	REQUIRE(small.open(path));
+	REQUIRE(small.depth() == 1);
+	out.clear();
+	REQUIRE(small.query(glm::vec3{ 2.5f }, out) == 1);
+	REQUIRE(out[0] == 1);
+	small.close();
+
+	{
+		MappedRTreeBuilder3<float> builder{ path };
+		REQUIRE(builder.finish());
+	}
+	REQUIRE(small.open(path));
+	REQUIRE(small.empty());
+	REQUIRE(small.query(glm::vec3{ 0.f }, out) == 0);
+	small.close();
+	std::remove(path.c_str());
+}
@@ -0,0 +1,187 @@
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <cmath>
+#include <random>
+#include <list>
+#include <vector>
+
+#include <ez/geo/Memory.hpp>
+#include <ez/geo/RTree.hpp>
+#include <ez/geo/Delaunay.hpp>
+#include <ez/geo/Polygon.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	// Global heap allocations made by this thread while counting is on, seen by the replaced operator new below.
+	thread_local bool countHeap = false;
+	thread_local std::size_t heapAllocations = 0;
+
+	// Counts the allocations passed on to the default resource.
+	class CountingResource : public std::pmr::memory_resource {
+	public:
+		std::size_t allocations = 0;
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			++allocations;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+		void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+			std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	bool aligned(void* ptr, std::size_t alignment) {
+		return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+	}
+}
+
+// Replacing the global allocation functions catches the allocations that bypass the resource of a structure.
+void* operator new(std::size_t bytes) {
+	if (countHeap) {
+		++heapAllocations;
+	}
+	if (void* ptr = std::malloc(bytes == 0 ? 1 : bytes)) {
+		return ptr;
+	}
+	throw std::bad_alloc{};
+}
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+TEST_CASE("memory resources") {
+	using namespace ez;
+
+	SECTION("arena") {
+		CountingResource upstream;
+		ArenaResource arena{ 1024, &upstream };
+
+		bool match = true;
+		for (int i = 0; i < 100; ++i) {
+			std::size_t alignment = std::size_t(1) << (i % 7);
+			match &= aligned(arena.allocate(24 + i, alignment), alignment);
+		}
+		REQUIRE(match);
+		REQUIRE(upstream.allocations > 1);
+		std::size_t used = arena.used();
+		REQUIRE(used >= 100 * 24);
+		REQUIRE(arena.capacity() >= used);
+
+		// The blocks of a frame are merged on reset, the same frame then fits in a single block.
+		arena.reset();
+		REQUIRE(arena.used() == 0);
+		std::size_t before = upstream.allocations;
+		for (int frame = 0; frame < 3; ++frame) {
+			for (int i = 0; i < 100; ++i) {
+				std::size_t alignment = std::size_t(1) << (i % 7);
+				REQUIRE(arena.allocate(24 + i, alignment) != nullptr);
+			}
+			arena.reset();
+		}
+		REQUIRE(upstream.allocations == before);
+	}
+
+	SECTION("fixed pool") {
+		CountingResource upstream;
+		FixedPoolResource pool{ 48, 16, 64, &upstream };
+
+		std::vector<void*> blocks;
+		for (int i = 0; i < 100; ++i) {
+			blocks.push_back(pool.allocate(40, 16));
+		}
+		REQUIRE(upstream.allocations == 2);
+		bool match = true;
+		for (void* block : blocks) {
+			match &= aligned(block, 16);
+		}
+		REQUIRE(match);
+
+		// Freed blocks are handed out again, large requests go upstream.
+		pool.deallocate(blocks[10], 40, 16);
+		REQUIRE(pool.allocate(48, 8) == blocks[10]);
+		void* large = pool.allocate(1000, 16);
+		REQUIRE(upstream.allocations == 3);
+		pool.deallocate(large, 1000, 16);
+
+		// Node based containers take their nodes from the pool.
+		std::pmr::list<int> list{ &thread_pool_resource<64>() };
+		for (int i = 0; i < 10; ++i) {
+			list.push_back(i);
+		}
+		REQUIRE(list.size() == 10);
+	}
+
+	SECTION("steady state rebuilds") {
+		std::mt19937 gen{ 3 };
+		std::uniform_real_distribution<float> pos{ -50.f, 50.f };
+
+		std::vector<MMRect2<float>> rects;
+		std::vector<glm::vec2> points;
+		for (int i = 0; i < 2000; ++i) {
+			glm::vec2 p{ pos(gen), pos(gen) };
+			rects.push_back(MMRect2<float>{ p, p + glm::vec2{ 1.f } });
+			points.push_back(p);
+		}
+
+		CountingResource counter;
+		RTree2<float> tree{ rects, &counter };
+		Delaunay2<float> tri{ points, 0, &counter };
+		Polygon2<float> poly{ points.data(), 50, 0, &counter };
+		REQUIRE(tree.resource() == &counter);
+		std::size_t before = counter.allocations;
+
+		// Rebuilding over the same or fewer items reuses the memory, and small nearest queries stay on the stack.
+		std::vector<std::uint32_t> out;
+		out.reserve(64);
+		for (int i = 0; i < 3; ++i) {
+			tree.build(rects.data(), rects.size() - i * 100);
+			tri.build(points.data(), points.size() - i * 100);
+			poly.assign(points.data(), 50 - i);
+			out.clear();
+			tree.nearest(points[i], 8, out);
+		}
+		REQUIRE(counter.allocations == before);
+		REQUIRE(tri.size() > 0);
+		REQUIRE(out.size() == 8);
+	}
+
+	SECTION("no heap allocation in steady state rebuilds") {
+		// Grids and cocircular points are degenerate everywhere, so every predicate takes its exact path.
+		std::vector<glm::dvec2> grid, circle;
+		for (int y = 0; y < 40; ++y) {
+			for (int x = 0; x < 40; ++x) {
+				grid.push_back(glm::dvec2{ x, y });
+			}
+		}
+		for (int i = 0; i < 256; ++i) {
+			double angle = 2.0 * 3.14159265358979323846 * i / 256.0;
+			circle.push_back(glm::dvec2{ std::cos(angle), std::sin(angle) } * 1000.0);
+		}
+
+		Delaunay2<double> tri{ grid };
+		Delaunay2<double> ring{ circle };
+		REQUIRE(tri.size() > 0);
+		REQUIRE(ring.size() > 0);
+
+		heapAllocations = 0;
+		countHeap = true;
+		for (int i = 0; i < 2; ++i) {
+			tri.build(grid.data(), grid.size(), i);
+			ring.build(circle.data(), circle.size(), i);
+		}
+		countHeap = false;
+		REQUIRE(heapAllocations == 0);
+		REQUIRE(tri.size() > 0);
+		REQUIRE(ring.size() > 0);
+	}
+}
@@ -0,0 +1,156 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <ez/geo/Motion.hpp>
+#include <ez/geo/BatchTransform.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	using form_t = ez::Transform<double, 3>;
+
+	form_t random_form(std::mt19937& gen, bool scaled) {
+		std::uniform_real_distribution<double> pos{ -10.0, 10.0 };
+		std::uniform_real_distribution<double> size{ 0.25, 3.0 };
+		std::normal_distribution<double> normal{ 0.0, 1.0 };
+		glm::dquat rot = glm::normalize(glm::dquat{ normal(gen), normal(gen), normal(gen), normal(gen) });
+		glm::dvec3 scale = scaled ? glm::dvec3{ size(gen), size(gen), size(gen) } : glm::dvec3{ 1.0 };
+		return form_t{ glm::dvec3{ pos(gen), pos(gen), pos(gen) }, rot, scale };
+	}
+
+	// Transforms along the motion, as slerp_batch moves them.
+	std::vector<form_t> sample_motion(const form_t& from, const form_t& to, int steps) {
+		ez::TransformSoA<double> a, b, out;
+		a.push_back(from);
+		b.push_back(to);
+		out.resize(1);
+		std::vector<form_t> forms;
+		for (int i = 0; i <= steps; ++i) {
+			ez::slerp_batch(a, b, double(i) / double(steps), out);
+			forms.push_back(out.get(0));
+		}
+		return forms;
+	}
+
+	bool inside(const ez::MMRect3<double>& rect, const glm::dvec3& p) {
+		double eps = 1e-9;
+		return glm::all(glm::greaterThanEqual(p, rect.min - eps)) && glm::all(glm::lessThanEqual(p, rect.max + eps));
+	}
+}
+
+TEST_CASE("swept box bounds") {
+	using namespace ez;
+
+	std::mt19937 gen{ 47 };
+	std::uniform_real_distribution<double> ext{ -2.0, 2.0 };
+
+	bool match = true;
+	double worst = 0.0;
+	for (int n = 0; n < 200; ++n) {
+		bool scaled = n % 2 == 0;
+		form_t from = random_form(gen, scaled), to = random_form(gen, scaled);
+		if (n % 4 == 1) {
+			// Same scale on both ends.
+			to.size = from.size;
+		}
+		glm::dvec3 a{ ext(gen), ext(gen), ext(gen) }, b{ ext(gen), ext(gen), ext(gen) };
+		MMRect3<double> local{ glm::min(a, b), glm::max(a, b) };
+		MMRect3<double> swept = swept_bounds(local, from, to);
+
+		MMRect3<double> sampled{ glm::dvec3{ 1e30 }, glm::dvec3{ -1e30 } };
+		for (const form_t& form : sample_motion(from, to, 64)) {
+			for (int c = 0; c < 8; ++c) {
+				glm::dvec3 corner{ (c & 1) ? local.max.x : local.min.x, (c & 2) ? local.max.y : local.min.y, (c & 4) ? local.max.z : local.min.z };
+				glm::dvec3 p = form.toWorld(corner);
+				match &= inside(swept, p);
+				sampled.min = glm::min(sampled.min, p);
+				sampled.max = glm::max(sampled.max, p);
+			}
+		}
+		if (from.size == to.size) {
+			// Without a change of scale the slack is only the sagitta padding, bounded by the radius of the box.
+			glm::dvec3 slack = (sampled.min - swept.min) + (swept.max - sampled.max);
+			worst = std::max(worst, std::max(std::max(slack.x, slack.y), slack.z) / (2.0 * glm::length(glm::max(glm::abs(local.min), glm::abs(local.max)) * from.size)));
+		}
+	}
+	REQUIRE(match);
+	REQUIRE(worst <= 1.0);
+
+	// A pure translation gives the union of the end bounds.
+	form_t from{ glm::dvec3{ 1.0, 2.0, 3.0 } }, to{ glm::dvec3{ -4.0, 5.0, 0.0 } };
+	MMRect3<double> box{ glm::dvec3{ -1.0 }, glm::dvec3{ 1.0 } };
+	MMRect3<double> swept = swept_bounds(box, from, to);
+	REQUIRE(approxEq(swept.min, glm::dvec3{ -5.0, 1.0, -1.0 }));
+	REQUIRE(approxEq(swept.max, glm::dvec3{ 2.0, 6.0, 4.0 }));
+}
+
+TEST_CASE("swept sphere bounds") {
+	using namespace ez;
+
+	std::mt19937 gen{ 470 };
+	std::uniform_real_distribution<double> pos{ -3.0, 3.0 };
+	std::uniform_real_distribution<double> rad{ 0.1, 2.0 };
+
+	bool match = true;
+	for (int n = 0; n < 200; ++n) {
+		form_t from = random_form(gen, n % 2 == 0), to = random_form(gen, n % 2 == 0);
+		Sphere<double> local{ rad(gen), glm::dvec3{ pos(gen), pos(gen), pos(gen) } };
+		MMRect3<double> swept = swept_bounds(local, from, to);
+
+		for (const form_t& form : sample_motion(from, to, 64)) {
+			// The extreme points of the scaled sphere along each world axis.
+			glm::dmat3 m = glm::mat3_cast(form.rotation);
+			glm::dvec3 center = form.toWorld(local.origin);
+			for (int k = 0; k < 3; ++k) {
+				glm::dvec3 row{ m[0][k] * form.size.x, m[1][k] * form.size.y, m[2][k] * form.size.z };
+				double extent = local.radius * glm::length(row);
+				glm::dvec3 offset{ 0.0 };
+				offset[k] = extent;
+				match &= inside(swept, center + offset);
+				match &= inside(swept, center - offset);
+			}
+		}
+	}
+	REQUIRE(match);
+}
+
+TEST_CASE("swept bounds batch") {
+	using namespace ez;
+
+	std::mt19937 gen{ 4747 };
+	std::uniform_real_distribution<double> ext{ -2.0, 2.0 };
+
+	TransformSoA<double> from, to;
+	MMRectSoA3<double> locals;
+	BallSoA<double, 3> spheres;
+	for (int n = 0; n < 100; ++n) {
+		from.push_back(random_form(gen, n % 3 != 0));
+		to.push_back(random_form(gen, n % 3 != 0));
+		glm::dvec3 a{ ext(gen), ext(gen), ext(gen) }, b{ ext(gen), ext(gen), ext(gen) };
+		locals.push_back(MMRect3<double>{ glm::min(a, b), glm::max(a, b) });
+		spheres.push_back(Sphere<double>{ std::abs(ext(gen)), a });
+	}
+
+	MMRect3<double> shared{ glm::dvec3{ -1.0, -0.5, 0.0 }, glm::dvec3{ 1.0, 0.5, 2.0 } };
+	MMRectSoA3<double> out, outShared, outSpheres;
+	swept_bounds_batch(locals, from, to, out);
+	swept_bounds_batch(shared, from, to, outShared);
+	swept_bounds_batch(spheres, from, to, outSpheres);
+	REQUIRE(out.size() == 100);
+	REQUIRE(outShared.size() == 100);
+	REQUIRE(outSpheres.size() == 100);
+
+	bool match = true;
+	for (std::size_t i = 0; i < 100; ++i) {
+		MMRect3<double> ref = swept_bounds(locals.get(i), from.get(i), to.get(i));
+		match &= approxEq(out.get(i).min, ref.min) && approxEq(out.get(i).max, ref.max);
+		ref = swept_bounds(shared, from.get(i), to.get(i));
+		match &= approxEq(outShared.get(i).min, ref.min) && approxEq(outShared.get(i).max, ref.max);
+		ref = swept_bounds(spheres.get(i), from.get(i), to.get(i));
+		match &= approxEq(outSpheres.get(i).min, ref.min) && approxEq(outSpheres.get(i).max, ref.max);
+	}
+	REQUIRE(match);
+}
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <ez/geo/Intersect.hpp>
+#include <ez/geo/BatchIntersect.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("scalar overlap") {
+	using namespace ez;
+
+	AABB3<float> box = AABB3<float>::Between(glm::vec3{ 0 }, glm::vec3{ 1 });
+
+	REQUIRE(intersect(box, AABB3<float>::Between(glm::vec3{ 0.5f }, glm::vec3{ 2 })));
+	REQUIRE_FALSE(intersect(box, AABB3<float>::Between(glm::vec3{ 1.5f }, glm::vec3{ 2 })));
+
+	REQUIRE(intersect(Sphere<float>{ 1.f, glm::vec3{ 0 } }, Sphere<float>{ 1.f, glm::vec3{ 1.5f, 0, 0 } }));
+	REQUIRE_FALSE(intersect(Sphere<float>{ 1.f, glm::vec3{ 0 } }, Sphere<float>{ 1.f, glm::vec3{ 2.5f, 0, 0 } }));
+
+	REQUIRE(intersect(Sphere<float>{ 0.5f, glm::vec3{ 1.25f, 0.5f, 0.5f } }, box));
+	REQUIRE_FALSE(intersect(Sphere<float>{ 0.5f, glm::vec3{ 1.5f, 1.5f, 1.5f } }, box));
+
+	REQUIRE(intersect(Circle<float>{ 0.5f, glm::vec2{ -0.25f, 0.5f } }, AABB2<float>::Between(glm::vec2{ 0 }, glm::vec2{ 1 })));
+	REQUIRE_FALSE(intersect(Circle<float>{ 0.5f, glm::vec2{ -0.5f, -0.5f } }, AABB2<float>::Between(glm::vec2{ 0 }, glm::vec2{ 1 })));
+}
+
+TEST_CASE("batch overlap matches scalar") {
+	using namespace ez;
+
+	std::mt19937 gen{ 42 };
+	std::uniform_real_distribution<float> pos{ -10.f, 10.f };
+	std::uniform_real_distribution<float> ext{ 0.1f, 2.f };
+
+	MMRectSoA3<float> boxes;
+	SphereSoA<float> spheres;
+	for (int i = 0; i < 300; ++i) {
+		glm::vec3 p{ pos(gen), pos(gen), pos(gen) };
+		boxes.push_back(AABB3<float>{ p, p + glm::vec3{ ext(gen), ext(gen), ext(gen) } });
+		spheres.push_back(Sphere<float>{ ext(gen), glm::vec3{ pos(gen), pos(gen), pos(gen) } });
+	}
+
+	std::vector<IndexPair> pairs;
+	intersect_tiled(spheres, boxes, pairs);
+
+	std::size_t expected = 0;
+	for (std::size_t i = 0; i < spheres.size(); ++i) {
+		std::vector<std::uint32_t> hits;
+		intersect_batch(spheres.get(i), boxes, hits);
+
+		std::size_t count = 0;
+		for (std::size_t j = 0; j < boxes.size(); ++j) {
+			if (intersect(spheres.get(i), boxes.get(j))) {
+				REQUIRE(count < hits.size());
+				REQUIRE(hits[count] == j);
+				++count;
+			}
+		}
+		REQUIRE(count == hits.size());
+		expected += count;
+	}
+	REQUIRE(pairs.size() == expected);
+
+	std::vector<IndexPair> self;
+	intersect_tiled(boxes, self);
+
+	std::size_t selfExpected = 0;
+	for (std::size_t i = 0; i < boxes.size(); ++i) {
+		for (std::size_t j = i + 1; j < boxes.size(); ++j) {
+			selfExpected += intersect(boxes.get(i), boxes.get(j));
+		}
+	}
+	REQUIRE(self.size() == selfExpected);
+	for (const IndexPair& pair : self) {
+		REQUIRE(pair.first < pair.second);
+	}
+
+	std::vector<IndexPair> filtered;
+	intersect_pairs(boxes, boxes, self, filtered);
+	REQUIRE(filtered.size() == self.size());
+}
+
+TEST_CASE("tiled overlap across tiles") {
+	using namespace ez;
+
+	auto less = [](const IndexPair& l, const IndexPair& r) {
+		return l.first != r.first ? l.first < r.first : l.second < r.second;
+	};
+	auto same = [](const std::vector<IndexPair>& l, const std::vector<IndexPair>& r) {
+		bool match = l.size() == r.size();
+		for (std::size_t i = 0; match && i < l.size(); ++i) {
+			match &= l[i].first == r[i].first && l[i].second == r[i].second;
+		}
+		return match;
+	};
+
+	std::mt19937 gen{ 11 };
+	std::uniform_real_distribution<float> pos{ -20.f, 20.f };
+	std::uniform_real_distribution<float> ext{ 0.5f, 4.f };
+
+	// More than two tiles on both sides, and sizes that are not multiples of the tile or of the block.
+	std::size_t tile = intern::BatchTile;
+	MMRectSoA3<float> boxes;
+	SphereSoA<float> spheres;
+	for (std::size_t i = 0; i < 2 * tile + 77; ++i) {
+		glm::vec3 p{ pos(gen), pos(gen), pos(gen) };
+		boxes.push_back(AABB3<float>{ p, p + glm::vec3{ ext(gen), ext(gen), ext(gen) } });
+	}
+	for (std::size_t i = 0; i < 2 * tile + 201; ++i) {
+		spheres.push_back(Sphere<float>{ ext(gen), glm::vec3{ pos(gen), pos(gen), pos(gen) } });
+	}
+
+	std::vector<IndexPair> expected;
+	for (std::size_t i = 0; i < spheres.size(); ++i) {
+		for (std::size_t j = 0; j < boxes.size(); ++j) {
+			if (intersect(spheres.get(i), boxes.get(j))) {
+				expected.push_back(IndexPair{ std::uint32_t(i), std::uint32_t(j) });
+			}
+		}
+	}
+	REQUIRE(expected.size() > 4 * tile);
+
+	// The pairs are appended after what the output already holds.
+	std::vector<IndexPair> pairs{ IndexPair{ 7, 7 } };
+	REQUIRE(intersect_tiled(spheres, boxes, pairs) == expected.size());
+	REQUIRE(pairs.front().first == 7);
+	pairs.erase(pairs.begin());
+	std::sort(pairs.begin(), pairs.end(), less);
+	REQUIRE(same(pairs, expected));
+
+	std::vector<IndexPair> selfExpected;
+	for (std::size_t i = 0; i < boxes.size(); ++i) {
+		for (std::size_t j = i + 1; j < boxes.size(); ++j) {
+			if (intersect(boxes.get(i), boxes.get(j))) {
+				selfExpected.push_back(IndexPair{ std::uint32_t(i), std::uint32_t(j) });
+			}
+		}
+	}
+	std::vector<IndexPair> self;
+	REQUIRE(intersect_tiled(boxes, self) == selfExpected.size());
+	std::sort(self.begin(), self.end(), less);
+	REQUIRE(same(self, selfExpected));
+}
+
+TEST_CASE("obb overlap") {
+	using namespace ez;
+
+	Transform3<float> form;
+	form.setSize(glm::vec3{ 1.f });
+	form.rotate(ez::pi<float>() / 4.f, glm::vec3{ 0, 0, 1 });
+
+	// Unit half extent box rotated 45 degrees, reaches sqrt(2) along the x axis.
+	OBB3<float> box{ form };
+	REQUIRE(approxEq(box.bounds().max, glm::vec3{ std::sqrt(2.f), std::sqrt(2.f), 1.f }));
+
+	OBB3<float> other{ glm::vec3{ 2.3f, 0, 0 }, glm::quat{ 1, 0, 0, 0 }, glm::vec3{ 1.f } };
+	REQUIRE(intersect(box, other));
+	other.translate(glm::vec3{ 0.2f, 0, 0 });
+	REQUIRE_FALSE(intersect(box, other));
+
+	// The loose bounds overlap, the boxes themselves do not.
+	other.move(glm::vec3{ 2.2f, 2.2f, 0 });
+	REQUIRE(intersect(box.bounds(), other.bounds()));
+	REQUIRE_FALSE(intersect(box, other));
+
+	REQUIRE(intersect(Ray3<float>{ glm::vec3{ -1, 0, 0 }, glm::vec3{ 5, 0, 0 } }, box));
+	REQUIRE_FALSE(intersect(Ray3<float>{ glm::vec3{ 1, 0, 0 }, glm::vec3{ 5, 0, 0 } }, box));
+
+	float t;
+	REQUIRE(intersect(Ray3<float>{ glm::vec3{ -1, 0, 0 }, glm::vec3{ 5, 0, 0 } }, box, t));
+	REQUIRE(approxEq(t, 5.f - std::sqrt(2.f)));
+}
+
+TEST_CASE("batch obb matches scalar") {
+	using namespace ez;
+
+	std::mt19937 gen{ 3 };
+	std::uniform_real_distribution<float> pos{ -8.f, 8.f };
+	std::uniform_real_distribution<float> ext{ 0.2f, 2.f };
+	std::uniform_real_distribution<float> angle{ 0.f, ez::tau<float>() };
+
+	OBBSoA3<float> boxes;
+	for (int i = 0; i < 200; ++i) {
+		glm::vec3 axis = glm::normalize(glm::vec3{ pos(gen), pos(gen), pos(gen) } + 0.01f);
+		boxes.push_back(OBB3<float>{ glm::vec3{ pos(gen), pos(gen), pos(gen) }, glm::angleAxis(angle(gen), axis), glm::vec3{ ext(gen), ext(gen), ext(gen) } });
+	}
+
+	MMRectSoA3<float> loose;
+	boxes.bounds(loose);
+
+	Ray3<float> ray{ glm::normalize(glm::vec3{ 1, 0.3f, -0.2f }), glm::vec3{ -10, 0, 0 } };
+	std::vector<std::uint32_t> rayHits;
+	intersect_batch(ray, boxes, rayHits);
+
+	std::size_t rayCount = 0;
+	std::size_t pairCount = 0;
+	for (std::size_t i = 0; i < boxes.size(); ++i) {
+		REQUIRE(loose.get(i) == boxes.get(i).bounds());
+		if (intersect(ray, boxes.get(i))) {
+			REQUIRE(rayHits[rayCount] == i);
+			++rayCount;
+		}
+		for (std::size_t j = i + 1; j < boxes.size(); ++j) {
+			pairCount += intersect(boxes.get(i), boxes.get(j));
+		}
+	}
+	REQUIRE(rayHits.size() == rayCount);
+
+	std::vector<IndexPair> pairs;
+	intersect_tiled(boxes, pairs);
+	REQUIRE(pairs.size() == pairCount);
+}
@@ -0,0 +1,117 @@
+#include <random>
+#include <vector>
+
+#include <ez/geo/Packer.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	// Checks that the placed rects lie inside the bin, have the requested size and do not overlap.
+	bool validPacking(const glm::ivec2& bin, const std::vector<glm::ivec2>& sizes, const std::vector<ez::Rect2<int>>& rects, const std::vector<bool>& placed, bool rotation) {
+		bool ok = true;
+		for (std::size_t i = 0; i < rects.size(); ++i) {
+			if (!placed[i]) {
+				continue;
+			}
+			const ez::Rect2<int>& r = rects[i];
+			ok &= r.origin.x >= 0 && r.origin.y >= 0 && r.origin.x + r.size.x <= bin.x && r.origin.y + r.size.y <= bin.y;
+			bool same = r.size == sizes[i];
+			bool turned = rotation && r.size == glm::ivec2{ sizes[i].y, sizes[i].x };
+			ok &= same || turned;
+
+			for (std::size_t j = i + 1; j < rects.size(); ++j) {
+				if (!placed[j]) {
+					continue;
+				}
+				const ez::Rect2<int>& o = rects[j];
+				bool overlap =
+					r.origin.x < o.origin.x + o.size.x && o.origin.x < r.origin.x + r.size.x &&
+					r.origin.y < o.origin.y + o.size.y && o.origin.y < r.origin.y + r.size.y;
+				ok &= !overlap;
+			}
+		}
+		return ok;
+	}
+}
+
+TEST_CASE("maxrects packing") {
+	using namespace ez;
+
+	std::mt19937 gen{ 21 };
+	std::uniform_int_distribution<int> dist{ 4, 40 };
+	std::vector<glm::ivec2> sizes(600);
+	for (glm::ivec2& s : sizes) {
+		s = glm::ivec2{ dist(gen), dist(gen) };
+	}
+
+	glm::ivec2 bin{ 512, 512 };
+	for (MaxRectsHeuristic h : { MaxRectsHeuristic::BestShortSideFit, MaxRectsHeuristic::BestLongSideFit, MaxRectsHeuristic::BestAreaFit, MaxRectsHeuristic::BottomLeft }) {
+		for (bool rotation : { false, true }) {
+			MaxRectsPacker<int> packer{ bin, rotation, h };
+			std::vector<Rect2<int>> rects(sizes.size());
+			bool placed[600];
+			std::size_t count = packer.insert(sizes.data(), sizes.size(), rects.data(), placed);
+
+			std::vector<bool> flags(placed, placed + sizes.size());
+			REQUIRE(validPacking(bin, sizes, rects, flags, rotation));
+			REQUIRE(std::size_t(std::count(flags.begin(), flags.end(), true)) == count);
+			REQUIRE(packer.occupancy() > 0.8);
+		}
+	}
+
+	// Exact fit, four quarters fill the bin and nothing else fits.
+	MaxRectsPacker<int> packer{ glm::ivec2{ 64, 64 } };
+	Rect2<int> out;
+	for (int i = 0; i < 4; ++i) {
+		REQUIRE(packer.insert(glm::ivec2{ 32, 32 }, out));
+	}
+	REQUIRE(packer.occupancy() == 1.0);
+	REQUIRE(packer.getFreeRects().empty());
+	REQUIRE_FALSE(packer.insert(glm::ivec2{ 1, 1 }, out));
+
+	packer.reset();
+	REQUIRE(packer.insert(glm::ivec2{ 64, 64 }, out));
+}
+
+TEST_CASE("skyline packing") {
+	using namespace ez;
+
+	std::mt19937 gen{ 22 };
+	std::uniform_int_distribution<int> dist{ 4, 40 };
+	std::vector<glm::ivec2> sizes(600);
+	for (glm::ivec2& s : sizes) {
+		s = glm::ivec2{ dist(gen), dist(gen) };
+	}
+
+	glm::ivec2 bin{ 512, 512 };
+	for (SkylineHeuristic h : { SkylineHeuristic::BottomLeft, SkylineHeuristic::MinWaste }) {
+		for (bool rotation : { false, true }) {
+			SkylinePacker<int> packer{ bin, rotation, h };
+			std::vector<Rect2<int>> rects(sizes.size());
+			bool placed[600];
+			packer.insert(sizes.data(), sizes.size(), rects.data(), placed);
+
+			std::vector<bool> flags(placed, placed + sizes.size());
+			REQUIRE(validPacking(bin, sizes, rects, flags, rotation));
+			REQUIRE(packer.occupancy() > 0.7);
+		}
+	}
+
+	// Incremental insertion until the bin is full, as a glyph cache would.
+	SkylinePacker<int> packer{ glm::ivec2{ 128, 128 } };
+	std::vector<glm::ivec2> added;
+	std::vector<Rect2<int>> rects;
+	Rect2<int> out;
+	for (int i = 0; i < 1000; ++i) {
+		glm::ivec2 s{ dist(gen) / 2, dist(gen) / 2 };
+		if (!packer.insert(s, out)) {
+			break;
+		}
+		added.push_back(s);
+		rects.push_back(out);
+	}
+	REQUIRE(added.size() < 1000);
+	REQUIRE(validPacking(packer.getSize(), added, rects, std::vector<bool>(added.size(), true), false));
+}
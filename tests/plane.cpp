@@ -0,0 +1,109 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <ez/geo/BatchPlane.hpp>
+#include <ez/geo/ThreadPool.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("batch plane classification") {
+	using namespace ez;
+
+	std::mt19937 gen{ 49 };
+	std::uniform_real_distribution<float> dist{ -10.f, 10.f };
+
+	std::vector<Plane3<float>> planes;
+	// Facing away from a point near the center, so the region behind them is not empty. The normals are not unit length.
+	for (int i = 0; i < 7; ++i) {
+		glm::vec3 normal = glm::vec3{ dist(gen), dist(gen), dist(gen) } * 0.1f;
+		planes.push_back(Plane3<float>{ normal, glm::vec3{ 1.f } + glm::normalize(normal) * 6.f });
+	}
+	PlaneSet3<float> set{ planes.data(), planes.size(), 0.05f };
+	REQUIRE(set.size() == planes.size());
+	REQUIRE(set.all() == 0x7Fu);
+
+	PointSoA3<float> points;
+	for (int i = 0; i < 200000; ++i) {
+		points.push_back(glm::vec3{ dist(gen), dist(gen), dist(gen) });
+	}
+	// Exactly on the first plane.
+	points.push_back(planes[0].origin);
+
+	std::size_t count = points.size();
+	std::vector<std::uint32_t> front(count), back(count), on(count);
+	std::vector<float> distances(count * planes.size());
+	ThreadPool pool{ 3 };
+	classify_batch(points, set, front.data(), back.data(), on.data(), pool);
+	distances_batch(points, set, distances.data(), pool);
+
+	bool match = true;
+	for (std::size_t j = 0; j < count; ++j) {
+		glm::vec3 p = points.get(j);
+		std::uint32_t f = 0, b = 0, o = 0;
+		for (std::size_t i = 0; i < planes.size(); ++i) {
+			float d = planes[i].distanceFrom(p);
+			match &= approxEq(distances[i * count + j], d);
+			// Skip the points too close to the epsilon to compare with a different rounding.
+			if (std::abs(std::abs(d) - set.epsilon) < 1e-4f) {
+				f |= front[j] & (1u << i);
+				b |= back[j] & (1u << i);
+				o |= on[j] & (1u << i);
+				continue;
+			}
+			f |= d > set.epsilon ? 1u << i : 0u;
+			b |= d < -set.epsilon ? 1u << i : 0u;
+			o |= std::abs(d) <= set.epsilon ? 1u << i : 0u;
+		}
+		match &= front[j] == f && back[j] == b && on[j] == o;
+		match &= (front[j] | back[j] | on[j]) == set.all();
+	}
+	REQUIRE(match);
+	REQUIRE((on.back() & 1u) == 1u);
+
+	// Only the masks asked for are written, serially.
+	std::vector<std::uint32_t> only(count);
+	classify_batch(points, set, nullptr, only.data(), nullptr, SerialExecutor{});
+	REQUIRE(only == back);
+
+	// The points behind every plane.
+	std::vector<std::uint32_t> expected;
+	for (std::size_t j = 0; j < count; ++j) {
+		if ((front[j] & set.all()) == 0) {
+			expected.push_back(static_cast<std::uint32_t>(j));
+		}
+	}
+	REQUIRE(!expected.empty());
+	std::vector<std::uint32_t> inside;
+	REQUIRE(inside_batch(points, set, inside, pool) == expected.size());
+	REQUIRE(inside == expected);
+	REQUIRE(inside_batch(points, set, inside, SerialExecutor{}) == expected.size());
+	REQUIRE(inside == expected);
+
+	// Without planes every point is inside.
+	PlaneSet3<float> none;
+	REQUIRE(inside_batch(points, none, inside) == count);
+}
+
+TEST_CASE("plane set limits") {
+	using namespace ez;
+
+	PlaneSet2<double> set;
+	Plane2<double> plane{ glm::dvec2{ 1.0, 0.0 }, glm::dvec2{ 2.0, 0.0 } };
+	for (std::size_t i = 0; i < PlaneSet2<double>::MaxPlanes; ++i) {
+		REQUIRE(set.push_back(plane));
+	}
+	REQUIRE(!set.push_back(plane));
+	REQUIRE(set.all() == ~std::uint32_t(0));
+	REQUIRE(approxEq(set.distanceFrom(31, glm::dvec2{ 5.0, 1.0 }), 3.0));
+
+	PointSoA2<double> points;
+	points.push_back(glm::dvec2{ 1.0, 0.0 });
+	points.push_back(glm::dvec2{ 3.0, 0.0 });
+	std::vector<std::uint32_t> front(2);
+	classify_batch(points, set, front.data(), nullptr, nullptr, SerialExecutor{});
+	REQUIRE(front[0] == 0u);
+	REQUIRE(front[1] == ~std::uint32_t(0));
+}
@@ -0,0 +1,109 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <ez/geo/Polygon.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	// Reference crossing number test over every edge.
+	template<typename T>
+	bool naiveContains(const std::vector<glm::tvec2<T>>& verts, const glm::tvec2<T>& p) {
+		bool inside = false;
+		for (std::size_t i = 0, j = verts.size() - 1; i < verts.size(); j = i++) {
+			glm::tvec2<T> a = verts[j], b = verts[i];
+			if ((a.y > p.y) != (b.y > p.y)) {
+				if (a.y > b.y) {
+					std::swap(a, b);
+				}
+				if (p.x < a.x + (p.y - a.y) * ((b.x - a.x) / (b.y - a.y))) {
+					inside = !inside;
+				}
+			}
+		}
+		return inside;
+	}
+
+	// Star shaped polygon with a random radius per vertex, strongly concave.
+	std::vector<glm::dvec2> star(std::size_t count, std::mt19937& gen) {
+		std::uniform_real_distribution<double> radius{ 2.0, 10.0 };
+		std::vector<glm::dvec2> ret;
+		for (std::size_t i = 0; i < count; ++i) {
+			double angle = 6.283185307179586 * double(i) / double(count);
+			double r = radius(gen);
+			ret.push_back(glm::dvec2{ std::cos(angle), std::sin(angle) } * r);
+		}
+		return ret;
+	}
+}
+
+TEST_CASE("polygon basics") {
+	using namespace ez;
+
+	std::vector<glm::dvec2> square{ { 0, 0 }, { 2, 0 }, { 2, 2 }, { 0, 2 } };
+	Polygon2<double> poly{ square };
+	REQUIRE(poly.size() == 4);
+	REQUIRE(approxEq(poly.signedArea(), 4.0));
+	REQUIRE(approxEq(poly.bounds().min, glm::dvec2{ 0 }));
+	REQUIRE(approxEq(poly.bounds().max, glm::dvec2{ 2 }));
+	REQUIRE(approxEq(poly.edge(3).end, glm::dvec2{ 0 }));
+
+	REQUIRE(poly.contains(glm::dvec2{ 1, 1 }));
+	REQUIRE_FALSE(poly.contains(glm::dvec2{ 3, 1 }));
+	REQUIRE_FALSE(poly.contains(glm::dvec2{ 1, -0.5 }));
+
+	// A ray through a vertex counts once.
+	std::vector<glm::dvec2> diamond{ { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+	Polygon2<double> dpoly{ diamond };
+	REQUIRE(dpoly.contains(glm::dvec2{ -0.5, 0 }));
+	REQUIRE_FALSE(dpoly.contains(glm::dvec2{ -1.5, 0 }));
+
+	Polygon2<double> none;
+	REQUIRE_FALSE(none.contains(glm::dvec2{ 0 }));
+}
+
+TEST_CASE("polygon slab index") {
+	using namespace ez;
+
+	std::mt19937 gen{ 31 };
+	std::uniform_real_distribution<double> dist{ -11.0, 11.0 };
+
+	bool match = true;
+	for (std::size_t count : { 3, 17, 500, 4000 }) {
+		std::vector<glm::dvec2> verts = star(count, gen);
+		for (std::size_t slabs : { std::size_t(0), std::size_t(1), std::size_t(7) }) {
+			Polygon2<double> poly{ verts, slabs };
+
+			PointSoA<double, 2> points;
+			std::vector<glm::dvec2> flat;
+			for (int i = 0; i < 2000; ++i) {
+				glm::dvec2 p{ dist(gen), dist(gen) };
+				points.push_back(p);
+				flat.push_back(p);
+			}
+
+			std::vector<std::uint8_t> soa(flat.size()), aos(flat.size());
+			poly.contains(points, soa.data());
+			poly.contains(flat.data(), flat.size(), aos.data());
+
+			std::vector<std::uint32_t> inside;
+			contains_batch(poly, points, inside);
+
+			std::size_t next = 0;
+			for (std::size_t i = 0; i < flat.size(); ++i) {
+				bool expected = naiveContains(verts, flat[i]);
+				match &= poly.contains(flat[i]) == expected;
+				match &= (soa[i] != 0) == expected && (aos[i] != 0) == expected;
+				if (expected) {
+					match &= next < inside.size() && inside[next] == i;
+					++next;
+				}
+			}
+			match &= next == inside.size();
+		}
+	}
+	REQUIRE(match);
+}
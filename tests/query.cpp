@@ -0,0 +1,151 @@
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include <ez/geo/BatchQuery.hpp>
+#include <ez/geo/ThreadPool.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("thread pool") {
+	using namespace ez;
+
+	ThreadPool pool{ 4 };
+	REQUIRE(pool.size() == 4);
+
+	// Every task runs exactly once, over many jobs of different sizes.
+	bool match = true;
+	for (std::size_t tasks : { 0, 1, 3, 4, 17, 1000 }) {
+		std::vector<std::atomic<int>> runs(tasks);
+		for (std::atomic<int>& r : runs) {
+			r = 0;
+		}
+		pool(tasks, [&](std::size_t task) {
+			++runs[task];
+		});
+		for (std::atomic<int>& r : runs) {
+			match &= r == 1;
+		}
+	}
+	REQUIRE(match);
+
+	std::vector<int> items(10007, 0);
+	parallel_for(pool, items.size(), 64, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			items[i] += int(i);
+		}
+	});
+	for (std::size_t i = 0; i < items.size(); ++i) {
+		match &= items[i] == int(i);
+	}
+	REQUIRE(match);
+}
+
+TEST_CASE("batch queries") {
+	using namespace ez;
+
+	std::mt19937 gen{ 11 };
+	std::uniform_real_distribution<float> pos{ -20.f, 20.f };
+	std::uniform_real_distribution<float> dir{ -1.f, 1.f };
+	std::uniform_real_distribution<float> ext{ 0.1f, 2.f };
+
+	MMRectSoA3<float> boxes;
+	SphereSoA<float> spheres;
+	for (int i = 0; i < 300; ++i) {
+		glm::vec3 p{ pos(gen), pos(gen), pos(gen) };
+		boxes.push_back(AABB3<float>{ p, p + glm::vec3{ ext(gen), ext(gen), ext(gen) } });
+		spheres.push_back(Sphere<float>{ ext(gen), glm::vec3{ pos(gen), pos(gen), pos(gen) } });
+	}
+
+	std::vector<Ray3<float>> rays;
+	std::vector<AABB3<float>> regions;
+	std::vector<Sphere<float>> balls;
+	for (int i = 0; i < 1500; ++i) {
+		rays.emplace_back(glm::normalize(glm::vec3{ dir(gen), dir(gen), dir(gen) }), glm::vec3{ pos(gen), pos(gen), pos(gen) });
+		glm::vec3 p{ pos(gen), pos(gen), pos(gen) };
+		regions.push_back(AABB3<float>{ p, p + glm::vec3{ ext(gen), ext(gen), ext(gen) } * 3.f });
+		balls.push_back(Sphere<float>{ ext(gen) * 2.f, glm::vec3{ pos(gen), pos(gen), pos(gen) } });
+	}
+
+	ThreadPool pool{ 4 };
+	std::vector<std::uint32_t> order;
+	sort_rays(rays.data(), rays.size(), order);
+
+	SECTION("ray casts") {
+		std::vector<RayHit<float>> boxHits(rays.size()), sortedHits(rays.size()), sphereHits(rays.size());
+		raycast_batch(rays.data(), rays.size(), boxes, boxHits.data(), pool);
+		raycast_batch(rays.data(), rays.size(), boxes, sortedHits.data(), pool, order.data());
+		raycast_batch(rays.data(), rays.size(), spheres, sphereHits.data(), SerialExecutor{});
+
+		bool match = true;
+		for (std::size_t i = 0; i < rays.size(); ++i) {
+			float best = std::numeric_limits<float>::max(), t;
+			std::uint32_t index = RayHit<float>::None;
+			for (std::size_t j = 0; j < boxes.size(); ++j) {
+				if (intersect(rays[i], boxes.get(j)) && intersect(rays[i], boxes.get(j), t) && t < best) {
+					best = t;
+					index = std::uint32_t(j);
+				}
+			}
+			match &= boxHits[i].index == index;
+			match &= sortedHits[i].index == index && sortedHits[i].t == boxHits[i].t;
+			if (index != RayHit<float>::None) {
+				match &= approxEq(boxHits[i].t, best);
+			}
+
+			best = std::numeric_limits<float>::max();
+			index = RayHit<float>::None;
+			for (std::size_t j = 0; j < spheres.size(); ++j) {
+				if (intersect(rays[i], spheres.get(j), t) && t < best) {
+					best = t;
+					index = std::uint32_t(j);
+				}
+			}
+			match &= sphereHits[i].index == index;
+			if (index != RayHit<float>::None) {
+				match &= std::abs(sphereHits[i].t - best) < 1e-3f;
+			}
+		}
+		REQUIRE(match);
+	}
+
+	SECTION("overlap queries") {
+		QueryResults results, serial;
+		query_batch(regions.data(), regions.size(), boxes, results, pool);
+		REQUIRE(results.size() == regions.size());
+
+		bool match = true;
+		std::vector<std::uint32_t> expected;
+		for (std::size_t i = 0; i < regions.size(); ++i) {
+			expected.clear();
+			intersect_batch(regions[i], boxes, expected);
+			match &= results.count(i) == expected.size();
+			match &= std::equal(expected.begin(), expected.end(), results.begin(i));
+		}
+		REQUIRE(match);
+
+		// Reusing the results gives the same layout whatever the executor.
+		query_batch(balls.data(), balls.size(), spheres, results, pool);
+		query_batch(balls.data(), balls.size(), spheres, serial, SerialExecutor{});
+		REQUIRE(results.offsets == serial.offsets);
+		REQUIRE(results.indices == serial.indices);
+
+		for (std::size_t i = 0; i < balls.size(); ++i) {
+			expected.clear();
+			intersect_batch(balls[i], spheres, expected);
+			match &= std::equal(expected.begin(), expected.end(), results.begin(i), results.end(i));
+		}
+		REQUIRE(match);
+	}
+
+	// Every ray appears once in the sorted order.
+	std::vector<std::uint32_t> sorted = order;
+	std::sort(sorted.begin(), sorted.end());
+	bool permutation = sorted.size() == rays.size();
+	for (std::size_t i = 0; permutation && i < sorted.size(); ++i) {
+		permutation &= sorted[i] == i;
+	}
+	REQUIRE(permutation);
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <ez/geo/Intersect.hpp>
+#include <ez/geo/RTree.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+	template<typename T, glm::length_t N>
+	T distance2(const ez::MMRect<T, N>& rect, const glm::vec<N, T>& p) {
+		T sum = T(0);
+		for (int k = 0; k < N; ++k) {
+			T d = std::max(std::max(rect.min[k] - p[k], p[k] - rect.max[k]), T(0));
+			sum += d * d;
+		}
+		return sum;
+	}
+}
+
+TEST_CASE("rtree") {
+	using namespace ez;
+
+	std::mt19937 gen{ 17 };
+	std::uniform_real_distribution<float> pos{ -50.f, 50.f };
+	std::uniform_real_distribution<float> ext{ 0.1f, 3.f };
+
+	SECTION("empty and single") {
+		RTree2<float> tree;
+		std::vector<std::uint32_t> out;
+		REQUIRE(tree.empty());
+		REQUIRE(tree.query(glm::vec2{ 0.f }, out) == 0);
+		REQUIRE(tree.nearest(glm::vec2{ 0.f }, 3, out) == 0);
+
+		std::vector<MMRect2<float>> one{ MMRect2<float>{ glm::vec2{ 0.f }, glm::vec2{ 1.f } } };
+		tree.build(one.data(), one.size());
+		REQUIRE(tree.depth() == 1);
+		REQUIRE(tree.query(glm::vec2{ 0.5f }, out) == 1);
+		REQUIRE(tree.nearest(glm::vec2{ 5.f }, 3, out) == 1);
+		REQUIRE(out.size() == 2);
+	}
+
+	SECTION("queries match brute force") {
+		std::vector<MMRect3<float>> boxes;
+		for (int i = 0; i < 5000; ++i) {
+			glm::vec3 p{ pos(gen), pos(gen), pos(gen) };
+			boxes.push_back(MMRect3<float>{ p, p + glm::vec3{ ext(gen), ext(gen), ext(gen) } });
+		}
+		RTree3<float> tree{ boxes };
+		REQUIRE(tree.size() == boxes.size());
+		REQUIRE(tree.depth() == 4);
+		REQUIRE(tree.bounds().contains(boxes[0]));
+
+		bool match = true;
+		std::vector<std::uint32_t> out, expected;
+		for (int q = 0; q < 200; ++q) {
+			glm::vec3 p{ pos(gen), pos(gen), pos(gen) };
+			MMRect3<float> region{ p, p + glm::vec3{ ext(gen), ext(gen), ext(gen) } * 3.f };
+
+			out.clear();
+			expected.clear();
+			tree.query(region, out);
+			for (std::size_t i = 0; i < boxes.size(); ++i) {
+				if (intersect(region, boxes[i])) {
+					expected.push_back(std::uint32_t(i));
+				}
+			}
+			std::sort(out.begin(), out.end());
+			match &= out == expected;
+
+			out.clear();
+			expected.clear();
+			tree.query(p, out);
+			for (std::size_t i = 0; i < boxes.size(); ++i) {
+				if (boxes[i].contains(p)) {
+					expected.push_back(std::uint32_t(i));
+				}
+			}
+			std::sort(out.begin(), out.end());
+			match &= out == expected;
+
+			// The k nearest come out closest first and no rect left out is closer than the last one.
+			out.clear();
+			std::vector<float> dist;
+			match &= tree.nearest(p, 10, out, &dist) == 10;
+			match &= std::is_sorted(dist.begin(), dist.end());
+			for (std::size_t i = 0; i < out.size(); ++i) {
+				match &= approxEq(dist[i], distance2(boxes[out[i]], p));
+			}
+			std::size_t closer = 0;
+			for (const MMRect3<float>& box : boxes) {
+				closer += distance2(box, p) < dist.back();
+			}
+			match &= closer <= 9;
+		}
+		REQUIRE(match);
+	}
+
+	SECTION("2d double") {
+		std::uniform_real_distribution<double> dpos{ -50.0, 50.0 };
+		std::vector<MMRect2<double>> rects;
+		for (int i = 0; i < 777; ++i) {
+			glm::dvec2 p{ dpos(gen), dpos(gen) };
+			rects.push_back(MMRect2<double>{ p, p + glm::dvec2{ 1.0, 2.0 } });
+		}
+		RTree2<double> tree{ rects };
+		REQUIRE(RTree2<double>::Fanout == 8);
+		REQUIRE(tree.nodeCount() == 98 + 13 + 2 + 1);
+
+		std::vector<std::uint32_t> out;
+		REQUIRE(tree.query(MMRect2<double>{ glm::dvec2{ -100.0 }, glm::dvec2{ 100.0 } }, out) == rects.size());
+		std::sort(out.begin(), out.end());
+		bool match = true;
+		for (std::size_t i = 0; i < out.size(); ++i) {
+			match &= out[i] == i;
+		}
+		REQUIRE(match);
+	}
+}
@@ -0,0 +1,91 @@
+#include <thread>
+
+#include <ez/geo/Intersect.hpp>
+#include <ez/geo/GridTraversal.hpp>
+#include <ez/geo/Stats.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("query stats") {
+	using namespace ez;
+	reset_stats();
+
+	AABB3<float> box = AABB3<float>::Between(glm::vec3{ 0 }, glm::vec3{ 1 });
+	Ray3<float> ray{ glm::vec3{ 1, 0, 0 }, glm::vec3{ -1, 0.5f, 0.5f } };
+
+	QueryStats delta;
+	{
+		StatScope scope;
+		REQUIRE(intersect(ray, box));
+		REQUIRE(intersect(Sphere<float>{ 1.f, glm::vec3{ 0 } }, Sphere<float>{ 1.f, glm::vec3{ 1.5f, 0, 0 } }));
+		REQUIRE(intersect(Sphere<float>{ 1.f, glm::vec3{ 0 } }, Sphere<float>{ 1.f, glm::vec3{ 1.5f, 0, 0 } }));
+		// The end caps of a capsule do not count as sphere tests of their own.
+		float t;
+		REQUIRE(intersect(Ray3<float>{ glm::vec3{ 0, -1, 0 }, glm::vec3{ 0, 5, 0 } }, Capsule<float>{ glm::vec3{ 0 }, glm::vec3{ 0, 2, 0 }, 0.5f }, t));
+		delta = scope.delta();
+	}
+
+	// The sum of the stats of a second thread lands in the totals once it flushes.
+	std::thread worker{ []() {
+		AABB3<float> box = AABB3<float>::Between(glm::vec3{ 0 }, glm::vec3{ 1 });
+		for (int i = 0; i < 10; ++i) {
+			intersect(box, AABB3<float>::Between(glm::vec3{ 0.5f }, glm::vec3{ 2 }));
+		}
+		flush_stats();
+	} };
+	worker.join();
+	flush_stats();
+
+	QueryStats totals = global_stats();
+	if constexpr (StatsEnabled) {
+		REQUIRE(delta[StatEvent::Query] == 1);
+		REQUIRE(delta[StatTest::RayAABB] == 1);
+		REQUIRE(delta[StatTest::SphereSphere] == 2);
+		REQUIRE(delta[StatTest::RayCapsule] == 1);
+		REQUIRE(delta[StatTest::RaySphere] == 0);
+		REQUIRE(delta.totalTests() == 4);
+
+		REQUIRE(totals[StatTest::RectRect] == 10);
+		REQUIRE(totals[StatTest::SphereSphere] == 2);
+		REQUIRE(totals[StatEvent::Query] == 1);
+	}
+	else {
+		REQUIRE(delta.totalTests() == 0);
+		REQUIRE(totals.totalTests() == 0);
+	}
+	REQUIRE(thread_stats().totalTests() == 0);
+
+	std::string json = totals.json();
+	REQUIRE(json.front() == '{');
+	REQUIRE(json.back() == '}');
+	REQUIRE(json.find("\"queries\":") != std::string::npos);
+	REQUIRE(json.find("\"tests\":{\"line_line\":") != std::string::npos);
+
+	reset_stats();
+	REQUIRE(global_stats().totalTests() == 0);
+}
+
+TEST_CASE("grid traversal stats") {
+	using namespace ez;
+	if constexpr (!StatsEnabled) {
+		return;
+	}
+	reset_stats();
+
+	AABB3<float> domain{ glm::vec3{ 0 }, glm::vec3{ 8 } };
+	GridOccupancy occupancy{ glm::ivec3{ 8 }, 4 };
+	occupancy.mark(glm::ivec3{ 6, 1, 1 });
+	Ray3<float> ray{ glm::vec3{ 1, 0, 0 }, glm::vec3{ -1, 1.5f, 1.5f } };
+
+	StatScope scope;
+	traverse_hierarchical(ray, domain, occupancy, [](const glm::ivec3&, float, float) { return true; });
+	QueryStats delta = scope.delta();
+
+	// Two coarse blocks on the path, the first is empty and skipped.
+	REQUIRE(delta[StatEvent::NodeVisit] == 2);
+	REQUIRE(delta[StatEvent::EarlyOut] == 1);
+	REQUIRE(delta[StatEvent::LeafVisit] == 4);
+	reset_stats();
+}
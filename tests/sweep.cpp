@@ -0,0 +1,78 @@
+#include <ez/geo/Sweep.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("swept sphere") {
+	using namespace ez;
+
+	AABB3<float> box{ glm::vec3{ 0 }, glm::vec3{ 1 } };
+	Sphere<float> sphere{ 0.5f, glm::vec3{ -2, 0.5f, 0.5f } };
+
+	float t;
+	glm::vec3 normal;
+
+	// Face region
+	REQUIRE(sweep(sphere, glm::vec3{ 3, 0, 0 }, box, t, normal));
+	REQUIRE(approxEq(t, 0.5f));
+	REQUIRE(approxEq(normal, glm::vec3{ -1, 0, 0 }));
+
+	// Too short
+	REQUIRE_FALSE(sweep(sphere, glm::vec3{ 1, 0, 0 }, box, t, normal));
+
+	// Edge region, passes the edge at x = 0, y = 1 with the center at height 1.25
+	sphere.move(glm::vec3{ -2, 1.25f, 0.5f });
+	REQUIRE(sweep(sphere, glm::vec3{ 4, 0, 0 }, box, t, normal));
+	float expected = (2.f - std::sqrt(0.25f - 0.0625f)) / 4.f;
+	REQUIRE(approxEq(t, expected));
+
+	// Misses the rounded corner, but would hit the expanded box.
+	sphere.move(glm::vec3{ -2, 1.45f, 1.45f });
+	REQUIRE_FALSE(sweep(sphere, glm::vec3{ 4, 0, 0 }, box, t, normal));
+
+	// Plane
+	Plane3<float> ground{ glm::vec3{ 0, 1, 0 }, glm::vec3{ 0 } };
+	sphere.move(glm::vec3{ 0, 2, 0 });
+	REQUIRE(sweep(sphere, glm::vec3{ 0, -4, 0 }, ground, t, normal));
+	REQUIRE(approxEq(t, 1.5f / 4.f));
+	REQUIRE(approxEq(normal, glm::vec3{ 0, 1, 0 }));
+
+	// Triangle face and edge
+	glm::vec3 a{ 0, 0, 0 }, b{ 1, 0, 0 }, c{ 0, 0, 1 };
+	sphere.move(glm::vec3{ 0.25f, 2, 0.25f });
+	REQUIRE(sweep(sphere, glm::vec3{ 0, -4, 0 }, a, b, c, t, normal));
+	REQUIRE(approxEq(t, 1.5f / 4.f));
+
+	sphere.move(glm::vec3{ 0.5f, 2, -0.25f });
+	REQUIRE(sweep(sphere, glm::vec3{ 0, -4, 0 }, a, b, c, t, normal));
+	REQUIRE(approxEq(t, (2.f - std::sqrt(0.25f - 0.0625f)) / 4.f));
+}
+
+TEST_CASE("swept boxes") {
+	using namespace ez;
+
+	AABB3<float> moving{ glm::vec3{ -3, 0, 0 }, glm::vec3{ -2, 1, 1 } };
+	AABB3<float> box{ glm::vec3{ 0 }, glm::vec3{ 1 } };
+
+	float t;
+	glm::vec3 normal;
+	REQUIRE(sweep(moving, glm::vec3{ 4, 0.5f, 0 }, box, t, normal));
+	REQUIRE(approxEq(t, 0.5f));
+	REQUIRE(approxEq(normal, glm::vec3{ -1, 0, 0 }));
+
+	MMRectSoA3<float> set;
+	for (int i = 0; i < 10; ++i) {
+		AABB3<float> shifted = box;
+		set.push_back(shifted.translate(glm::vec3{ float(i) * 2.f, 0, 0 }));
+	}
+
+	Sphere<float> sphere{ 0.5f, glm::vec3{ -2, 0.5f, 0.5f } };
+	std::vector<SweepHit<float>> hits;
+	REQUIRE(sweep_batch(sphere, glm::vec3{ 10, 0, 0 }, set, hits) == 5);
+
+	SweepHit<float> first;
+	REQUIRE(sweep_first(sphere, glm::vec3{ 10, 0, 0 }, set, first));
+	REQUIRE(first.index == 0);
+	REQUIRE(approxEq(first.t, 0.15f));
+}
@@ -2,6 +2,11 @@
 
 #include <ez/math/constants.hpp>
 #include <ez/geo/Transform.hpp>
+#include <ez/geo/BatchTransform.hpp>
+#include <ez/geo/TransformCodec.hpp>
+#include <ez/geo/TransformBounds.hpp>
+
+#include <random>
 
 #include "util.hpp"
 
@@ -148,4 +153,198 @@ TEST_CASE("Local rotations") {
 	REQUIRE(approxEq(mat[0], glm::vec3{ 0, 1, 0 }));
 	REQUIRE(approxEq(mat[1], glm::vec3{ 0, 0, 1 }));
 	REQUIRE(approxEq(mat[2], glm::vec3{ 1, 0, 0 }));
-}
\ No newline at end of file
+}
+TEST_CASE("Transform composition scale") {
+	Transform3 parent, child;
+	parent.scale(glm::vec3{ 2, 3, 4 });
+	child.scale(glm::vec3{ 0.5f, 2, 1 });
+	child.move(glm::vec3{ 1, 1, 1 });
+
+	Transform3 world = parent.toWorld(child);
+	REQUIRE(approxEq(world.size, glm::vec3{ 1, 6, 4 }));
+	REQUIRE(approxEq(world.origin, glm::vec3{ 2, 3, 4 }));
+
+	Transform3 local = parent.toLocal(world);
+	REQUIRE(approxEq(local.size, child.size));
+	REQUIRE(approxEq(local.origin, child.origin));
+}
+
+TEST_CASE("Batch transform interpolation") {
+	std::mt19937 gen{ 11 };
+	std::uniform_real_distribution<float> dist{ -1.f, 1.f };
+	auto random_form = [&]() {
+		glm::vec3 axis = glm::normalize(glm::vec3{ dist(gen), dist(gen), dist(gen) });
+		Transform3 form{ glm::vec3{ dist(gen), dist(gen), dist(gen) } * 10.f, glm::angleAxis(dist(gen) * 3.f, axis), glm::vec3{ 1.5f } + glm::vec3{ dist(gen), dist(gen), dist(gen) } };
+		// Both hemispheres, so the shortest path handling is exercised.
+		if (dist(gen) < 0.f) {
+			form.rotation = -form.rotation;
+		}
+		return form;
+	};
+
+	ez::TransformSoA<float> a, b, out;
+	std::vector<float> weights;
+	for (int i = 0; i < 500; ++i) {
+		a.push_back(random_form());
+		b.push_back(random_form());
+		weights.push_back((dist(gen) + 1.f) * 0.5f);
+	}
+	// Identical rotations take the linear path.
+	b.set(0, a.get(0));
+
+	auto same_rotation = [](const glm::quat& p, const glm::quat& q) {
+		return std::abs(std::abs(glm::dot(p, q)) - 1.f) <= 1e-4f;
+	};
+
+	bool match = true;
+	ez::slerp_batch(a, b, weights.data(), out);
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		Transform3 fa = a.get(i), fb = b.get(i), fo = out.get(i);
+		match = match && approxEq(fo.origin, glm::mix(fa.origin, fb.origin, weights[i]));
+		match = match && approxEq(fo.size, glm::mix(fa.size, fb.size, weights[i]));
+		match = match && same_rotation(fo.rotation, glm::slerp(fa.rotation, fb.rotation, weights[i]));
+	}
+	REQUIRE(match);
+
+	// Normalized lerp follows the same path, the endpoints and midpoint agree with slerp.
+	for (float t : { 0.f, 0.5f, 1.f }) {
+		ez::nlerp_batch(a, b, t, out);
+		for (std::size_t i = 0; i < a.size(); ++i) {
+			match = match && same_rotation(out.get(i).rotation, glm::slerp(a.get(i).rotation, b.get(i).rotation, t));
+		}
+	}
+	REQUIRE(match);
+
+	// Composition against the scalar version, with the output aliasing an input.
+	ez::to_world_batch(a, b, out);
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		Transform3 expected = a.get(i).toWorld(b.get(i));
+		Transform3 got = out.get(i);
+		match = match && approxEq(got.origin / 10.f, expected.origin / 10.f) && approxEq(got.size, expected.size);
+		match = match && same_rotation(got.rotation, expected.rotation);
+	}
+	Transform3 parent = random_form();
+	ez::TransformSoA<float> copy = b;
+	ez::to_world_batch(parent, copy, copy);
+	for (std::size_t i = 0; i < b.size(); ++i) {
+		Transform3 expected = parent.toWorld(b.get(i));
+		Transform3 got = copy.get(i);
+		match = match && approxEq(got.origin / 10.f, expected.origin / 10.f) && approxEq(got.size, expected.size);
+		match = match && same_rotation(got.rotation, expected.rotation);
+	}
+	REQUIRE(match);
+}
+
+TEST_CASE("Quantized transforms") {
+	std::mt19937 gen{ 23 };
+	std::uniform_real_distribution<float> dist{ -1.f, 1.f };
+
+	ez::MMRect<float, 3> domain{ glm::vec3{ -100, 0, -50 }, glm::vec3{ 100, 20, 50 } };
+	ez::TransformCodec<float> codec{ domain, 0.5f, 4.f };
+
+	ez::TransformSoA<float> forms, decoded;
+	for (int i = 0; i < 1000; ++i) {
+		glm::vec3 axis = glm::normalize(glm::vec3{ dist(gen), dist(gen), dist(gen) });
+		glm::vec3 origin = domain.min + (domain.max - domain.min) * (glm::vec3{ dist(gen), dist(gen), dist(gen) } + 1.f) * 0.5f;
+		forms.push_back(Transform3{ origin, glm::angleAxis(dist(gen) * 3.14f, axis), glm::vec3{ 2.25f + dist(gen) * 1.75f } });
+	}
+
+	std::vector<ez::PackedTransform> packed;
+	codec.encode(forms, packed);
+	REQUIRE(packed.size() == forms.size());
+	codec.decode(packed, decoded);
+
+	// Float rounding adds a little on top of the quantization bounds.
+	glm::vec3 originBound = codec.originError() * 1.01f;
+	float scaleBound = codec.scaleError() * 1.01f;
+	float rotationBound = codec.rotationError();
+
+	bool match = true;
+	for (std::size_t i = 0; i < forms.size(); ++i) {
+		Transform3 a = forms.get(i), b = decoded.get(i);
+		glm::vec3 diff = glm::abs(a.origin - b.origin);
+		match = match && diff.x <= originBound.x && diff.y <= originBound.y && diff.z <= originBound.z;
+		match = match && std::abs(a.size.x - b.size.x) <= scaleBound;
+
+		float cosine = std::min(std::abs(glm::dot(a.rotation, b.rotation)), 1.f);
+		match = match && 2.f * std::acos(cosine) <= rotationBound;
+
+		// The scalar path gives the same result.
+		Transform3 c = codec.decode(codec.encode(a));
+		match = match && c.origin == b.origin && c.size == b.size;
+	}
+	REQUIRE(match);
+}
+
+TEST_CASE("Transformed rect bounds") {
+	std::mt19937 gen{ 48 };
+	std::uniform_real_distribution<float> dist{ -1.f, 1.f };
+
+	auto corner_bounds = [](const auto& local, auto&& toWorld) {
+		using rect_t = std::decay_t<decltype(local)>;
+		constexpr int N = rect_t::Components;
+		rect_t ret{ toWorld(local.min), toWorld(local.min) };
+		for (int c = 1; c < (1 << N); ++c) {
+			auto corner = local.min;
+			for (int k = 0; k < N; ++k) {
+				if (c & (1 << k)) {
+					corner[k] = local.max[k];
+				}
+			}
+			ret.merge(toWorld(corner));
+		}
+		return ret;
+	};
+	auto same = [](const auto& a, const auto& b) {
+		return approxEq(a.min / 10.f, b.min / 10.f) && approxEq(a.max / 10.f, b.max / 10.f);
+	};
+
+	bool match = true;
+	ez::MMRectSoA3<float> locals;
+	ez::TransformSoA<float> forms;
+	for (int i = 0; i < 300; ++i) {
+		glm::vec3 axis = glm::normalize(glm::vec3{ dist(gen), dist(gen), dist(gen) });
+		// Negative scales mirror the rect, the bounds have to stay ordered.
+		glm::vec3 scale = glm::vec3{ dist(gen), dist(gen), dist(gen) } * 3.f;
+		Transform3 form{ glm::vec3{ dist(gen), dist(gen), dist(gen) } * 10.f, glm::angleAxis(dist(gen) * 3.f, axis), scale };
+		glm::vec3 a{ dist(gen), dist(gen), dist(gen) }, b{ dist(gen), dist(gen), dist(gen) };
+		ez::MMRect3<float> local{ glm::min(a, b), glm::max(a, b) };
+
+		ez::MMRect3<float> expected = corner_bounds(local, [&](const glm::vec3& p) { return form.toWorld(p); });
+		match = match && same(ez::world_bounds(local, form), expected);
+		match = match && same(ez::world_bounds(local, form.getMatrix()), expected);
+		match = match && same(ez::world_bounds(local, form.getMatrix4x3()), expected);
+		match = match && same(ez::world_bounds(local, glm::mat3_cast(form.rotation)), corner_bounds(local, [&](const glm::vec3& p) { return glm::rotate(form.rotation, p); }));
+
+		Transform2 form2{ glm::vec2{ dist(gen), dist(gen) } * 10.f, glm::polar(dist(gen) * 3.f), glm::vec2{ scale } };
+		ez::MMRect2<float> local2{ glm::vec2{ local.min }, glm::vec2{ local.max } };
+		ez::MMRect2<float> expected2 = corner_bounds(local2, [&](const glm::vec2& p) { return form2.toWorld(p); });
+		match = match && same(ez::world_bounds(local2, form2), expected2);
+		match = match && same(ez::world_bounds(local2, form2.getMatrix()), expected2);
+
+		locals.push_back(local);
+		forms.push_back(form);
+	}
+	REQUIRE(match);
+
+	ez::MMRectSoA3<float> out;
+	ez::world_bounds_batch(locals, forms, out);
+	REQUIRE(out.size() == locals.size());
+	for (std::size_t i = 0; i < locals.size(); ++i) {
+		match = match && same(out.get(i), ez::world_bounds(locals.get(i), forms.get(i)));
+	}
+	REQUIRE(match);
+
+	Transform3 shared = forms.get(7);
+	ez::world_bounds_batch(locals, shared, out);
+	for (std::size_t i = 0; i < locals.size(); ++i) {
+		match = match && same(out.get(i), ez::world_bounds(locals.get(i), shared));
+	}
+	// The output aliasing the input.
+	ez::MMRectSoA3<float> copy = locals;
+	ez::world_bounds_batch(copy, shared.getMatrix(), copy);
+	for (std::size_t i = 0; i < locals.size(); ++i) {
+		match = match && same(copy.get(i), ez::world_bounds(locals.get(i), shared));
+	}
+	REQUIRE(match);
+}
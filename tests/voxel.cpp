@@ -0,0 +1,110 @@
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <ez/geo/Voxel.hpp>
+#include <ez/geo/ThreadPool.hpp>
+
+#include "util.hpp"
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("voxel downsampling") {
+	using namespace ez;
+
+	std::mt19937 gen{ 29 };
+	std::normal_distribution<float> cluster{ 0.f, 8.f };
+	std::uniform_real_distribution<float> noise{ -15.f, 15.f };
+
+	MMRect3<float> domain{ glm::vec3{ -10.f, -10.f, -5.f }, glm::vec3{ 10.f, 10.f, 5.f } };
+	float voxel = 0.5f;
+
+	PointSoA3<float> points;
+	for (int i = 0; i < 200000; ++i) {
+		if (i % 10 == 0) {
+			points.push_back(glm::vec3{ noise(gen), noise(gen), noise(gen) });
+		}
+		else {
+			points.push_back(glm::vec3{ cluster(gen), cluster(gen), cluster(gen) } * 0.4f);
+		}
+	}
+	// On the max corner of the domain, clamped into the last voxel.
+	points.push_back(domain.max);
+
+	// Brute force reference, cells keyed by their coordinates.
+	struct Sum {
+		double x = 0.0, y = 0.0, z = 0.0;
+		std::uint32_t count = 0;
+	};
+	std::map<std::array<std::uint32_t, 3>, Sum> expected;
+	std::size_t outside = 0;
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		glm::vec3 p = points.get(i);
+		if (!glm::all(glm::greaterThanEqual(p, domain.min)) || !glm::all(glm::lessThanEqual(p, domain.max))) {
+			++outside;
+			continue;
+		}
+		std::array<std::uint32_t, 3> cell;
+		for (int k = 0; k < 3; ++k) {
+			float c = std::floor((p[k] - domain.min[k]) / voxel);
+			cell[k] = std::uint32_t(std::min(c, (domain.max[k] - domain.min[k]) / voxel - 1.f));
+		}
+		Sum& sum = expected[cell];
+		sum.x += p.x;
+		sum.y += p.y;
+		sum.z += p.z;
+		++sum.count;
+	}
+
+	PointSoA3<float> centroids;
+	std::vector<std::uint32_t> counts;
+	REQUIRE(voxel_downsample(points, domain, voxel, centroids, &counts) == expected.size());
+
+	// Every centroid lies in its voxel and matches the reference.
+	VoxelDownsampler<float> sampler{ domain, voxel, 7000 };
+	REQUIRE(sampler.resolution() == glm::tvec3<std::uint32_t>{ 40, 40, 20 });
+	bool match = true;
+	std::size_t total = 0;
+	for (std::size_t i = 0; i < centroids.size(); ++i) {
+		glm::vec3 c = centroids.get(i);
+		std::array<std::uint32_t, 3> cell;
+		for (int k = 0; k < 3; ++k) {
+			cell[k] = std::uint32_t(std::min(std::floor((c[k] - domain.min[k]) / voxel), (domain.max[k] - domain.min[k]) / voxel - 1.f));
+		}
+		auto it = expected.find(cell);
+		if (it == expected.end()) {
+			match = false;
+			continue;
+		}
+		const Sum& sum = it->second;
+		match &= counts[i] == sum.count;
+		match &= approxEq(c, glm::vec3{ sum.x / sum.count, sum.y / sum.count, sum.z / sum.count });
+		match &= sampler.voxelBounds(glm::tvec3<std::uint32_t>{ cell[0], cell[1], cell[2] }).expanded(1e-4f).contains(c);
+		total += counts[i];
+	}
+	REQUIRE(match);
+	REQUIRE(total + outside == points.size());
+
+	// Streaming in small chunks on a pool gives the same cells as a single pass.
+	ThreadPool pool{ 4 };
+	sampler.add(points, pool);
+	REQUIRE(sampler.skipped() == outside);
+	REQUIRE(sampler.pointCount() == total);
+
+	PointSoA3<float> streamed;
+	std::vector<std::uint32_t> streamedCounts;
+	std::vector<std::uint64_t> keys;
+	sampler.result(streamed, &streamedCounts, &keys);
+	REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+	match = streamed.size() == centroids.size() && streamedCounts == counts;
+	for (std::size_t i = 0; match && i < streamed.size(); ++i) {
+		match &= approxEq(streamed.get(i), centroids.get(i));
+	}
+	REQUIRE(match);
+
+	sampler.reset();
+	REQUIRE(sampler.cellCount() == 0);
+}